@@ -0,0 +1,36 @@
+/// @brief Helpers for std::future based interfaces.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#ifndef __OPC_UA_COMMON_FUTURE_H__
+#define __OPC_UA_COMMON_FUTURE_H__
+
+#include <exception>
+#include <future>
+
+namespace Common
+{
+
+  /// @brief Call 'func' right away and return a future which is already ready with its result or exception.
+  template <typename Func>
+  auto MakeReadyFuture(Func func) -> std::future<decltype(func())>
+  {
+    std::promise<decltype(func())> result;
+    try
+    {
+      result.set_value(func());
+    }
+    catch (...)
+    {
+      result.set_exception(std::current_exception());
+    }
+    return result.get_future();
+  }
+
+} // namespace Common
+
+#endif // __OPC_UA_COMMON_FUTURE_H__
@@ -26,9 +26,12 @@ namespace OpcUa
       std::vector<uint8_t> SenderCertificate;
       std::vector<uint8_t> ReceiverCertificateThumbPrint;
       uint32_t SecureChannelId;
+      /// @brief Milliseconds to wait for a response, asynchronous requests fail with BadTimeout after it.
+      uint32_t RequestTimeout;
 
       SecureConnectionParams()
         : SecureChannelId(0)
+        , RequestTimeout(10000)
       {
       }
     };
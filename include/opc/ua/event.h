@@ -59,6 +59,11 @@ namespace OpcUa
       Variant GetValue(const QualifiedName& path) const;
       Variant GetValue(const std::string& qualifiedname) const; //helper method for the most common case
 
+      //Return pointer to value stored in the event without copying it
+      //returns nullptr if no match
+      const Variant* FindValue(const std::vector<QualifiedName>& path) const;
+      const Variant* FindValue(AttributeId attribute) const;
+
       //Get the list of available values in this event
       std::vector<std::vector<QualifiedName>> GetValueKeys();
 
@@ -51,9 +51,9 @@ namespace OpcUa
     enum ChunkType
     {
       CHT_INVALID = 0,
-      CHT_SINGLE = 1,
-      CHT_INTERMEDIATE,
-      CHT_FINAL,
+      CHT_SINGLE = 1,   // 'F': the only or the last chunk of a message.
+      CHT_INTERMEDIATE, // 'C': message continues in the next chunk.
+      CHT_FINAL,        // 'A': sender aborted the message, previous chunks are discarded.
     };
 
     struct Header
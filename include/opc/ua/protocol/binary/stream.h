@@ -51,6 +51,36 @@ namespace OpcUa
       template<typename T>
       void Serialize(const T& value);
 
+      /// @brief Append array of numeric values in little-endian byte order with a single copy.
+      template<typename T>
+      void SerializeArray(const T* values, std::size_t count);
+
+      /// @brief Number of bytes serialized since the last flush.
+      std::size_t Size() const
+      {
+        return Buffer.size();
+      }
+
+      /// @brief Set size field of the message header which was serialized at position 'headerPos'
+      /// to the number of bytes serialized since then. It allows to serialize message in one pass
+      /// without calculating RawSize of its parts first.
+      void UpdateMessageSize(std::size_t headerPos);
+
+      /// @brief Bytes serialized since the last flush.
+      const char* Data() const
+      {
+        return Buffer.data();
+      }
+
+      /// @brief Drop bytes serialized after position 'pos'.
+      void Truncate(std::size_t pos)
+      {
+        if (pos < Buffer.size())
+        {
+          Buffer.resize(pos);
+        }
+      }
+
     private:
       std::vector<char> Buffer;
     };
@@ -83,6 +113,10 @@ namespace OpcUa
       template <typename T>
       void Deserialize(T&);
 
+      /// @brief Read array of little-endian numeric values with a single read from the supplier.
+      template <typename T>
+      void DeserializeArray(T* values, std::size_t count);
+
     private:
       DataSupplier& In;
     };
@@ -137,6 +171,30 @@ namespace OpcUa
         Serializer.Flush(Out);
       }
 
+      /// @brief Position of the next serialized byte in the not flushed data.
+      std::size_t Position() const
+      {
+        return Serializer.Size();
+      }
+
+      /// @see DataSerializer::UpdateMessageSize
+      void UpdateMessageSize(std::size_t headerPos)
+      {
+        Serializer.UpdateMessageSize(headerPos);
+      }
+
+      /// @see DataSerializer::Data
+      const char* Data() const
+      {
+        return Serializer.Data();
+      }
+
+      /// @see DataSerializer::Truncate
+      void Truncate(std::size_t pos)
+      {
+        Serializer.Truncate(pos);
+      }
+
     private:
       OutputChannelType& Out;
       std::shared_ptr<OutputChannelType> Holder;
@@ -16,6 +16,8 @@
 #include <opc/ua/protocol/guid.h>
 #include <opc/ua/protocol/reference_ids.h>
 
+#include <atomic>
+#include <functional>
 #include <sstream>
 #include <stdint.h>
 #include <string>
@@ -40,87 +42,24 @@ namespace OpcUa
   };
 
   struct ExpandedNodeId;
-
+  struct NodeId;
+
+  inline NodeId TwoByteNodeId(uint8_t value);
+  inline NodeId FourByteNodeId(uint16_t value, uint8_t namespaceIndex = 0);
+  inline NodeId NumericNodeId(uint32_t value, uint16_t namespaceIndex = 0);
+  NodeId StringNodeId(std::string value, uint16_t namespaceIndex = 0);
+  NodeId BinaryNodeId(std::vector<uint8_t> value, uint16_t namespaceIndex = 0);
+  NodeId GuidNodeId(Guid value, uint16_t namespaceIndex = 0);
+
+  /// @brief Identifier of a node.
+  /// Namespace index and numeric identifier are stored inline. String, binary
+  /// and guid identifiers, the namespace uri and the server index live in a
+  /// shared block which is copied only when a node id is modified.
   struct NodeId
   {
-    NodeIdEncoding Encoding;
-    std::string NamespaceURI;
-    uint32_t ServerIndex;
-
-    struct TwoByteDataType
-    {
-      uint8_t Identifier;
-
-      TwoByteDataType()
-        : Identifier(0)
-      {
-      }
-
-    } TwoByteData;
-
-    struct FourByteDataType
-    {
-      uint8_t NamespaceIndex;
-      uint16_t Identifier;
-
-      FourByteDataType()
-        : NamespaceIndex(0)
-        , Identifier(0)
-      {
-      }
-    }FourByteData;
-
-    struct NumericDataType
-    {
-      uint16_t NamespaceIndex;
-      uint32_t Identifier;
-
-      NumericDataType()
-        : NamespaceIndex(0)
-        , Identifier(0)
-      {
-      }
-    }NumericData;
-
-
-    struct StringDataType
-    {
-      uint16_t NamespaceIndex;
-      std::string Identifier;
-
-      StringDataType()
-        : NamespaceIndex(0)
-      {
-      }
-
-    }StringData;
-
-    struct BinaryDataType
-    {
-      uint16_t NamespaceIndex;
-      std::vector<uint8_t> Identifier;
-
-      BinaryDataType()
-        : NamespaceIndex(0)
-      {
-      }
-
-    }BinaryData;
-
-    struct GuidDataType
-    {
-      uint16_t NamespaceIndex;
-      Guid Identifier;
-
-      GuidDataType()
-        : NamespaceIndex(0)
-      {
-      }
-
-    }GuidData;
-
     NodeId();
     NodeId(const NodeId& node);
+    NodeId(NodeId&& node) noexcept;
     NodeId(const ExpandedNodeId& node);
     NodeId(MessageId messageId);
     NodeId(ReferenceId referenceId);
@@ -128,8 +67,10 @@ namespace OpcUa
     NodeId(ExpandedObjectId objectId);
     NodeId(uint32_t integerId, uint16_t index);
     NodeId(std::string stringId, uint16_t index);
+    ~NodeId();
 
     NodeId& operator= (const NodeId& node);
+    NodeId& operator= (NodeId&& node) noexcept;
     NodeId& operator= (const ExpandedNodeId& node);
 
     explicit operator ExpandedNodeId();
@@ -172,6 +113,8 @@ namespace OpcUa
 
     bool operator< (const NodeId& node) const;
 
+    /// @brief Encoding with namespace uri and server index flags.
+    NodeIdEncoding GetEncoding() const;
     NodeIdEncoding GetEncodingValue() const;
     bool IsNull() const;
     bool HasNullIdentifier() const;
@@ -188,67 +131,92 @@ namespace OpcUa
     bool IsGuid() const;
 
     uint32_t GetNamespaceIndex() const;
+    const std::string& GetNamespaceURI() const;
+    uint32_t GetServerIndex() const;
 
     uint32_t GetIntegerIdentifier() const;
-    std::string GetStringIdentifier() const;
-    std::vector<uint8_t> GetBinaryIdentifier() const;
-    Guid GetGuidIdentifier() const;
+    const std::string& GetStringIdentifier() const;
+    const std::vector<uint8_t>& GetBinaryIdentifier() const;
+    const Guid& GetGuidIdentifier() const;
+
+    /// @brief Hash of namespace index and identifier, consistent with operator==.
+    std::size_t GetHash() const;
 
     protected:
     void CopyNodeId(const NodeId& node);
-  };
 
-  inline NodeId TwoByteNodeId(uint8_t value)
-  {
-    NodeId id;
-    id.Encoding = EV_TWO_BYTE;
-    id.TwoByteData.Identifier = value;
-    return id;
-  }
+    private:
+    struct ExtraData
+    {
+      std::atomic<uint32_t> RefCount;
+      std::string StringIdentifier;
+      std::vector<uint8_t> BinaryIdentifier;
+      Guid GuidIdentifier;
+      std::string NamespaceURI;
+      uint32_t ServerIndex;
+
+      ExtraData()
+        : RefCount(1)
+        , ServerIndex(0)
+      {
+      }
 
-  inline NodeId FourByteNodeId(uint16_t value, uint8_t namespaceIndex = 0)
-  {
-    NodeId id;
-    id.Encoding = EV_FOUR_BYTE;
-    id.FourByteData.Identifier = value;
-    id.FourByteData.NamespaceIndex = namespaceIndex;
-    return id;
-  }
+      ExtraData(const ExtraData& data)
+        : RefCount(1)
+        , StringIdentifier(data.StringIdentifier)
+        , BinaryIdentifier(data.BinaryIdentifier)
+        , GuidIdentifier(data.GuidIdentifier)
+        , NamespaceURI(data.NamespaceURI)
+        , ServerIndex(data.ServerIndex)
+      {
+      }
+    };
 
-  inline NodeId NumericNodeId(uint32_t value, uint16_t namespaceIndex = 0)
-  {
-    NodeId id;
-    id.Encoding = EV_NUMERIC;
-    id.NumericData.Identifier = value;
-    id.NumericData.NamespaceIndex = namespaceIndex;
-    return id;
-  }
+    NodeId(NodeIdEncoding encoding, uint16_t namespaceIndex, uint32_t identifier)
+      : Encoding(encoding)
+      , NamespaceIndex(namespaceIndex)
+      , Identifier(identifier)
+      , Data(nullptr)
+    {
+    }
 
-  inline NodeId StringNodeId(std::string value, uint16_t namespaceIndex = 0)
+    ExtraData& GetMutableData();
+    void ReleaseData();
+    void UpdateIdentifierHash();
+
+    friend NodeId TwoByteNodeId(uint8_t value);
+    friend NodeId FourByteNodeId(uint16_t value, uint8_t namespaceIndex);
+    friend NodeId NumericNodeId(uint32_t value, uint16_t namespaceIndex);
+    friend NodeId StringNodeId(std::string value, uint16_t namespaceIndex);
+    friend NodeId BinaryNodeId(std::vector<uint8_t> value, uint16_t namespaceIndex);
+    friend NodeId GuidNodeId(Guid value, uint16_t namespaceIndex);
+
+    private:
+    // Set only together with the identifier, so operator== and hash see a consistent id.
+    NodeIdEncoding Encoding;
+    uint16_t NamespaceIndex;
+    // Numeric identifier, or hash of a string, binary or guid identifier.
+    uint32_t Identifier;
+    ExtraData* Data;
+  };
+
+  // Encoding, namespace index and numeric identifier are kept inline next to
+  // the pointer to the shared block: 16 bytes on 64 bit platforms, 12 on 32 bit.
+  static_assert(sizeof(NodeId) <= 16, "NodeId must not grow past 16 bytes.");
+
+  inline NodeId TwoByteNodeId(uint8_t value)
   {
-    NodeId id;
-    id.Encoding = EV_STRING;
-    id.StringData.Identifier = value;
-    id.StringData.NamespaceIndex = namespaceIndex;
-    return id;
+    return NodeId(EV_TWO_BYTE, 0, value);
   }
 
-  inline NodeId BinaryNodeId(std::vector<uint8_t> value, uint16_t namespaceIndex = 0)
+  inline NodeId FourByteNodeId(uint16_t value, uint8_t namespaceIndex)
   {
-    NodeId id;
-    id.Encoding = EV_BYTE_STRING;
-    id.BinaryData.Identifier = value;
-    id.BinaryData.NamespaceIndex = namespaceIndex;
-    return id;
+    return NodeId(EV_FOUR_BYTE, namespaceIndex, value);
   }
 
-  inline NodeId GuidNodeId(Guid value, uint16_t namespaceIndex = 0)
+  inline NodeId NumericNodeId(uint32_t value, uint16_t namespaceIndex)
   {
-    NodeId id;
-    id.Encoding = EV_GUId;
-    id.GuidData.Identifier = value;
-    id.GuidData.NamespaceIndex = namespaceIndex;
-    return id;
+    return NodeId(EV_NUMERIC, namespaceIndex, value);
   }
 
   struct ExpandedNodeId : public NodeId
@@ -269,4 +237,25 @@ namespace OpcUa
 
 } // namespace OpcUa
 
+namespace std
+{
+
+  template<>
+  struct hash<OpcUa::NodeId>
+  {
+    std::size_t operator()(const OpcUa::NodeId& id) const
+    {
+      return id.GetHash();
+    }
+  };
+
+  template<>
+  struct hash<OpcUa::ExpandedNodeId>
+  {
+    std::size_t operator()(const OpcUa::ExpandedNodeId& id) const
+    {
+      return id.GetHash();
+    }
+  };
 
+} // namespace std
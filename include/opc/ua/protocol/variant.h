@@ -15,10 +15,12 @@
 #include <opc/ua/protocol/types.h>
 #include <opc/ua/protocol/status_codes.h>
 
-#include <boost/any.hpp>
+#include <new>
 #include <string>
-
 #include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 
 
 namespace OpcUa
@@ -155,61 +157,154 @@ namespace OpcUa
   };
 
 
-  class Variant
+  struct ExtensionObject;
+
+  namespace Detail
   {
-    boost::any Value;
+    /// @brief Tag of a value stored in a Variant. Equal to the binary encoding mask of the value.
+    template <typename T>
+    struct VariantTag;
+
+    template <VariantType type>
+    struct VariantTagOf : std::integral_constant<uint8_t, static_cast<uint8_t>(type)> {};
+
+    template <> struct VariantTag<bool>           : VariantTagOf<VariantType::BOOLEAN> {};
+    template <> struct VariantTag<int8_t>         : VariantTagOf<VariantType::SBYTE> {};
+    template <> struct VariantTag<uint8_t>        : VariantTagOf<VariantType::BYTE> {};
+    template <> struct VariantTag<int16_t>        : VariantTagOf<VariantType::INT16> {};
+    template <> struct VariantTag<uint16_t>       : VariantTagOf<VariantType::UINT16> {};
+    template <> struct VariantTag<int32_t>        : VariantTagOf<VariantType::INT32> {};
+    template <> struct VariantTag<uint32_t>       : VariantTagOf<VariantType::UINT32> {};
+    template <> struct VariantTag<int64_t>        : VariantTagOf<VariantType::INT64> {};
+    template <> struct VariantTag<uint64_t>       : VariantTagOf<VariantType::UINT64> {};
+    template <> struct VariantTag<float>          : VariantTagOf<VariantType::FLOAT> {};
+    template <> struct VariantTag<double>         : VariantTagOf<VariantType::DOUBLE> {};
+    template <> struct VariantTag<std::string>    : VariantTagOf<VariantType::STRING> {};
+    template <> struct VariantTag<DateTime>       : VariantTagOf<VariantType::DATE_TIME> {};
+    template <> struct VariantTag<Guid>           : VariantTagOf<VariantType::GUId> {};
+    template <> struct VariantTag<ByteString>     : VariantTagOf<VariantType::BYTE_STRING> {};
+    template <> struct VariantTag<NodeId>         : VariantTagOf<VariantType::NODE_Id> {};
+    template <> struct VariantTag<StatusCode>     : VariantTagOf<VariantType::STATUS_CODE> {};
+    template <> struct VariantTag<QualifiedName>  : VariantTagOf<VariantType::QUALIFIED_NAME> {};
+    template <> struct VariantTag<LocalizedText>  : VariantTagOf<VariantType::LOCALIZED_TEXT> {};
+    template <> struct VariantTag<ExtensionObject>: VariantTagOf<VariantType::EXTENSION_OBJECT> {};
+    template <> struct VariantTag<DiagnosticInfo> : VariantTagOf<VariantType::DIAGNOSTIC_INFO> {};
+    // Variant of variant is not allowed but variant of an array of variant is OK.
+    template <> struct VariantTag<std::vector<Variant>> : std::integral_constant<uint8_t, static_cast<uint8_t>(VariantType::VARIANT) | HAS_ARRAY_MASK> {};
 
+    template <typename T>
+    struct VariantTag<std::vector<T>> : std::integral_constant<uint8_t, VariantTag<T>::value | HAS_ARRAY_MASK>
+    {
+      static_assert(!(VariantTag<T>::value & HAS_ARRAY_MASK), "Variant cannot hold nested arrays.");
+    };
+
+    /// @brief Values which are stored inside of a Variant without allocation.
+    template <typename T>
+    struct IsVariantInline : std::integral_constant<bool,
+      std::is_arithmetic<T>::value || std::is_same<T, DateTime>::value || std::is_same<T, StatusCode>::value> {};
+
+    template <std::size_t size, bool isSigned> struct VariantInteger;
+    template <> struct VariantInteger<1, true>  { typedef int8_t type; };
+    template <> struct VariantInteger<1, false> { typedef uint8_t type; };
+    template <> struct VariantInteger<2, true>  { typedef int16_t type; };
+    template <> struct VariantInteger<2, false> { typedef uint16_t type; };
+    template <> struct VariantInteger<4, true>  { typedef int32_t type; };
+    template <> struct VariantInteger<4, false> { typedef uint32_t type; };
+    template <> struct VariantInteger<8, true>  { typedef int64_t type; };
+    template <> struct VariantInteger<8, false> { typedef uint64_t type; };
+
+    /// @brief Type under which a value of type T is stored in a Variant.
+    template <typename T, typename Enable = void>
+    struct VariantValue
+    {
+      typedef T type;
+    };
+
+    // char, long long and friends are stored as the fixed width integer of the same size.
+    template <typename T>
+    struct VariantValue<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+    {
+      typedef typename VariantInteger<sizeof(T), std::is_signed<T>::value>::type type;
+    };
+
+    template <> struct VariantValue<char*>            { typedef std::string type; };
+    template <> struct VariantValue<const char*>      { typedef std::string type; };
+    template <> struct VariantValue<MessageId>        { typedef NodeId type; };
+    template <> struct VariantValue<ReferenceId>      { typedef NodeId type; };
+    template <> struct VariantValue<ObjectId>         { typedef NodeId type; };
+    template <> struct VariantValue<ExpandedObjectId> { typedef NodeId type; };
+  }
+
+  /// @brief Tagged union holding a value of one of the OPC UA built-in types.
+  /// Numbers, booleans, status codes and DateTime are stored inline,
+  /// strings, arrays and other structures are allocated on the heap.
+  class Variant
+  {
   public:
     std::vector<uint32_t> Dimensions;
 
-    Variant(){}
-    Variant(const Variant& var)
-      : Value(var.Value)
+    Variant()
+      : Tag(0)
     {
     }
 
-    template <typename T>
-    Variant(const T& value) : Value(value){}
-    Variant(MessageId id) : Variant(NodeId(id)){}
-    Variant(ReferenceId id) : Variant(NodeId(id)){}
-    Variant(ObjectId id) : Variant(NodeId(id)){}
-    Variant(ExpandedObjectId id) : Variant(NodeId(id)){}
-    explicit Variant(VariantType);
+    Variant(const Variant& var)
+      : Dimensions(var.Dimensions)
+      , Tag(0)
+    {
+      CopyValue(var);
+    }
 
-    Variant& operator= (const Variant& variant)
+    Variant(Variant&& var) noexcept
+      : Dimensions(std::move(var.Dimensions))
+      , Tag(var.Tag)
+      , Storage(var.Storage)
     {
-      this->Value = variant.Value;
-      return *this;
+      var.Tag = 0;
     }
 
-    template <typename T>
-    Variant& operator=(const T& value)
+    template <typename T, typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, Variant>::value>::type>
+    Variant(T&& value)
+      : Tag(0)
     {
-      Value = value;
-      return *this;
+      SetValue(std::forward<T>(value));
     }
 
-    Variant& operator=(MessageId value)
+    explicit Variant(VariantType);
+
+    ~Variant()
     {
-      Value = NodeId(value);
-      return *this;
+      Reset();
     }
 
-    Variant& operator=(ReferenceId value)
+    Variant& operator= (const Variant& variant)
     {
-      Value = NodeId(value);
+      if (this != &variant)
+      {
+        Reset();
+        CopyValue(variant);
+        Dimensions = variant.Dimensions;
+      }
       return *this;
     }
 
-    Variant& operator=(ObjectId value)
+    Variant& operator= (Variant&& variant) noexcept
     {
-      Value = NodeId(value);
+      if (this != &variant)
+      {
+        Reset();
+        Tag = variant.Tag;
+        Storage = variant.Storage;
+        variant.Tag = 0;
+        Dimensions = std::move(variant.Dimensions);
+      }
       return *this;
     }
 
-    Variant& operator=(ExpandedObjectId value)
+    template <typename T, typename = typename std::enable_if<!std::is_same<typename std::decay<T>::type, Variant>::value>::type>
+    Variant& operator=(T&& value)
     {
-      Value = NodeId(value);
+      SetValue(std::forward<T>(value));
       return *this;
     }
 
@@ -219,7 +314,8 @@ namespace OpcUa
     template <typename T>
     bool operator==(const T& value) const
     {
-      return boost::any_cast<T>(Value) == value;
+      typedef typename Detail::VariantValue<typename std::decay<T>::type>::type ValueType;
+      return Tag == Detail::VariantTag<ValueType>::value && *Get<ValueType>() == value;
     }
 
     bool operator==(MessageId id) const
@@ -253,10 +349,17 @@ namespace OpcUa
     bool IsScalar() const;
     bool IsNul() const;
 
+    /// @brief Returns a copy of the stored value.
+    /// @throws std::bad_cast if the variant holds a value of other type.
     template <typename T>
     T As() const
     {
-      return boost::any_cast<T>(Value);
+      typedef typename Detail::VariantValue<T>::type ValueType;
+      if (Tag != Detail::VariantTag<ValueType>::value)
+      {
+        throw std::bad_cast();
+      }
+      return static_cast<T>(*Get<ValueType>());
     }
 
     template <typename T>
@@ -268,6 +371,90 @@ namespace OpcUa
     VariantType Type() const;
     void Visit(VariantVisitor& visitor) const;
 	std::string ToString() const;
+
+  private:
+    static bool IsInlineTag(uint8_t tag)
+    {
+      return tag <= static_cast<uint8_t>(VariantType::DOUBLE)
+          || tag == static_cast<uint8_t>(VariantType::DATE_TIME)
+          || tag == static_cast<uint8_t>(VariantType::STATUS_CODE);
+    }
+
+    template <typename T>
+    typename std::enable_if<Detail::IsVariantInline<T>::value, const T*>::type Get() const
+    {
+      return reinterpret_cast<const T*>(&Storage);
+    }
+
+    template <typename T>
+    typename std::enable_if<!Detail::IsVariantInline<T>::value, const T*>::type Get() const
+    {
+      return *reinterpret_cast<T* const*>(&Storage);
+    }
+
+    template <typename ValueType, typename T>
+    typename std::enable_if<Detail::IsVariantInline<ValueType>::value>::type Construct(T&& value)
+    {
+      static_assert(sizeof(ValueType) <= sizeof(Storage), "Value is too big to be stored inline.");
+      Reset();
+      new (&Storage) ValueType(std::forward<T>(value));
+      Tag = Detail::VariantTag<ValueType>::value;
+    }
+
+    template <typename ValueType, typename T>
+    typename std::enable_if<!Detail::IsVariantInline<ValueType>::value>::type Construct(T&& value)
+    {
+      if (Tag == Detail::VariantTag<ValueType>::value)
+      {
+        // Reuse the already allocated value.
+        **reinterpret_cast<ValueType**>(&Storage) = std::forward<T>(value);
+        return;
+      }
+      ValueType* newValue = new ValueType(std::forward<T>(value));
+      Reset();
+      *reinterpret_cast<ValueType**>(&Storage) = newValue;
+      Tag = Detail::VariantTag<ValueType>::value;
+    }
+
+    template <typename T>
+    void SetValue(T&& value)
+    {
+      typedef typename Detail::VariantValue<typename std::decay<T>::type>::type ValueType;
+      Construct<ValueType>(std::forward<T>(value));
+    }
+
+    void Reset()
+    {
+      if (!IsInlineTag(Tag))
+      {
+        DestroyValue();
+      }
+      Tag = 0;
+    }
+
+    void CopyValue(const Variant& var)
+    {
+      if (IsInlineTag(var.Tag))
+      {
+        Storage = var.Storage;
+        Tag = var.Tag;
+      }
+      else
+      {
+        CloneValue(var);
+      }
+    }
+
+    void CloneValue(const Variant& var);
+    void DestroyValue();
+
+    /// @brief Calls operation with the stored value. Defined in binary_variant.cpp.
+    template <typename Operation>
+    void ApplyToValue(Operation& operation) const;
+
+  private:
+    uint8_t Tag;
+    typename std::aligned_storage<sizeof(int64_t), alignof(int64_t)>::type Storage;
   };
 
   ObjectId VariantTypeToDataType(VariantType vt);
@@ -47,7 +47,15 @@ namespace OpcUa
       DEFINE_CLASS_POINTERS(AsioAddon)
 
     public:
+      /// @brief io_service of the acceptor and of timers of the server object.
       virtual boost::asio::io_service& GetIoService() = 0;
+      /// @brief io_service which should run a new client connection and its subscriptions.
+      /// With 'io_service_per_thread' parameter every thread runs its own io_service
+      /// and a connection gets the one running fewest connections,
+      /// otherwise it is the io_service returned by GetIoService.
+      virtual boost::asio::io_service& GetConnectionIoService() = 0;
+      /// @brief Tell that a connection got with GetConnectionIoService is closed.
+      virtual void ReleaseConnectionIoService(boost::asio::io_service& io) = 0;
     };
 
 
@@ -38,6 +38,10 @@ namespace OpcUa
       /// opc.tcp://opcua.server.com:4841
       EndpointDescription Endpoint;
       unsigned ThreadsCount = 1;
+      /// @brief Run an io_service per thread, a client connection and its subscriptions run at the least loaded one.
+      bool IoServicePerThread = false;
+      /// @brief Threads executing requests of clients, zero executes them at io_service threads.
+      unsigned ServiceThreadsCount = 0;
       bool Debug = false;
     };
 
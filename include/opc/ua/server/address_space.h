@@ -24,6 +24,26 @@ namespace OpcUa
 
     typedef void DataChangeCallback(const NodeId& node, AttributeId attribute, DataValue);
 
+    /// @brief Handle to value of a node attribute resolved once.
+    /// Setting value through it bypasses Write service and node lookup.
+    /// GetValue and SetValue of an attribute without data change callbacks
+    /// take no lock; Read service still takes the shared lock of the nodes
+    /// the attribute is stored with, but never waits for a slot writer.
+    /// Writes of an attribute with data change callbacks take that lock too.
+    /// Slot may outlive the address space, then it keeps its value but does
+    /// not notify data change callbacks anymore.
+    class ValueSlot
+    {
+    public:
+      DEFINE_CLASS_POINTERS(ValueSlot)
+
+      virtual ~ValueSlot() {}
+
+      /// @brief Replace value of the attribute and notify data change callbacks.
+      virtual void SetValue(const DataValue& value) = 0;
+      virtual DataValue GetValue() const = 0;
+    };
+
     class AddressSpace
       : public ViewServices
       , public AttributeServices
@@ -37,7 +57,13 @@ namespace OpcUa
       virtual uint32_t AddDataChangeCallback(const NodeId& node, AttributeId attribute, std::function<DataChangeCallback> callback) = 0;
       virtual void DeleteDataChangeCallback(uint32_t clienthandle) = 0;
       virtual StatusCode SetValueCallback(const NodeId& node, AttributeId attribute, std::function<DataValue(void)> callback) = 0;
+      /// @brief Whether value of the attribute is provided by a value callback.
+      /// Such values change without writes, other values notify data change callbacks.
+      virtual bool HasValueCallback(const NodeId& node, AttributeId attribute) const = 0;
       virtual void SetMethod(const NodeId& node, std::function<std::vector<OpcUa::Variant> (NodeId context, std::vector<OpcUa::Variant> arguments)> callback) = 0;
+      /// @brief Get value slot of the attribute for high rate updates.
+      /// @throws std::runtime_error if node or attribute does not exist.
+      virtual ValueSlot::SharedPtr GetValueSlot(const NodeId& node, AttributeId attribute) = 0;
       //FIXME : SHould we also expose SetValue and GetValue on server side? then we need to lock them ...
     };
 
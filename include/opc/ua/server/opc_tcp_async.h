@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include <opc/ua/protocol/message_identifiers.h>
 #include <opc/ua/services/services.h>
 #include <opc/common/interface.h>
 
+#include <functional>
+#include <set>
+
 namespace boost
 {
   namespace asio
@@ -46,6 +50,15 @@ namespace OpcUa
         std::string Host;
         unsigned Port = 4840;
         bool DebugMode = false;
+        /// @brief Threads executing requests of clients.
+        /// Zero executes them right at the io_service threads reading the connections.
+        unsigned ServiceThreads = 0;
+        /// @brief Requests executed at io_service threads even if there are service threads.
+        /// Should contain only requests which do not block, e.g. Read of values without callbacks.
+        std::set<OpcUa::MessageId> InlineRequests = {OpcUa::READ_REQUEST, OpcUa::PUBLISH_REQUEST};
+        /// @brief Requests of a connection executed at once, next messages are not read while the limit is reached.
+        /// Responses are sent in order requests are completed. One processes requests one by one.
+        unsigned MaxPipelinedRequests = 16;
       };
 
     public:
@@ -55,5 +68,13 @@ namespace OpcUa
 
     AsyncOpcTcp::UniquePtr CreateAsyncOpcTcp(const AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& io);
 
+    /// @brief Selects io_service for every accepted connection.
+    typedef std::function<boost::asio::io_service&()> IoServiceSelector;
+    /// @brief Gives back io_service got from IoServiceSelector when its connection is closed.
+    typedef std::function<void(boost::asio::io_service&)> IoServiceRelease;
+
+    /// @brief Server accepting clients at 'io' and running each connection at io_service returned by 'connectionIo'.
+    AsyncOpcTcp::UniquePtr CreateAsyncOpcTcp(const AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& io, IoServiceSelector connectionIo, IoServiceRelease releaseIo);
+
   }
 }
@@ -4,6 +4,7 @@
 #include <opc/common/addons_core/addon_manager.h>
 #include <opc/ua/event.h>
 #include <opc/ua/node.h>
+#include <opc/ua/server/address_space.h>
 #include <opc/ua/server/services_registry.h>
 #include <opc/ua/server/subscription_service.h>
 #include <opc/ua/services/services.h>
@@ -64,6 +65,12 @@ namespace OpcUa
       Node GetNode(const NodeId& nodeid) const;
       Node GetNode(const std::string& nodeid) const;
 
+      /// @brief Get value slot of a variable node for high rate updates
+      // slot.SetValue() is much cheaper than Node::SetValue() since it
+      // does not go through Write service nor looks up the node again.
+      // Slot must not be used after the server is stopped.
+      Server::ValueSlot::SharedPtr GetValueSlot(const NodeId& nodeid) const;
+
       /// @brief helper methods for node you will probably want to access
       Node GetRootNode() const;
       Node GetObjectsNode() const;
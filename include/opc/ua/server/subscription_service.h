@@ -28,11 +28,22 @@ namespace OpcUa
   namespace Server
   {
 
+    /// @brief Number of publish requests queued for a session, protocol
+    /// layers answer further ones with BadTooManyPublishRequests.
+    const std::size_t MaxPublishRequests = 100;
+
     class SubscriptionService : public SubscriptionServices
     {
     public:
       DEFINE_CLASS_POINTERS(SubscriptionService)
 
+      using SubscriptionServices::CreateSubscription;
+
+      /// @brief Create subscription publishing and sampling its items at io_service 'io'.
+      /// Protocol layers pass io_service of the client connection, so a subscription runs
+      /// at the thread of its client. Other subscriptions run at io_service the service was created with.
+      virtual SubscriptionData CreateSubscription(const CreateSubscriptionRequest& request, std::function<void (PublishResult)> callback, boost::asio::io_service& io) = 0;
+
       virtual void TriggerEvent(NodeId node, Event event) = 0;
     };
 
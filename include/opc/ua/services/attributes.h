@@ -12,6 +12,7 @@
 #define OPC_UA_Client_ATTRIBUTES_H
 
 #include <opc/common/class_pointers.h>
+#include <opc/common/future.h>
 #include <opc/common/interface.h>
 #include <opc/ua/protocol/attribute_ids.h>
 #include <opc/ua/protocol/data_value.h>
@@ -30,6 +31,19 @@ namespace OpcUa
     public:
       virtual std::vector<DataValue> Read(const OpcUa::ReadParameters& filter) const = 0;
       virtual std::vector<StatusCode> Write(const std::vector<OpcUa::WriteValue>& filter) = 0;
+
+      /// @brief Asynchronous variants of Read and Write.
+      /// Remote implementations return immediately so that many requests can be in flight at once.
+      /// The default implementation completes the call synchronously.
+      virtual std::future<std::vector<DataValue>> ReadAsync(const OpcUa::ReadParameters& filter) const
+      {
+        return Common::MakeReadyFuture([&]() { return Read(filter); });
+      }
+
+      virtual std::future<std::vector<StatusCode>> WriteAsync(const std::vector<OpcUa::WriteValue>& filter)
+      {
+        return Common::MakeReadyFuture([&]() { return Write(filter); });
+      }
     };
 
 } // namespace OpcUa
@@ -13,6 +13,7 @@
 
 #include <opc/common/interface.h>
 #include <opc/common/class_pointers.h>
+#include <opc/common/future.h>
 #include <opc/ua/protocol/protocol.h>
 
 #include <vector>
@@ -28,6 +29,12 @@ namespace OpcUa
   public:
     virtual std::vector<CallMethodResult> Call(const std::vector<CallMethodRequest>& methodsToCall) = 0;
     virtual void SetMethod(const NodeId& node, std::function<std::vector<OpcUa::Variant> (NodeId context, std::vector<OpcUa::Variant> arguments)> callback) = 0;
+
+    /// @brief Asynchronous variant of Call. The default implementation completes the call synchronously.
+    virtual std::future<std::vector<CallMethodResult>> CallAsync(const std::vector<CallMethodRequest>& methodsToCall)
+    {
+      return Common::MakeReadyFuture([&]() { return Call(methodsToCall); });
+    }
   };
 
 } // namespace OpcUa
@@ -13,6 +13,7 @@
 
 #include <opc/common/interface.h>
 #include <opc/common/class_pointers.h>
+#include <opc/common/future.h>
 #include <opc/ua/protocol/types.h>
 #include <opc/ua/protocol/view.h>
 
@@ -32,6 +33,13 @@ namespace OpcUa
     virtual std::vector<BrowsePathResult> TranslateBrowsePathsToNodeIds(const TranslateBrowsePathsParameters& params) const = 0;
 	virtual std::vector<NodeId> RegisterNodes(const std::vector<NodeId>& params) const = 0;
 	virtual void UnregisterNodes(const std::vector<NodeId>& params) const = 0;
+
+    /// @brief Asynchronous variant of TranslateBrowsePathsToNodeIds.
+    /// The default implementation completes the call synchronously.
+    virtual std::future<std::vector<BrowsePathResult>> TranslateBrowsePathsToNodeIdsAsync(const TranslateBrowsePathsParameters& params) const
+    {
+      return Common::MakeReadyFuture([&]() { return TranslateBrowsePathsToNodeIds(params); });
+    }
   };
 
 } // namespace OpcUa
@@ -13,13 +13,18 @@
 
 #include <opc/ua/protocol/channel.h>
 
+#include <vector>
+
 namespace OpcUa
 {
 
   class SocketChannel : public OpcUa::IOChannel
   {
   public:
-    SocketChannel(int sock);
+    /// @param sock connected socket.
+    /// @param bufferSize size of read-ahead buffer. Receive() calls are served from it
+    ///                   so that small reads of the deserializer do not cost a syscall each.
+    SocketChannel(int sock, std::size_t bufferSize = DefaultBufferSize);
     virtual ~SocketChannel();
 
     virtual std::size_t Receive(char* data, std::size_t size);
@@ -27,8 +32,18 @@ namespace OpcUa
 
     virtual void Stop();
 
+  public:
+    static const std::size_t DefaultBufferSize = 65536;
+
+  private:
+    void ReceiveExactly(char* data, std::size_t size);
+    void FillBuffer();
+
   private:
     int Socket;
+    std::vector<char> Buffer;
+    std::size_t BufferPos;
+    std::size_t BufferEnd;
   };
 
 }
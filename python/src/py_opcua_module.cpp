@@ -325,7 +325,7 @@ BOOST_PYTHON_MODULE(opcua)
   .add_property("is_binary", &NodeId::IsBinary)
   .add_property("is_guid", &NodeId::IsGuid)
   .add_property("is_string", &NodeId::IsString)
-  .def_readonly("namespace_uri", &NodeId::NamespaceURI)
+  .add_property("namespace_uri", make_function(&NodeId::GetNamespaceURI, return_value_policy<copy_const_reference>()))
   .def(str(self))
   .def(repr(self))
   .def(self == self)
@@ -23,9 +23,13 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <future>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <utility>
 #include <iostream>
 
 
@@ -41,23 +45,21 @@ namespace
   {
   public:
      BufferInputChannel(const std::vector<char>& buffer)
-       : Buffer(buffer)
+       : Data(buffer.data())
+       , Size(buffer.size())
        , Pos(0)
      {
-       Reset();
      }
 
      virtual std::size_t Receive(char* data, std::size_t size)
      {
-       if (Pos >= Buffer.size())
+       if (Pos >= Size)
        {
          return 0;
        }
 
-       size = std::min(size, Buffer.size() - Pos);
-       std::vector<char>::const_iterator begin = Buffer.begin() + Pos;
-       std::vector<char>::const_iterator end = begin + size;
-       std::copy(begin, end, data);
+       size = std::min(size, Size - Pos);
+       std::memcpy(data, Data + Pos, size);
        Pos += size;
        return size;
      }
@@ -72,7 +74,8 @@ namespace
      }
 
   private:
-    const std::vector<char>& Buffer;
+    const char* Data;
+    std::size_t Size;
     std::size_t Pos;
   };
 
@@ -81,44 +84,53 @@ namespace
   class RequestCallback
   {
   public:
-    RequestCallback()
-      : lock(m)
-    {
-    }
-
-    void OnData(std::vector<char> data, ResponseHeader h)
+    // Called from the receive thread. The response is deserialized right away
+    // so that the receive buffer can be reused for the next message.
+    void OnData(const std::vector<char>& data, ResponseHeader h)
     {
       //PrintBlob(data);
-      Data = std::move(data);
-	  this->header = std::move(h);
+      if ( data.empty() )
+      {
+        // Request was completed without response, e.g. connection was closed.
+        Error = std::make_exception_ptr(std::runtime_error("Request failed: " + OpcUa::ToString(h.ServiceResult)));
+      }
+      else
+      {
+        try
+        {
+          BufferInputChannel bufferInput(data);
+          IStreamBinary in(bufferInput);
+          in >> Result;
+        }
+        catch (...)
+        {
+          Error = std::current_exception();
+        }
+      }
+	  Result.Header = std::move(h);
+      std::unique_lock<std::mutex> lock(m);
+      Done = true;
       doneEvent.notify_all();
     }
 
     T WaitForData(std::chrono::milliseconds msec)
     {
-	  if (doneEvent.wait_for(lock, msec) == std::cv_status::timeout)
+      std::unique_lock<std::mutex> lock(m);
+	  if (!doneEvent.wait_for(lock, msec, [this]() { return Done; }))
 		  throw std::runtime_error("Response timed out");
 
-      T result;
-	  result.Header = std::move(this->header);
-      if ( Data.empty() )
+      if (Error)
       {
-        std::cout << "Error: received empty packet from server" << std::endl;
+        std::rethrow_exception(Error);
       }
-	  else
-	  {
-		  BufferInputChannel bufferInput(Data);
-		  IStreamBinary in(bufferInput);
-		  in >> result;
-	  }
-      return result;
+      return std::move(Result);
     }
 
   private:
-    std::vector<char> Data;
-	ResponseHeader	  header;
+    T Result;
+    std::exception_ptr Error;
+    bool Done = false;
     std::mutex m;
-    std::unique_lock<std::mutex> lock;
     std::condition_variable doneEvent;
   };
 
@@ -191,9 +203,9 @@ namespace
     , public std::enable_shared_from_this<BinaryClient>
   {
   private:
-    typedef std::function<void(std::vector<char>, ResponseHeader)> ResponseCallback;
+    typedef std::function<void(const std::vector<char>&, ResponseHeader)> ResponseCallback;
     typedef std::map<uint32_t, ResponseCallback> CallbackMap;
-		std::vector<char> messageBuffer;
+    typedef std::multimap<std::chrono::steady_clock::time_point, uint32_t> DeadlineMap;
 
   public:
     BinaryClient(std::shared_ptr<IOChannel> channel, const SecureConnectionParams& params, bool debug)
@@ -210,7 +222,12 @@ namespace
       //Initialize the worker thread for subscriptions
       callback_thread = std::thread([&](){ CallbackService.Run(); });
 
-      HelloServer(params);
+      const Binary::Acknowledge ack = HelloServer(params);
+      SendBufferSize = ack.ReceiveBufferSize;
+      MaxMessageSize = ack.MaxMessageSize;
+      MaxChunkCount = ack.MaxChunkCount;
+
+      TimeoutThread = std::thread([this](){ ExpireRequests(); });
 
       ReceiveThread = std::move(std::thread([this](){
         try
@@ -220,16 +237,24 @@ namespace
         }
         catch (const std::exception& exc)
         {
-          if (Finished) return;
-          if (Debug)  { std::cerr << "binary_client| ReceiveThread : Error receiving data: "; }
-          std::cerr << exc.what() << std::endl;
+          if (!Finished)
+          {
+            if (Debug)  { std::cerr << "binary_client| ReceiveThread : Error receiving data: "; }
+            std::cerr << exc.what() << std::endl;
+          }
         }
+        FailPendingRequests();
       }));
     }
 
     ~BinaryClient()
     {
-      Finished = true;
+      {
+        std::unique_lock<std::mutex> lock(Mutex);
+        Finished = true;
+      }
+      DeadlinesChanged.notify_all();
+      TimeoutThread.join();
 
       if (Debug) std::cout << "binary_client| Stopping callback thread." << std::endl;
       CallbackService.Stop();
@@ -348,6 +373,20 @@ namespace
       return response.Results;
     }
 
+    virtual std::future<std::vector<DataValue>> ReadAsync(const ReadParameters& params) const
+    {
+      ReadRequest request;
+      request.Parameters = params;
+      return SendAsync<ReadResponse>(request, [](ReadResponse& response) { return std::move(response.Results); });
+    }
+
+    virtual std::future<std::vector<OpcUa::StatusCode>> WriteAsync(const std::vector<WriteValue>& values)
+    {
+      WriteRequest request;
+      request.Parameters.NodesToWrite = values;
+      return SendAsync<WriteResponse>(request, [](WriteResponse& response) { return std::move(response.Results); });
+    }
+
     ////////////////////////////////////////////////////////////////
     /// Endpoint Services
     ////////////////////////////////////////////////////////////////
@@ -406,6 +445,13 @@ namespace
       return response.Results;
     }
 
+    virtual std::future<std::vector<CallMethodResult>> CallAsync(const std::vector<CallMethodRequest>& methodsToCall)
+    {
+      CallRequest request;
+      request.Parameters.MethodsToCall = methodsToCall;
+      return SendAsync<CallResponse>(request, [](CallResponse& response) { return std::move(response.Results); });
+    }
+
     ////////////////////////////////////////////////////////////////
     /// Node management Services
     ////////////////////////////////////////////////////////////////
@@ -496,7 +542,7 @@ namespace
       request.Header = CreateRequestHeader();
       request.Header.Timeout = 0; //We do not want the request to timeout!
 
-      ResponseCallback responseCallback = [this](std::vector<char> buffer, ResponseHeader h){
+      ResponseCallback responseCallback = [this](const std::vector<char>& buffer, ResponseHeader h){
         if (Debug) {std::cout << "BinaryClient | Got Publish Response, from server " << std::endl;}
 		PublishResponse response;
 		if (h.ServiceResult != OpcUa::StatusCode::Good)
@@ -582,6 +628,13 @@ namespace
 		return response.Result.Paths;
 	}
 
+	virtual std::future<std::vector<BrowsePathResult>> TranslateBrowsePathsToNodeIdsAsync(const TranslateBrowsePathsParameters& params) const
+	{
+		TranslateBrowsePathsToNodeIdsRequest request;
+		request.Parameters = params;
+		return SendAsync<TranslateBrowsePathsToNodeIdsResponse>(request, [](TranslateBrowsePathsToNodeIdsResponse& response) { return std::move(response.Result.Paths); });
+	}
+
 
 	virtual std::vector<BrowseResult> Browse(const OpcUa::NodesQuery& query) const
 	{
@@ -737,9 +790,11 @@ private:
     {
       request.Header = CreateRequestHeader();
 
-      RequestCallback<Response> requestCallback;
-      ResponseCallback responseCallback = [&requestCallback](std::vector<char> buffer, ResponseHeader h){
-        requestCallback.OnData(std::move(buffer), std::move(h));
+      // The receive thread may still be running the callback when the wait
+      // below times out, so the callback shares ownership of the state.
+      std::shared_ptr<RequestCallback<Response>> requestCallback = std::make_shared<RequestCallback<Response>>();
+      ResponseCallback responseCallback = [requestCallback](const std::vector<char>& buffer, ResponseHeader h){
+        requestCallback->OnData(buffer, std::move(h));
       };
       std::unique_lock<std::mutex> lock(Mutex);
       Callbacks.insert(std::make_pair(request.Header.RequestHandle, responseCallback));
@@ -749,7 +804,7 @@ private:
 
 	  Response res;
 	  try {
-      res = requestCallback.WaitForData(std::chrono::milliseconds(request.Header.Timeout));
+      res = requestCallback->WaitForData(std::chrono::milliseconds(request.Header.Timeout));
 	  }
 	  catch (std::exception &ex)
 	  {
@@ -763,23 +818,186 @@ private:
 	  return res;
     }
 
+    /// @brief Send request without waiting for the response.
+    /// The response is deserialized in the receive thread and 'extract' picks the result from it.
+    /// Any number of such requests may be in flight, they are matched to responses by RequestHandle.
+    template <typename Response, typename Request, typename Extract>
+    auto SendAsync(Request request, Extract extract) const -> std::future<decltype(extract(std::declval<Response&>()))>
+    {
+      typedef decltype(extract(std::declval<Response&>())) Result;
+
+      request.Header = CreateRequestHeader();
+
+      std::shared_ptr<std::promise<Result>> promise = std::make_shared<std::promise<Result>>();
+      std::future<Result> result = promise->get_future();
+      ResponseCallback responseCallback = [promise, extract](const std::vector<char>& buffer, ResponseHeader h){
+        if (buffer.empty())
+        {
+          promise->set_exception(std::make_exception_ptr(std::runtime_error("Request failed: " + OpcUa::ToString(h.ServiceResult))));
+          return;
+        }
+        try
+        {
+          Response response;
+          BufferInputChannel bufferInput(buffer);
+          IStreamBinary in(bufferInput);
+          in >> response;
+          response.Header = std::move(h);
+          promise->set_value(extract(response));
+        }
+        catch (...)
+        {
+          promise->set_exception(std::current_exception());
+        }
+      };
+      std::unique_lock<std::mutex> lock(Mutex);
+      Callbacks.insert(std::make_pair(request.Header.RequestHandle, responseCallback));
+      if (request.Header.Timeout)
+      {
+        // Request is completed with BadTimeout if response does not come in time.
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(request.Header.Timeout);
+        const bool earliest = Deadlines.empty() || deadline < Deadlines.begin()->first;
+        RequestDeadlines[request.Header.RequestHandle] = Deadlines.insert(std::make_pair(deadline, request.Header.RequestHandle));
+        if (earliest)
+        {
+          DeadlinesChanged.notify_one();
+        }
+      }
+      lock.unlock();
+
+      try
+      {
+        Send(request);
+      }
+      catch (...)
+      {
+        std::unique_lock<std::mutex> lock(Mutex);
+        TakeCallback(request.Header.RequestHandle);
+        throw;
+      }
+      return result;
+    }
+
+    // Remove callback of the request and its deadline. Mutex should be locked.
+    ResponseCallback TakeCallback(uint32_t requestHandle) const
+    {
+      std::map<uint32_t, DeadlineMap::iterator>::iterator deadlineIt = RequestDeadlines.find(requestHandle);
+      if (deadlineIt != RequestDeadlines.end())
+      {
+        Deadlines.erase(deadlineIt->second);
+        RequestDeadlines.erase(deadlineIt);
+      }
+
+      ResponseCallback callback;
+      CallbackMap::iterator callbackIt = Callbacks.find(requestHandle);
+      if (callbackIt != Callbacks.end())
+      {
+        callback = std::move(callbackIt->second);
+        Callbacks.erase(callbackIt);
+      }
+      return callback;
+    }
+
+    // Complete asynchronous requests which were not answered in time.
+    void ExpireRequests()
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      while (!Finished)
+      {
+        if (Deadlines.empty())
+        {
+          DeadlinesChanged.wait(lock);
+          continue;
+        }
+        if (Deadlines.begin()->first > std::chrono::steady_clock::now())
+        {
+          DeadlinesChanged.wait_until(lock, Deadlines.begin()->first);
+          continue;
+        }
+
+        const uint32_t requestHandle = Deadlines.begin()->second;
+        ResponseCallback callback = TakeCallback(requestHandle);
+        lock.unlock();
+        if (Debug) std::cout << "binary_client| Request with handle " << requestHandle << " timed out." << std::endl;
+        ResponseHeader header;
+        header.RequestHandle = requestHandle;
+        header.ServiceResult = StatusCode::BadTimeout;
+        callback(std::vector<char>(), std::move(header));
+        lock.lock();
+      }
+    }
+
+    // Complete requests which are still waiting for response when connection is closed.
+    void FailPendingRequests()
+    {
+      CallbackMap pending;
+      {
+        std::unique_lock<std::mutex> lock(Mutex);
+        pending.swap(Callbacks);
+        Deadlines.clear();
+        RequestDeadlines.clear();
+      }
+      for (auto& callback : pending)
+      {
+        ResponseHeader header;
+        header.ServiceResult = StatusCode::BadConnectionClosed;
+        callback.second(std::vector<char>(), std::move(header));
+      }
+    }
+
     // Prevent multiple threads from sending parts of different packets at the same time.
     mutable std::mutex send_mutex;
 
     template <typename Request>
     void Send(Request request) const
     {
-      // TODO add support for breaking message into multiple chunks
       SecureHeader hdr(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelSecurityToken.SecureChannelId);
       const SymmetricAlgorithmHeader algorithmHeader = CreateAlgorithmHeader();
       hdr.AddSize(RawSize(algorithmHeader));
 
       const SequenceHeader sequence = CreateSequenceHeader();
       hdr.AddSize(RawSize(sequence));
+      const std::size_t prefixSize = hdr.Size;
       hdr.AddSize(RawSize(request));
 
 	  std::unique_lock<std::mutex> send_lock(send_mutex);
-      Stream << hdr << algorithmHeader << sequence << request << flush;
+      if (SendBufferSize == 0 || hdr.Size <= SendBufferSize)
+      {
+        Stream << hdr << algorithmHeader << sequence << request << flush;
+        return;
+      }
+
+      // Request does not fit receive buffer of the server, it is sent in chunks
+      // which repeat the message prefix with their own sequence number.
+      if (SendBufferSize <= prefixSize)
+      {
+        throw std::logic_error("Receive buffer of the server is too small for a message chunk.");
+      }
+      const std::size_t bodySize = hdr.Size - prefixSize;
+      const std::size_t maxChunkBodySize = SendBufferSize - prefixSize;
+      const std::size_t chunkCount = (bodySize + maxChunkBodySize - 1) / maxChunkBodySize;
+      if ((MaxMessageSize && bodySize > MaxMessageSize) || (MaxChunkCount && chunkCount > MaxChunkCount))
+      {
+        throw std::runtime_error("Request of " + std::to_string(bodySize) + " bytes exceeds limits of the server: " + OpcUa::ToString(StatusCode::BadRequestTooLarge));
+      }
+
+      const std::size_t bodyPos = Stream.Position();
+      Stream << request;
+      const std::vector<char> body(Stream.Data() + bodyPos, Stream.Data() + Stream.Position());
+      Stream.Truncate(bodyPos);
+
+      SequenceHeader chunkSequence = sequence;
+      for (std::size_t offset = 0; offset < body.size(); offset += maxChunkBodySize)
+      {
+        const std::size_t chunkBodySize = std::min(maxChunkBodySize, body.size() - offset);
+        SecureHeader chunkHeader(MT_SECURE_MESSAGE, offset + chunkBodySize < body.size() ? CHT_INTERMEDIATE : CHT_SINGLE, ChannelSecurityToken.SecureChannelId);
+        chunkHeader.AddSize(RawSize(algorithmHeader) + RawSize(chunkSequence) + chunkBodySize);
+        if (offset != 0)
+        {
+          chunkSequence.SequenceNumber = ++SequenceNumber;
+        }
+        Stream << chunkHeader << algorithmHeader << chunkSequence << RawMessage(&body[offset], chunkBodySize) << flush;
+      }
     }
 
 
@@ -825,64 +1043,62 @@ private:
         throw std::runtime_error(stream.str());
       }
 
-      std::size_t dataSize = responseHeader.Size - expectedHeaderSize;
-      if(responseHeader.Chunk == CHT_SINGLE)
-      {
-        parseMessage(dataSize, id);			  
-        firstMsgParsed = false;
-
-        std::unique_lock<std::mutex> lock(Mutex);
-        CallbackMap::const_iterator callbackIt = Callbacks.find(header.RequestHandle);
-        if (callbackIt == Callbacks.end())
-        {
-          std::cout << "binary_client| No callback found for message with id: " << id << " and handle " << header.RequestHandle << std::endl;
-          return;
-        }
-        callbackIt->second(std::move(messageBuffer), std::move(header));
-        messageBuffer.clear();
-        Callbacks.erase(callbackIt);
-			}
-      else if(responseHeader.Chunk == CHT_INTERMEDIATE)
+      const std::size_t dataSize = responseHeader.Size - expectedHeaderSize;
+      if (responseHeader.Chunk == CHT_FINAL) // abort chunk, drop what was collected so far
       {
-        parseMessage(dataSize, id);
-        firstMsgParsed = true;		  
-      }	  
-    }
-
-    ResponseHeader parseMessage(std::size_t &dataSize, NodeId &id)
-    {
-      std::vector<char> buffer(dataSize);
-      BufferInputChannel bufferInput(buffer);
-      Binary::RawBuffer raw(&buffer[0], dataSize);
+        std::vector<char> reason(dataSize);
+        Binary::RawBuffer raw(reason.data(), dataSize);
+        Stream >> raw;
+        MessageBuffer.clear();
+        return;
+      }
 
+      // Chunk bodies are read from the socket directly into the end of the
+      // message buffer. The buffer keeps its capacity between messages.
+      const std::size_t offset = MessageBuffer.size();
+      MessageBuffer.resize(offset + dataSize);
+      Binary::RawBuffer raw(&MessageBuffer[offset], dataSize);
       Stream >> raw;
 
-      if(!firstMsgParsed)
+      if (responseHeader.Chunk == CHT_INTERMEDIATE)
       {
-        IStreamBinary in(bufferInput);
-        in >> id;
-        in >> header;
+        return;
+      }
 
-        if ( Debug )std::cout << "binary_client| Got response id: " << id << " and handle " << header.RequestHandle<< std::endl;
+      ResponseHeader header;
+      BufferInputChannel bufferInput(MessageBuffer);
+      IStreamBinary in(bufferInput);
+      in >> id;
+      in >> header;
 
-        if (header.ServiceResult != StatusCode::Good) {
-          std::cout << "binary_client| Received a response from server with error status: " << OpcUa::ToString(header.ServiceResult) <<  std::endl;
-        }
+      if ( Debug )std::cout << "binary_client| Got response id: " << id << " and handle " << header.RequestHandle<< std::endl;
 
-        if (id == SERVICE_FAULT)
-        {
-          std::cerr << std::endl;
-          std::cerr << "Receive ServiceFault from Server with StatusCode " << OpcUa::ToString(header.ServiceResult) << std::endl;
-          std::cerr << std::endl;
-        }
+      if (header.ServiceResult != StatusCode::Good) {
+        std::cout << "binary_client| Received a response from server with error status: " << OpcUa::ToString(header.ServiceResult) <<  std::endl;
+      }
 
-        messageBuffer.insert(messageBuffer.end(), buffer.begin(), buffer.end());
-        return header;
+      if (id == SERVICE_FAULT)
+      {
+        std::cerr << std::endl;
+        std::cerr << "Receive ServiceFault from Server with StatusCode " << OpcUa::ToString(header.ServiceResult) << std::endl;
+        std::cerr << std::endl;
       }
-      else
+
+      // Callback deserializes the response, so it is called without holding
+      // the lock to let other threads send requests meanwhile.
+      ResponseCallback callback;
+      {
+        std::unique_lock<std::mutex> lock(Mutex);
+        callback = TakeCallback(header.RequestHandle);
+      }
+      if (!callback)
       {
-        messageBuffer.insert(messageBuffer.end(), buffer.begin(), buffer.end());
+        std::cout << "binary_client| No callback found for message with id: " << id << " and handle " << header.RequestHandle << std::endl;
+        MessageBuffer.clear();
+        return;
       }
+      callback(MessageBuffer, std::move(header));
+      MessageBuffer.clear();
     }
 
     Binary::Acknowledge HelloServer(const SecureConnectionParams& params)
@@ -892,7 +1108,7 @@ private:
       hello.ProtocolVersion = 0;
       hello.ReceiveBufferSize = 65536;
       hello.SendBufferSize = 65536;
-      hello.MaxMessageSize = 65536;
+      hello.MaxMessageSize = 0; // no limit, server splits large responses into chunks
       hello.MaxChunkCount = 256;
       hello.EndpointUrl = params.EndpointUrl;
 
@@ -931,7 +1147,7 @@ private:
       RequestHeader header;
       header.SessionAuthenticationToken = AuthenticationToken;
       header.RequestHandle = GetRequestHandle();
-      header.Timeout = 10000;
+      header.Timeout = Params.RequestTimeout;
       return header;
     }
 
@@ -962,15 +1178,22 @@ private:
     mutable std::atomic<uint32_t> RequestHandle;
     mutable std::vector<std::vector<uint8_t>> ContinuationPoints;
     mutable CallbackMap Callbacks;
+    // Limits of the server receive side negotiated with Hello message, zero means no limit.
+    uint32_t SendBufferSize = 0;
+    uint32_t MaxMessageSize = 0;
+    uint32_t MaxChunkCount = 0;
+    // Deadlines of asynchronous requests, guarded by Mutex.
+    mutable DeadlineMap Deadlines;
+    mutable std::map<uint32_t, DeadlineMap::iterator> RequestDeadlines;
+    mutable std::condition_variable DeadlinesChanged;
+    std::thread TimeoutThread;
     const bool Debug = true;
     bool Finished = false;
 
     std::thread callback_thread;
     CallbackThread CallbackService;
     mutable std::mutex Mutex;
-    
-		bool firstMsgParsed = false;
-		ResponseHeader header;
+    std::vector<char> MessageBuffer;
   };
 
   template <>
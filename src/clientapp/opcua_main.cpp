@@ -177,7 +177,7 @@ namespace
 
   void Print(const OpcUa::NodeId& nodeId, const Tabs& tabs)
   {
-    OpcUa::NodeIdEncoding encoding = static_cast<OpcUa::NodeIdEncoding>(nodeId.Encoding & OpcUa::NodeIdEncoding::EV_VALUE_MASK);
+    OpcUa::NodeIdEncoding encoding = static_cast<OpcUa::NodeIdEncoding>(nodeId.GetEncoding() & OpcUa::NodeIdEncoding::EV_VALUE_MASK);
 
     const Tabs dataTabs(tabs.Num + 2);
     switch (encoding)
@@ -185,40 +185,40 @@ namespace
       case OpcUa::NodeIdEncoding::EV_TWO_BYTE:
       {
         std::cout << tabs << "Two byte:" << std::endl;
-        std::cout << dataTabs << "Identifier:" << (unsigned)nodeId.TwoByteData.Identifier << std::endl;
+        std::cout << dataTabs << "Identifier:" << (unsigned)nodeId.GetIntegerIdentifier() << std::endl;
         break;
       }
 
       case OpcUa::NodeIdEncoding::EV_FOUR_BYTE:
       {
         std::cout << tabs << "Four byte:" << std::endl;
-        std::cout << dataTabs << "NamespaceIndex:" << (unsigned)nodeId.FourByteData.NamespaceIndex << std::endl;
-        std::cout << dataTabs << "Identifier" << (unsigned)nodeId.FourByteData.Identifier << std::endl;
+        std::cout << dataTabs << "NamespaceIndex:" << (unsigned)nodeId.GetNamespaceIndex() << std::endl;
+        std::cout << dataTabs << "Identifier" << (unsigned)nodeId.GetIntegerIdentifier() << std::endl;
         break;
       }
 
       case OpcUa::NodeIdEncoding::EV_NUMERIC:
       {
         std::cout << tabs << "Numeric:" << std::endl;
-        std::cout << dataTabs << "NamespaceIndex" << (unsigned)nodeId.NumericData.NamespaceIndex << std::endl;
-        std::cout << dataTabs << "Identifier" << (unsigned)nodeId.NumericData.Identifier << std::endl;
+        std::cout << dataTabs << "NamespaceIndex" << (unsigned)nodeId.GetNamespaceIndex() << std::endl;
+        std::cout << dataTabs << "Identifier" << (unsigned)nodeId.GetIntegerIdentifier() << std::endl;
         break;
       }
 
       case OpcUa::NodeIdEncoding::EV_STRING:
       {
         std::cout << tabs << "String: " << std::endl;
-        std::cout << dataTabs << "NamespaceIndex: " << (unsigned)nodeId.StringData.NamespaceIndex << std::endl;
-        std::cout << dataTabs << "Identifier: " <<  nodeId.StringData.Identifier << std::endl;
+        std::cout << dataTabs << "NamespaceIndex: " << (unsigned)nodeId.GetNamespaceIndex() << std::endl;
+        std::cout << dataTabs << "Identifier: " <<  nodeId.GetStringIdentifier() << std::endl;
         break;
       }
 
       case OpcUa::NodeIdEncoding::EV_BYTE_STRING:
       {
         std::cout << tabs << "Binary: " << std::endl;
-        std::cout << dataTabs << "NamespaceIndex: " << (unsigned)nodeId.BinaryData.NamespaceIndex << std::endl;
+        std::cout << dataTabs << "NamespaceIndex: " << (unsigned)nodeId.GetNamespaceIndex() << std::endl;
         std::cout << dataTabs << "Identifier: ";
-        for (auto val : nodeId.BinaryData.Identifier) {std::cout << (unsigned)val; }
+        for (auto val : nodeId.GetBinaryIdentifier()) {std::cout << (unsigned)val; }
         std::cout << std::endl;
         break;
       }
@@ -226,8 +226,8 @@ namespace
       case OpcUa::NodeIdEncoding::EV_GUId:
       {
         std::cout << tabs << "Guid: " << std::endl;
-        std::cout << dataTabs << "Namespace Index: " << (unsigned)nodeId.GuidData.NamespaceIndex << std::endl;
-        const OpcUa::Guid& guid = nodeId.GuidData.Identifier;
+        std::cout << dataTabs << "Namespace Index: " << (unsigned)nodeId.GetNamespaceIndex() << std::endl;
+        const OpcUa::Guid& guid = nodeId.GetGuidIdentifier();
         std::cout << dataTabs << "Identifier: " << std::hex << guid.Data1 << "-" << guid.Data2 << "-" << guid.Data3;
         for (auto val : guid.Data4) {std::cout << (unsigned)val; }
         break;
@@ -239,14 +239,14 @@ namespace
       }
     }
 
-    if (nodeId.Encoding & OpcUa::NodeIdEncoding::EV_NAMESPACE_URI_FLAG)
+    if (nodeId.GetEncoding() & OpcUa::NodeIdEncoding::EV_NAMESPACE_URI_FLAG)
     {
-      std::cout << tabs << "Namespace URI: " << nodeId.NamespaceURI << std::endl;
+      std::cout << tabs << "Namespace URI: " << nodeId.GetNamespaceURI() << std::endl;
     }
 
-    if (nodeId.Encoding & OpcUa::NodeIdEncoding::EV_Server_INDEX_FLAG)
+    if (nodeId.GetEncoding() & OpcUa::NodeIdEncoding::EV_Server_INDEX_FLAG)
     {
-      std::cout << tabs << "Server index: " << nodeId.ServerIndex << std::endl;
+      std::cout << tabs << "Server index: " << nodeId.GetServerIndex() << std::endl;
     }
   }
 
@@ -92,6 +92,18 @@ namespace OpcUa
     }
   }
 
+  const Variant* Event::FindValue(const std::vector<QualifiedName>& path) const
+  {
+    PathMap::const_iterator it = PathValues.find(path);
+    return it == PathValues.end() ? nullptr : &it->second;
+  }
+
+  const Variant* Event::FindValue(AttributeId attribute) const
+  {
+    AttributeMap::const_iterator it = AttributeValues.find(attribute);
+    return it == AttributeValues.end() ? nullptr : &it->second;
+  }
+
   std::string ToString(const Event& event)
   {
     std::stringstream stream;
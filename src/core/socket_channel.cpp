@@ -12,6 +12,7 @@
 #include <opc/ua/errors.h>
 
 
+#include <algorithm>
 #include <errno.h>
 #include <iostream>
 
@@ -31,8 +32,13 @@
 #endif
 
 
-OpcUa::SocketChannel::SocketChannel(int sock)
+const std::size_t OpcUa::SocketChannel::DefaultBufferSize;
+
+OpcUa::SocketChannel::SocketChannel(int sock, std::size_t bufferSize)
   : Socket(sock)
+  , Buffer(std::max<std::size_t>(bufferSize, 1))
+  , BufferPos(0)
+  , BufferEnd(0)
 {
   int flag = 1;
   setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char *) &flag, sizeof(int));
@@ -58,7 +64,51 @@ void OpcUa::SocketChannel::Stop()
 
 std::size_t OpcUa::SocketChannel::Receive(char* data, std::size_t size)
 {
-  int received = recv(Socket, data, size, MSG_WAITALL);
+  std::size_t received = 0;
+  while (received < size)
+  {
+    if (BufferPos == BufferEnd)
+    {
+      // Requests which do not fit into the buffer are read directly to avoid an extra copy.
+      if (size - received >= Buffer.size())
+      {
+        ReceiveExactly(data + received, size - received);
+        return size;
+      }
+      FillBuffer();
+    }
+
+    const std::size_t count = std::min(size - received, BufferEnd - BufferPos);
+    memcpy(data + received, &Buffer[BufferPos], count);
+    BufferPos += count;
+    received += count;
+  }
+  return size;
+}
+
+void OpcUa::SocketChannel::ReceiveExactly(char* data, std::size_t size)
+{
+  // MSG_WAITALL still returns less data if connection is closed or a signal interrupts the call.
+  std::size_t received = 0;
+  while (received < size)
+  {
+    int count = recv(Socket, data + received, size - received, MSG_WAITALL);
+    if (count < 0)
+    {
+      THROW_OS_ERROR("Failed to receive data from host.");
+    }
+    if (count == 0)
+    {
+      THROW_OS_ERROR("Connection was closed by host.");
+    }
+    received += count;
+  }
+}
+
+void OpcUa::SocketChannel::FillBuffer()
+{
+  // Take everything the socket has ready (up to buffer size) in one call.
+  int received = recv(Socket, &Buffer[0], Buffer.size(), 0);
   if (received < 0)
   {
     THROW_OS_ERROR("Failed to receive data from host.");
@@ -67,7 +117,8 @@ std::size_t OpcUa::SocketChannel::Receive(char* data, std::size_t size)
   {
     THROW_OS_ERROR("Connection was closed by host.");
   }
-  return (std::size_t)size;
+  BufferPos = 0;
+  BufferEnd = (std::size_t)received;
 }
 
 void OpcUa::SocketChannel::Send(const char* message, std::size_t size)
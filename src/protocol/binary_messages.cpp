@@ -165,15 +165,13 @@ namespace OpcUa
 
   RequestHeader::RequestHeader()
   {
-    SessionAuthenticationToken.Encoding = EV_TWO_BYTE;
-    SessionAuthenticationToken.TwoByteData.Identifier = 0;
+    SessionAuthenticationToken = TwoByteNodeId(0);
     UtcTime = DateTime::Current();
     RequestHandle = 0;
     ReturnDiagnostics = 0;
     AuditEntryId = "";
     Timeout = 0; // in miliseconds
-    Additional.TypeId.Encoding = EV_TWO_BYTE;
-    Additional.TypeId.TwoByteData.Identifier = 0;
+    Additional.TypeId = TwoByteNodeId(0);
   }
 
   OpenSecureChannelParameters::OpenSecureChannelParameters()
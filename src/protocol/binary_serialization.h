@@ -13,6 +13,8 @@
 
 #include <algorithm>
 #include <stdint.h>
+#include <type_traits>
+#include <vector>
 
 
 namespace OpcUa
@@ -31,6 +33,33 @@ namespace OpcUa
     }
   }
 
+  /// @brief Numeric types which are stored in std::vector contiguously and can be
+  /// (de)serialized with a bulk copy instead of element by element.
+  template <typename T>
+  struct is_bulk_serializable : std::integral_constant<bool,
+    std::is_same<T, int8_t>::value   || std::is_same<T, uint8_t>::value  ||
+    std::is_same<T, int16_t>::value  || std::is_same<T, uint16_t>::value ||
+    std::is_same<T, int32_t>::value  || std::is_same<T, uint32_t>::value ||
+    std::is_same<T, int64_t>::value  || std::is_same<T, uint64_t>::value ||
+    std::is_same<T, float>::value    || std::is_same<T, double>::value>
+  {
+  };
+
+  template<class Stream, class T>
+  inline typename std::enable_if<is_bulk_serializable<T>::value>::type
+  SerializeContainer(Stream& out, const std::vector<T>& c, uint32_t emptySizeValue = ~uint32_t())
+  {
+    if (c.empty())
+    {
+      out.Serialize(emptySizeValue);
+    }
+    else
+    {
+      out.Serialize(static_cast<uint32_t>(c.size()));
+      out.SerializeArray(c.data(), c.size());
+    }
+  }
+
   template<class Stream, class Container>
   inline void DeserializeContainer(Stream& in, Container& c)
   {
@@ -50,6 +79,31 @@ namespace OpcUa
       c.push_back(val);
     }
   }
+
+  template<class Stream, class T>
+  inline typename std::enable_if<is_bulk_serializable<T>::value>::type
+  DeserializeContainer(Stream& in, std::vector<T>& c)
+  {
+    uint32_t size = 0;
+    in.Deserialize(size);
+
+    c.clear();
+    if (!size || size == ~uint32_t())
+    {
+      return;
+    }
+
+    // Grow in bounded steps: a broken size field should fail on missing data
+    // rather than on allocating gigabytes up front.
+    const std::size_t step = 65536 / sizeof(T);
+    while (c.size() < size)
+    {
+      const std::size_t pos = c.size();
+      const std::size_t count = std::min<std::size_t>(size - pos, step);
+      c.resize(pos + count);
+      in.DeserializeArray(&c[pos], count);
+    }
+  }
 }
 
 #endif // __OPC_UA_BINARY_SERIALIZATION_TOOLS_H__
@@ -34,14 +34,14 @@ namespace OpcUa
   UserTokenType UserIdentifyToken::type() const
   {
     UserTokenType type = UserTokenType::Anonymous;
-    if(Header.TypeId.FourByteData.Identifier == USER_IdENTIFY_TOKEN_USERNAME)
+    if(Header.TypeId.IsInteger() && Header.TypeId.GetIntegerIdentifier() == USER_IdENTIFY_TOKEN_USERNAME)
       type = UserTokenType::UserName;
     return type;
   }
 
   void UserIdentifyToken::setUser(const std::string &user, const std::string &password)
   {
-    Header.TypeId.FourByteData.Identifier = USER_IdENTIFY_TOKEN_USERNAME;
+    Header.TypeId = FourByteNodeId(USER_IdENTIFY_TOKEN_USERNAME);
     UserName.UserName = user;
     UserName.Password = password;
     //UserName.EncryptionAlgorithm = "http://www.w3.org/2001/04/xmlenc#rsa-oaep";
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <iostream>
 #include <stdexcept>
+#include <string.h>
 
 #ifdef _WIN32
 #include <WinSock2.h>
@@ -60,62 +61,67 @@ namespace
   }
    */
 
-  template <typename Integer16>
-  inline int8_t LoByte(Integer16 value)
+  // OPC UA binary encoding is little-endian. On little-endian hosts numeric values
+  // and arrays are copied as is, on big-endian hosts every element is byte swapped.
+  // The swap loops below have no dependencies between iterations, so the compiler
+  // vectorizes them.
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  template <std::size_t Size>
+  inline void SwapBytes(char*, std::size_t)
   {
-    return value & 0xFF;
   }
 
-  template <typename Integer16>
-  inline int8_t HiByte(Integer16 value)
+  template <>
+  inline void SwapBytes<2>(char* data, std::size_t count)
   {
-    return (value & 0xFF00) >> 8;
-  }
-
-  template <typename Integer32>
-  inline uint16_t LoWord(Integer32 value)
-  {
-    return value & 0xFFFF;
-  }
-
-  template <typename Integer32>
-  inline uint16_t HiWord(Integer32 value)
-  {
-    return (value & 0xFFFF0000) >> 16;
+    for (std::size_t i = 0; i < count; ++i, data += 2)
+    {
+      uint16_t word;
+      memcpy(&word, data, 2);
+      word = static_cast<uint16_t>((word << 8) | (word >> 8));
+      memcpy(data, &word, 2);
+    }
   }
 
-  template <typename Integer64>
-  inline uint32_t LoDWord(Integer64 value)
+  template <>
+  inline void SwapBytes<4>(char* data, std::size_t count)
   {
-    return value & 0xFFFFFFFF;
+    for (std::size_t i = 0; i < count; ++i, data += 4)
+    {
+      uint32_t word;
+      memcpy(&word, data, 4);
+      word = __builtin_bswap32(word);
+      memcpy(data, &word, 4);
+    }
   }
 
-  template <typename Integer64>
-  inline uint32_t HiDWord(Integer64 value)
+  template <>
+  inline void SwapBytes<8>(char* data, std::size_t count)
   {
-    return (value & 0xFFFFFFFF00000000) >> 32;
+    for (std::size_t i = 0; i < count; ++i, data += 8)
+    {
+      uint64_t word;
+      memcpy(&word, data, 8);
+      word = __builtin_bswap64(word);
+      memcpy(data, &word, 8);
+    }
   }
 
-  template <typename Integer16>
-  inline Integer16  MakeWord(int8_t loByte, int8_t hiByte)
-  {
-    const Integer16 word = hiByte;
-    return (word << 8) | (0x00FF & loByte);
-  }
+  #define OPCUA_SWAP_BYTES(Type, data, count) SwapBytes<sizeof(Type)>(data, count)
+#else
+  #define OPCUA_SWAP_BYTES(Type, data, count)
+#endif
 
-  template<typename Integer>
-  inline Integer MakeNumber(char* data)
+  template <typename T>
+  inline void AppendLittleEndian(std::vector<char>& buffer, const T* values, std::size_t count)
   {
-    unsigned size = sizeof(Integer);
-    Integer i = 0;
-    while(size)
-    {
-      i = (i << 8) | (0x00FF & data[--size]);
-    }
-    return i;
+    const std::size_t size = count * sizeof(T);
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + size);
+    memcpy(&buffer[offset], values, size);
+    OPCUA_SWAP_BYTES(T, &buffer[offset], count);
   }
 
-
   const size_t MESSAGE_TYPE_SIZE = 3;
   const char MESSAGE_TYPE_HELLO[MESSAGE_TYPE_SIZE]       = {'H', 'E', 'L'};
   const char MESSAGE_TYPE_ACKNOWLEDGE[MESSAGE_TYPE_SIZE] = {'A', 'C', 'K'};
@@ -141,6 +147,14 @@ namespace
     }
   }
 
+  template <typename ChannelType, typename T>
+  inline void ReadLittleEndian(ChannelType& channel, T* values, std::size_t count)
+  {
+    char* data = reinterpret_cast<char*>(values);
+    GetData(channel, data, count * sizeof(T));
+    OPCUA_SWAP_BYTES(T, data, count);
+  }
+
 
 } // namespace
 
@@ -154,10 +168,9 @@ namespace OpcUa
 
   /// TODO move to apropriate file
   ExtensionObjectHeader::ExtensionObjectHeader(ExtensionObjectId objectId, ExtensionObjectEncoding encoding)
-    : Encoding(encoding)
+    : TypeId(FourByteNodeId(objectId))
+    , Encoding(encoding)
   {
-    TypeId.Encoding = EV_FOUR_BYTE;
-    TypeId.FourByteData.Identifier = objectId;
   }
   ///////////////////////////////////////////////////////
   // IntegerId
@@ -209,6 +222,40 @@ namespace OpcUa
   namespace Binary
   {
 
+    template<typename T>
+    void DataSerializer::SerializeArray(const T* values, std::size_t count)
+    {
+      AppendLittleEndian(Buffer, values, count);
+    }
+
+    template<typename T>
+    void DataDeserializer::DeserializeArray(T* values, std::size_t count)
+    {
+      ReadLittleEndian(In, values, count);
+    }
+
+    template void DataSerializer::SerializeArray<int8_t>(const int8_t*, std::size_t);
+    template void DataSerializer::SerializeArray<uint8_t>(const uint8_t*, std::size_t);
+    template void DataSerializer::SerializeArray<int16_t>(const int16_t*, std::size_t);
+    template void DataSerializer::SerializeArray<uint16_t>(const uint16_t*, std::size_t);
+    template void DataSerializer::SerializeArray<int32_t>(const int32_t*, std::size_t);
+    template void DataSerializer::SerializeArray<uint32_t>(const uint32_t*, std::size_t);
+    template void DataSerializer::SerializeArray<int64_t>(const int64_t*, std::size_t);
+    template void DataSerializer::SerializeArray<uint64_t>(const uint64_t*, std::size_t);
+    template void DataSerializer::SerializeArray<float>(const float*, std::size_t);
+    template void DataSerializer::SerializeArray<double>(const double*, std::size_t);
+
+    template void DataDeserializer::DeserializeArray<int8_t>(int8_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<uint8_t>(uint8_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<int16_t>(int16_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<uint16_t>(uint16_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<int32_t>(int32_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<uint32_t>(uint32_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<int64_t>(int64_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<uint64_t>(uint64_t*, std::size_t);
+    template void DataDeserializer::DeserializeArray<float>(float*, std::size_t);
+    template void DataDeserializer::DeserializeArray<double>(double*, std::size_t);
+
     template<>
     void DataSerializer::Serialize<int8_t>(const int8_t& value)
     {
@@ -253,91 +300,73 @@ namespace OpcUa
     template<>
     void DataSerializer::Serialize<int16_t>(const int16_t& value)
     {
-      Buffer.push_back(LoByte(value));
-      Buffer.push_back(HiByte(value));
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataSerializer::Serialize<uint16_t>(const uint16_t& value)
     {
-      Buffer.push_back(LoByte(value));
-      Buffer.push_back(HiByte(value));
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<uint16_t>(uint16_t& value)
     {
-      char data[2] = {0};
-      GetData(In, data, 2);
-      value = MakeWord<uint16_t>(data[0], data[1]);
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<int16_t>(int16_t& value)
     {
-      char data[2] = {0};
-      GetData(In, data, 2);
-      value = MakeWord<int16_t>(data[0], data[1]);
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
     void DataSerializer::Serialize<int32_t>(const int32_t& value)
     {
-      Serialize(LoWord(value));
-      Serialize(HiWord(value));
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataSerializer::Serialize<uint32_t>(const uint32_t& value)
     {
-      Serialize(LoWord(value));
-      Serialize(HiWord(value));
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<uint32_t>(uint32_t& value)
     {
-      char data[4] = {0};
-      GetData(In, data, 4);
-      value = MakeNumber<uint32_t>(data);
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<int32_t>(int32_t& value)
     {
-      char data[4] = {0};
-      GetData(In, data, 4);
-      value = MakeNumber<int32_t>(data);
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
     void DataSerializer::Serialize<int64_t>(const int64_t& value)
     {
-      Serialize(LoDWord(value));
-      Serialize(HiDWord(value));
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataSerializer::Serialize<uint64_t>(const uint64_t& value)
     {
-      Serialize(LoDWord(value));
-      Serialize(HiDWord(value));
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<uint64_t>(uint64_t& value)
     {
-      char data[8] = {0};
-      GetData(In, data, 8);
-      value = MakeNumber<uint64_t>(data);
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<int64_t>(int64_t& value)
     {
-      char data[8] = {0};
-      GetData(In, data, 8);
-      value = MakeNumber<int64_t>(data);
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
@@ -370,45 +399,25 @@ namespace OpcUa
     template<>
     void DataSerializer::Serialize<float>(const float& value)
     {
-      //float network_value = float_htonl(value);
-      const uint8_t* data = reinterpret_cast<const uint8_t*>(&value);
-      for (int i = 0; i < 4; ++i)
-      {
-        Serialize(data[i]);
-      }
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<float>(float& value)
     {
-      //float network_value = float_htonl(value);
-      uint8_t data[4] = {0};
-      for (int i = 0; i < 4; ++i)
-      {
-        *this >> data[i];
-      }
-      value = *reinterpret_cast<const float*>(data); // FIXME: probably broken on ARM
-     }
+      ReadLittleEndian(In, &value, 1);
+    }
 
     template<>
     void DataSerializer::Serialize<double>(const double& value)
     {
-      const uint8_t* data = reinterpret_cast<const uint8_t*>(&value);
-      for (int i = 0; i < 8; ++i)
-      {
-        Serialize(data[i]);
-      }
+      AppendLittleEndian(Buffer, &value, 1);
     }
 
     template<>
     void DataDeserializer::Deserialize<double>(double& value)
     {
-      uint8_t data[8] = {0};
-      for (int i = 0; i < 8; ++i)
-      {
-        *this >> data[i];
-      }
-      value = *reinterpret_cast<const double*>(data); //FIXME: probably broken on ARM
+      ReadLittleEndian(In, &value, 1);
     }
 
     template<>
@@ -821,6 +830,22 @@ namespace OpcUa
       *this >> header.Size;
     }
 
+    void DataSerializer::UpdateMessageSize(std::size_t headerPos)
+    {
+      // Header and SecureHeader both start with message type (3 bytes), chunk type (1 byte) and size (4 bytes).
+      const std::size_t sizePos = headerPos + MESSAGE_TYPE_SIZE + 1;
+      if (sizePos + sizeof(uint32_t) > Buffer.size())
+      {
+        throw std::logic_error("Unable to update size of message: header was not serialized.");
+      }
+
+      const uint32_t size = static_cast<uint32_t>(Buffer.size() - headerPos);
+      for (std::size_t i = 0; i < sizeof(uint32_t); ++i)
+      {
+        Buffer[sizePos + i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+      }
+    }
+
     template<>
     void DataSerializer::Serialize<OpcUa::Binary::Hello>(const OpcUa::Binary::Hello& message)
     {
@@ -17,261 +17,356 @@
 #include <stdexcept>
 #include <iostream>
 
+namespace
+{
+
+  // FNV-1a, enough to spread string and binary identifiers over the 32 bit identifier slot.
+  uint32_t HashBytes(const uint8_t* data, std::size_t size)
+  {
+    uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      hash ^= data[i];
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+
+  void SerializeNodeIdIdentifier(OpcUa::Binary::DataSerializer& out, const OpcUa::NodeId& id)
+  {
+    using namespace OpcUa;
+    switch (id.GetEncodingValue())
+    {
+      case EV_TWO_BYTE:
+      {
+        out << static_cast<uint8_t>(id.GetIntegerIdentifier());
+        break;
+      }
+      case EV_FOUR_BYTE:
+      {
+        out << static_cast<uint8_t>(id.GetNamespaceIndex());
+        out << static_cast<uint16_t>(id.GetIntegerIdentifier());
+        break;
+      }
+      case EV_NUMERIC:
+      {
+        out << static_cast<uint16_t>(id.GetNamespaceIndex());
+        out << id.GetIntegerIdentifier();
+        break;
+      }
+      case EV_STRING:
+      {
+        out << static_cast<uint16_t>(id.GetNamespaceIndex());
+        out << id.GetStringIdentifier();
+        break;
+      }
+      case EV_BYTE_STRING:
+      {
+        out << static_cast<uint16_t>(id.GetNamespaceIndex());
+        out << id.GetBinaryIdentifier();
+        break;
+      }
+      case EV_GUId:
+      {
+        out << static_cast<uint16_t>(id.GetNamespaceIndex());
+        out << id.GetGuidIdentifier();
+        break;
+      }
+
+    default:
+      throw std::logic_error("Unable serialize NodeId. Unknown encoding type.");
+    };
+  }
+
+}
+
 namespace OpcUa
 {
 
+  NodeId StringNodeId(std::string value, uint16_t namespaceIndex)
+  {
+    NodeId id(EV_STRING, namespaceIndex, 0);
+    id.GetMutableData().StringIdentifier = std::move(value);
+    id.UpdateIdentifierHash();
+    return id;
+  }
+
+  NodeId BinaryNodeId(std::vector<uint8_t> value, uint16_t namespaceIndex)
+  {
+    NodeId id(EV_BYTE_STRING, namespaceIndex, 0);
+    id.GetMutableData().BinaryIdentifier = std::move(value);
+    id.UpdateIdentifierHash();
+    return id;
+  }
+
+  NodeId GuidNodeId(Guid value, uint16_t namespaceIndex)
+  {
+    NodeId id(EV_GUId, namespaceIndex, 0);
+    id.GetMutableData().GuidIdentifier = value;
+    id.UpdateIdentifierHash();
+    return id;
+  }
+
+  NodeId::NodeId()
+    : Encoding(EV_TWO_BYTE)
+    , NamespaceIndex(0)
+    , Identifier(0)
+    , Data(nullptr)
+  {
+  }
 
   NodeId::NodeId(uint32_t integerId, uint16_t index)
+    : NodeId(EV_NUMERIC, index, integerId)
   {
-    Encoding = EV_NUMERIC;
-    NumericData.Identifier = integerId;
-    NumericData.NamespaceIndex = index;
   }
 
   NodeId::NodeId(std::string stringId, uint16_t index)
+    : NodeId(StringNodeId(std::move(stringId), index))
   {
-    Encoding = EV_STRING;
-    StringData.Identifier = stringId;
-    StringData.NamespaceIndex = index;
   }
 
-  bool NodeId::IsInteger() const
+  NodeId::NodeId(MessageId messageId)
+    : NodeId(EV_FOUR_BYTE, 0, static_cast<uint16_t>(messageId))
   {
-    const NodeIdEncoding enc = GetEncodingValue();
-    return enc == EV_TWO_BYTE || enc == EV_FOUR_BYTE || enc == EV_NUMERIC;
   }
 
-  bool NodeId::IsString() const
+  NodeId::NodeId(ReferenceId referenceId)
+    : NodeId(EV_NUMERIC, 0, static_cast<uint32_t>(referenceId))
   {
-    const NodeIdEncoding enc = GetEncodingValue();
-    return enc == EV_STRING;
   }
 
-  bool NodeId::IsBinary() const
+  NodeId::NodeId(ObjectId objectId)
+    : NodeId(EV_NUMERIC, 0, static_cast<uint32_t>(objectId))
   {
-    const NodeIdEncoding enc = GetEncodingValue();
-    return enc == EV_BYTE_STRING;
   }
 
-  bool NodeId::IsGuid() const
+  NodeId::NodeId(ExpandedObjectId objectId)
+    : NodeId(EV_FOUR_BYTE, 0, static_cast<uint16_t>(objectId))
   {
-    const NodeIdEncoding enc = GetEncodingValue();
-    return enc == EV_GUId;
   }
 
-  std::string NodeId::GetStringIdentifier() const
+  NodeId::NodeId(const NodeId& node)
+    : Data(nullptr)
   {
-    if (IsString())
-    {
-      return StringData.Identifier;
-    }
-    throw std::logic_error("Node id is not in String format.");
+    CopyNodeId(node);
   }
 
-  std::vector<uint8_t> NodeId::GetBinaryIdentifier() const
+  NodeId::NodeId(NodeId&& node) noexcept
+    : Encoding(node.Encoding)
+    , NamespaceIndex(node.NamespaceIndex)
+    , Identifier(node.Identifier)
+    , Data(node.Data)
   {
-    if (IsBinary())
-    {
-      return BinaryData.Identifier;
-    }
-    throw std::logic_error("Node id is not in String format.");
+    node.Data = nullptr;
   }
 
-  Guid NodeId::GetGuidIdentifier() const
+  NodeId::NodeId(const ExpandedNodeId& node)
+    : Data(nullptr)
   {
-    if (IsGuid())
-    {
-      return GuidData.Identifier;
-    }
-    throw std::logic_error("Node id is not in String format.");
+    CopyNodeId(node);
   }
 
-  uint32_t NodeId::GetIntegerIdentifier() const
+  NodeId::~NodeId()
   {
-    switch (GetEncodingValue())
+    ReleaseData();
+  }
+
+  NodeId::operator ExpandedNodeId()
+  {
+    ExpandedNodeId node;
+    node.CopyNodeId(*this);
+
+    return node;
+  }
+
+  NodeId& NodeId::operator=(const NodeId& node)
+  {
+    CopyNodeId(node);
+    return *this;
+  }
+
+  NodeId& NodeId::operator=(NodeId&& node) noexcept
+  {
+    if (this != &node)
     {
-      case EV_TWO_BYTE:
-      {
-        return TwoByteData.Identifier;
-      }
-      case EV_FOUR_BYTE:
-      {
-        return FourByteData.Identifier;
-      }
-      case EV_NUMERIC:
-      {
-        return NumericData.Identifier;
-      }
-      default:
-      {
-        throw std::logic_error("Cannot get integer identifier from NodeId - it is not in numeric format.");
-      }
+      ReleaseData();
+      Encoding = node.Encoding;
+      NamespaceIndex = node.NamespaceIndex;
+      Identifier = node.Identifier;
+      Data = node.Data;
+      node.Data = nullptr;
     }
+    return *this;
   }
 
-  uint32_t NodeId::GetNamespaceIndex() const
+  NodeId& NodeId::operator=(const ExpandedNodeId& node)
   {
-    switch (GetEncodingValue())
+    CopyNodeId(node);
+    return *this;
+  }
+
+  void NodeId::CopyNodeId(const NodeId& node)
+  {
+    if (node.Data)
     {
-      case EV_FOUR_BYTE:
-        return FourByteData.NamespaceIndex;
-      case EV_NUMERIC:
-        return NumericData.NamespaceIndex;
-      case EV_STRING:
-        return StringData.NamespaceIndex;
-      case EV_GUId:
-        return GuidData.NamespaceIndex;
-      case EV_BYTE_STRING:
-        return BinaryData.NamespaceIndex;
-      default:
-        return 0;
+      ++node.Data->RefCount;
     }
+    ReleaseData();
+    Encoding = node.Encoding;
+    NamespaceIndex = node.NamespaceIndex;
+    Identifier = node.Identifier;
+    Data = node.Data;
   }
 
-  void NodeId::SetNamespaceIndex(uint32_t ns)
+  void NodeId::ReleaseData()
   {
-    switch (GetEncodingValue())
+    if (Data && --Data->RefCount == 0)
     {
-      case EV_FOUR_BYTE:
-        FourByteData.NamespaceIndex = ns;
-        return;
-      case EV_NUMERIC:
-        NumericData.NamespaceIndex = ns;
-        return;
-      case EV_STRING:
-        StringData.NamespaceIndex = ns;
-        return;
-      case EV_GUId:
-        GuidData.NamespaceIndex = ns;
-        return;
-      case EV_BYTE_STRING:
-        BinaryData.NamespaceIndex = ns;
-        return;
-      default:
-        return;
+      delete Data;
     }
+    Data = nullptr;
   }
 
-  NodeId::NodeId()
-    : Encoding(EV_TWO_BYTE)
-    , ServerIndex(0)
+  NodeId::ExtraData& NodeId::GetMutableData()
   {
+    if (!Data)
+    {
+      Data = new ExtraData();
+    }
+    else if (Data->RefCount > 1)
+    {
+      ExtraData* data = new ExtraData(*Data);
+      ReleaseData();
+      Data = data;
+    }
+    return *Data;
   }
 
-  void NodeId::CopyNodeId(const NodeId& node)
+  void NodeId::UpdateIdentifierHash()
   {
-    Encoding = node.Encoding;
-    const NodeIdEncoding enc = node.GetEncodingValue();
-    switch (enc)
+    switch (GetEncodingValue())
     {
-      case EV_TWO_BYTE:
-      {
-        TwoByteData.Identifier = node.TwoByteData.Identifier;
-        break;
-      }
-      case EV_FOUR_BYTE:
-      {
-        FourByteData.NamespaceIndex = node.FourByteData.NamespaceIndex;
-        FourByteData.Identifier = node.FourByteData.Identifier;
-        break;
-      }
-      case EV_NUMERIC:
-      {
-        NumericData.NamespaceIndex = node.NumericData.NamespaceIndex;
-        NumericData.Identifier = node.NumericData.Identifier;
-        break;
-      }
       case EV_STRING:
       {
-        StringData.NamespaceIndex = node.StringData.NamespaceIndex;
-        StringData.Identifier = node.StringData.Identifier;
+        const std::string& str = GetStringIdentifier();
+        Identifier = HashBytes(reinterpret_cast<const uint8_t*>(str.data()), str.size());
         break;
       }
-      case EV_GUId:
+      case EV_BYTE_STRING:
       {
-        GuidData.NamespaceIndex = node.GuidData.NamespaceIndex;
-        GuidData.Identifier = node.GuidData.Identifier;
+        const std::vector<uint8_t>& bytes = GetBinaryIdentifier();
+        Identifier = HashBytes(bytes.data(), bytes.size());
         break;
       }
-      case EV_BYTE_STRING:
+      case EV_GUId:
       {
-        BinaryData.NamespaceIndex = node.BinaryData.NamespaceIndex;
-        BinaryData.Identifier = node.BinaryData.Identifier;
+        const Guid& guid = GetGuidIdentifier();
+        Identifier = guid.Data1 ^ (static_cast<uint32_t>(guid.Data2) << 16 | guid.Data3) ^ HashBytes(guid.Data4, sizeof(guid.Data4));
         break;
       }
       default:
-      {
-        throw std::logic_error("Invalid Node Id encoding value.");
-      }
+        break;
     }
+  }
 
-    if (node.HasServerIndex())
-    {
-      ServerIndex = node.ServerIndex;
-    }
-    if (node.HasNamespaceURI())
-    {
-      NamespaceURI = node.NamespaceURI;
-    }
+  bool NodeId::IsInteger() const
+  {
+    const NodeIdEncoding enc = GetEncodingValue();
+    return enc == EV_TWO_BYTE || enc == EV_FOUR_BYTE || enc == EV_NUMERIC;
+  }
 
+  bool NodeId::IsString() const
+  {
+    const NodeIdEncoding enc = GetEncodingValue();
+    return enc == EV_STRING;
   }
 
-  NodeId::NodeId(const NodeId& node)
+  bool NodeId::IsBinary() const
   {
-    CopyNodeId(node);
+    const NodeIdEncoding enc = GetEncodingValue();
+    return enc == EV_BYTE_STRING;
   }
 
-  NodeId::NodeId(const ExpandedNodeId& node)
+  bool NodeId::IsGuid() const
   {
-    CopyNodeId(node);
+    const NodeIdEncoding enc = GetEncodingValue();
+    return enc == EV_GUId;
   }
 
-  NodeId::operator ExpandedNodeId()
+  const std::string& NodeId::GetStringIdentifier() const
   {
-    ExpandedNodeId node;
-    node.CopyNodeId(*this);
+    if (IsString())
+    {
+      static const std::string empty;
+      return Data ? Data->StringIdentifier : empty;
+    }
+    throw std::logic_error("Node id is not in String format.");
+  }
 
-    return node;
+  const std::vector<uint8_t>& NodeId::GetBinaryIdentifier() const
+  {
+    if (IsBinary())
+    {
+      static const std::vector<uint8_t> empty;
+      return Data ? Data->BinaryIdentifier : empty;
+    }
+    throw std::logic_error("Node id is not in String format.");
   }
 
-  NodeId& NodeId::operator=(const NodeId& node)
+  const Guid& NodeId::GetGuidIdentifier() const
   {
-    CopyNodeId(node);
-    return *this;
+    if (IsGuid())
+    {
+      static const Guid empty;
+      return Data ? Data->GuidIdentifier : empty;
+    }
+    throw std::logic_error("Node id is not in String format.");
   }
 
-  NodeId& NodeId::operator=(const ExpandedNodeId& node)
+  uint32_t NodeId::GetIntegerIdentifier() const
   {
-    CopyNodeId(node);
-    return *this;
+    if (IsInteger())
+    {
+      return Identifier;
+    }
+    throw std::logic_error("Cannot get integer identifier from NodeId - it is not in numeric format.");
   }
 
-  NodeId::NodeId(MessageId messageId)
-    : Encoding(EV_FOUR_BYTE)
-    , ServerIndex(0)
+  uint32_t NodeId::GetNamespaceIndex() const
   {
-    FourByteData.Identifier = messageId;
+    return NamespaceIndex;
   }
 
-  NodeId::NodeId(ReferenceId referenceId)
-    : Encoding(EV_NUMERIC)
-    , ServerIndex(0)
+  void NodeId::SetNamespaceIndex(uint32_t ns)
+  {
+    switch (GetEncodingValue())
+    {
+      case EV_TWO_BYTE:
+        return;
+      case EV_FOUR_BYTE:
+        NamespaceIndex = static_cast<uint8_t>(ns);
+        return;
+      default:
+        NamespaceIndex = static_cast<uint16_t>(ns);
+        return;
+    }
+  }
+
+  const std::string& NodeId::GetNamespaceURI() const
   {
-    NumericData.Identifier = static_cast<uint32_t>(referenceId);
+    static const std::string empty;
+    return Data ? Data->NamespaceURI : empty;
   }
 
-  NodeId::NodeId(ObjectId objectId)
-    : Encoding(EV_NUMERIC)
-    , ServerIndex(0)
+  uint32_t NodeId::GetServerIndex() const
   {
-    NumericData.Identifier = static_cast<uint32_t>(objectId);
+    return Data ? Data->ServerIndex : 0;
   }
 
-  NodeId::NodeId(ExpandedObjectId objectId)
-    : Encoding(EV_FOUR_BYTE)
-    , ServerIndex(0)
+  std::size_t NodeId::GetHash() const
   {
-    FourByteData.Identifier = static_cast<uint32_t>(objectId);
+    const uint64_t key = static_cast<uint64_t>(NamespaceIndex) << 32 | Identifier;
+    return std::hash<uint64_t>()(key);
   }
 
   MessageId GetMessageId(const NodeId& id)
@@ -282,13 +377,13 @@ namespace OpcUa
 
   bool NodeId::operator== (const NodeId& node) const
   {
-    if (GetNamespaceIndex() != node.GetNamespaceIndex())
+    if (NamespaceIndex != node.NamespaceIndex || Identifier != node.Identifier)
     {
       return false;
     }
     if (IsInteger() && node.IsInteger())
     {
-      return GetIntegerIdentifier() == node.GetIntegerIdentifier();
+      return true;
     }
     if (IsString() && node.IsString())
     {
@@ -307,13 +402,13 @@ namespace OpcUa
 
   bool NodeId::operator < (const NodeId& node) const
   {
-    if (GetNamespaceIndex() != node.GetNamespaceIndex())
+    if (NamespaceIndex != node.NamespaceIndex)
     {
-      return GetNamespaceIndex() < node.GetNamespaceIndex();
+      return NamespaceIndex < node.NamespaceIndex;
     }
     if (IsInteger() && node.IsInteger())
     {
-      return GetIntegerIdentifier() < node.GetIntegerIdentifier();
+      return Identifier < node.Identifier;
     }
     if (IsString() && node.IsString())
     {
@@ -333,6 +428,11 @@ namespace OpcUa
 
   }
 
+  NodeIdEncoding NodeId::GetEncoding() const
+  {
+    return Encoding;
+  }
+
   NodeIdEncoding NodeId::GetEncodingValue() const
   {
     return static_cast<NodeIdEncoding>(Encoding & EV_VALUE_MASK);
@@ -340,66 +440,32 @@ namespace OpcUa
 
   bool NodeId::IsNull() const
   {
-    switch (GetEncodingValue())
+    if (GetEncodingValue() > EV_BYTE_STRING)
     {
-      case EV_FOUR_BYTE:
-        if (FourByteData.NamespaceIndex != 0)
-          return false;
-        break;
-      case EV_NUMERIC:
-        if (NumericData.NamespaceIndex != 0)
-          return false;
-        break;
-      case EV_STRING:
-        if (StringData.NamespaceIndex != 0)
-          return false;
-        break;
-      case EV_GUId:
-        if (GuidData.NamespaceIndex != 0)
-          return false;
-        break;
-      case EV_BYTE_STRING:
-        if (BinaryData.NamespaceIndex != 0)
-          return false;
-        break;
-      default:
-      {
-        throw std::logic_error("Invalid Node Id encoding value.");
-      }
+      throw std::logic_error("Invalid Node Id encoding value.");
     }
-    return HasNullIdentifier();
+    return NamespaceIndex == 0 && HasNullIdentifier();
   }
 
   bool NodeId::HasNullIdentifier() const
   {
     switch (GetEncodingValue())
     {
+      case EV_TWO_BYTE:
       case EV_FOUR_BYTE:
-        if (FourByteData.Identifier != 0)
-          return false;
-        break;
       case EV_NUMERIC:
-        if (NumericData.Identifier != 0)
-          return false;
-        break;
+        return Identifier == 0;
       case EV_STRING:
-        if (! StringData.Identifier.empty())
-          return false;
-        break;
+        return GetStringIdentifier().empty();
       case EV_GUId:
-        if (! (GuidData.Identifier == Guid()))
-          return false;
-        break;
+        return GetGuidIdentifier() == Guid();
       case EV_BYTE_STRING:
-        if (! BinaryData.Identifier.empty())
-          return false;
-        break;
+        return GetBinaryIdentifier().empty();
       default:
       {
         throw std::logic_error("Invalid Node Id encoding value.");
       }
     }
-    return true;
   }
 
   bool NodeId::HasNamespaceURI() const
@@ -415,13 +481,13 @@ namespace OpcUa
   void NodeId::SetNamespaceURI(const std::string& uri)
   {
     Encoding = static_cast<NodeIdEncoding>(Encoding | EV_NAMESPACE_URI_FLAG);
-    NamespaceURI = uri;
+    GetMutableData().NamespaceURI = uri;
   }
 
   void NodeId::SetServerIndex(uint32_t index)
   {
     Encoding = static_cast<NodeIdEncoding>(Encoding | EV_Server_INDEX_FLAG);
-    ServerIndex = index;
+    GetMutableData().ServerIndex = index;
   }
 
   bool NodeId::operator!= (const NodeId& node) const
@@ -475,61 +541,47 @@ namespace OpcUa
   ///ExpandednNdeId
   ExpandedNodeId::ExpandedNodeId()
   {
-    Encoding = EV_TWO_BYTE;
-    ServerIndex = 0;
   }
 
   ExpandedNodeId::ExpandedNodeId(uint32_t integerId, uint16_t index)
+    : NodeId(integerId, index)
   {
-    Encoding = EV_NUMERIC;
-    NumericData.Identifier = integerId;
-    NumericData.NamespaceIndex = index;
   }
 
   ExpandedNodeId::ExpandedNodeId(std::string stringId, uint16_t index)
+    : NodeId(std::move(stringId), index)
   {
-    Encoding = EV_STRING;
-    StringData.Identifier = stringId;
-    StringData.NamespaceIndex = index;
   }
 
   ExpandedNodeId::ExpandedNodeId(const NodeId& node)
+    : NodeId(node)
   {
-    CopyNodeId(node);
   }
 
   ExpandedNodeId::ExpandedNodeId(const ExpandedNodeId& node)
+    : NodeId(node)
   {
-    CopyNodeId(node);
   }
 
 
   ExpandedNodeId::ExpandedNodeId(MessageId messageId)
+    : NodeId(messageId)
   {
-    Encoding = EV_FOUR_BYTE;
-    ServerIndex = 0;
-    FourByteData.Identifier = messageId;
   }
 
   ExpandedNodeId::ExpandedNodeId(ReferenceId referenceId)
+    : NodeId(referenceId)
   {
-    Encoding = EV_NUMERIC;
-    ServerIndex = 0;
-    NumericData.Identifier = static_cast<uint32_t>(referenceId);
   }
 
   ExpandedNodeId::ExpandedNodeId(ObjectId objectId)
+    : NodeId(objectId)
   {
-    Encoding = EV_NUMERIC;
-    ServerIndex = 0;
-    NumericData.Identifier = static_cast<uint32_t>(objectId);
   }
 
   ExpandedNodeId::ExpandedNodeId(ExpandedObjectId objectId)
+    : NodeId(objectId)
   {
-    Encoding = EV_FOUR_BYTE;
-    ServerIndex = 0;
-    FourByteData.Identifier = static_cast<uint32_t>(objectId);
   }
 
 
@@ -585,7 +637,7 @@ namespace OpcUa
           const std::size_t sizeofEncoding = 1;
           const std::size_t sizeofSize = 4;
           const std::size_t sizeofNamespace = 2;
-          size = sizeofEncoding + sizeofNamespace + sizeofSize + id.StringData.Identifier.size();
+          size = sizeofEncoding + sizeofNamespace + sizeofSize + id.GetStringIdentifier().size();
           break;
         }
         case EV_BYTE_STRING:
@@ -593,7 +645,7 @@ namespace OpcUa
           const std::size_t sizeofEncoding = 1;
           const std::size_t sizeofSize = 4;
           const std::size_t sizeofNamespace = 2;
-          size = sizeofEncoding + sizeofNamespace + sizeofSize + id.BinaryData.Identifier.size();
+          size = sizeofEncoding + sizeofNamespace + sizeofSize + id.GetBinaryIdentifier().size();
           break;
         }
         case EV_GUId:
@@ -616,96 +668,72 @@ namespace OpcUa
     void DataSerializer::Serialize<OpcUa::NodeId>(const OpcUa::NodeId& id)
     {
       //unset server and namespace flags in encoding, they should only be used in ExpandedNode Id
-      uint8_t nodeid_encoding = id.Encoding;
+      uint8_t nodeid_encoding = id.GetEncoding();
       nodeid_encoding &= ~EV_Server_INDEX_FLAG;
       nodeid_encoding &= ~EV_NAMESPACE_URI_FLAG;
 
       *this << nodeid_encoding;
-
-      switch (id.GetEncodingValue())
-      {
-        case EV_TWO_BYTE:
-        {
-          *this << id.TwoByteData.Identifier;
-          break;
-        }
-        case EV_FOUR_BYTE:
-        {
-          *this << id.FourByteData.NamespaceIndex;
-          *this << id.FourByteData.Identifier;
-          break;
-        }
-        case EV_NUMERIC:
-        {
-          *this << id.NumericData.NamespaceIndex;
-          *this << id.NumericData.Identifier;
-          break;
-        }
-        case EV_STRING:
-        {
-          *this << id.StringData.NamespaceIndex;
-          *this << id.StringData.Identifier;
-          break;
-        }
-        case EV_BYTE_STRING:
-        {
-          *this << id.BinaryData.NamespaceIndex;
-          *this << id.BinaryData.Identifier;
-          break;
-        }
-        case EV_GUId:
-        {
-          *this << id.GuidData.NamespaceIndex;
-          *this << id.GuidData.Identifier;
-          break;
-        }
-
-      default:
-        throw std::logic_error("Unable serialize NodeId. Unknown encoding type.");
-      };
-
+      SerializeNodeIdIdentifier(*this, id);
     }
 
     template<>
     void DataDeserializer::Deserialize<OpcUa::NodeId>(OpcUa::NodeId& id)
     {
-      *this >> id.Encoding;
+      NodeIdEncoding encoding = EV_TWO_BYTE;
+      *this >> encoding;
 
-      switch (id.GetEncodingValue())
+      switch (encoding & EV_VALUE_MASK)
       {
         case EV_TWO_BYTE:
         {
-          *this >> id.TwoByteData.Identifier;
+          uint8_t identifier = 0;
+          *this >> identifier;
+          id = TwoByteNodeId(identifier);
           break;
         }
         case EV_FOUR_BYTE:
         {
-          *this >> id.FourByteData.NamespaceIndex;
-          *this >> id.FourByteData.Identifier;
+          uint8_t ns = 0;
+          uint16_t identifier = 0;
+          *this >> ns;
+          *this >> identifier;
+          id = FourByteNodeId(identifier, ns);
           break;
         }
         case EV_NUMERIC:
         {
-          *this >> id.NumericData.NamespaceIndex;
-          *this >> id.NumericData.Identifier;
+          uint16_t ns = 0;
+          uint32_t identifier = 0;
+          *this >> ns;
+          *this >> identifier;
+          id = NumericNodeId(identifier, ns);
           break;
         }
         case EV_STRING:
         {
-          *this >> id.StringData.NamespaceIndex;
-          *this >> id.StringData.Identifier;
+          uint16_t ns = 0;
+          std::string identifier;
+          *this >> ns;
+          *this >> identifier;
+          id = StringNodeId(std::move(identifier), ns);
           break;
         }
         case EV_BYTE_STRING:
         {
-          *this >> id.BinaryData.NamespaceIndex;
-          *this >> id.BinaryData.Identifier;
+          uint16_t ns = 0;
+          std::vector<uint8_t> identifier;
+          *this >> ns;
+          *this >> identifier;
+          id = BinaryNodeId(std::move(identifier), ns);
           break;
         }
         case EV_GUId:
         {
-          *this >> id.GuidData.NamespaceIndex;
-          *this >> id.GuidData.Identifier;
+          uint16_t ns = 0;
+          Guid identifier;
+          *this >> ns;
+          *this >> identifier;
+          id = GuidNodeId(identifier, ns);
           break;
         }
 
@@ -715,13 +743,17 @@ namespace OpcUa
         }
       };
 
-      if (id.HasNamespaceURI())
+      if (encoding & EV_NAMESPACE_URI_FLAG)
       {
-        *this >> id.NamespaceURI;
+        std::string uri;
+        *this >> uri;
+        id.SetNamespaceURI(uri);
       }
-      if (id.HasServerIndex())
+      if (encoding & EV_Server_INDEX_FLAG)
       {
-        *this >> id.ServerIndex;
+        uint32_t index = 0;
+        *this >> index;
+        id.SetServerIndex(index);
       }
     }
 
@@ -733,7 +765,7 @@ namespace OpcUa
       if (id.HasNamespaceURI())
       {
         const std::size_t sizeofSize = 4;
-        size += sizeofSize + id.NamespaceURI.size();
+        size += sizeofSize + id.GetNamespaceURI().size();
       }
       if (id.HasServerIndex())
       {
@@ -746,57 +778,16 @@ namespace OpcUa
     template<>
     void DataSerializer::Serialize<OpcUa::ExpandedNodeId>(const OpcUa::ExpandedNodeId& id)
     {
-      *this << id.Encoding;
-
-      switch (id.GetEncodingValue())
-      {
-        case EV_TWO_BYTE:
-        {
-          *this << id.TwoByteData.Identifier;
-          break;
-        }
-        case EV_FOUR_BYTE:
-        {
-          *this << id.FourByteData.NamespaceIndex;
-          *this << id.FourByteData.Identifier;
-          break;
-        }
-        case EV_NUMERIC:
-        {
-          *this << id.NumericData.NamespaceIndex;
-          *this << id.NumericData.Identifier;
-          break;
-        }
-        case EV_STRING:
-        {
-          *this << id.StringData.NamespaceIndex;
-          *this << id.StringData.Identifier;
-          break;
-        }
-        case EV_BYTE_STRING:
-        {
-          *this << id.BinaryData.NamespaceIndex;
-          *this << id.BinaryData.Identifier;
-          break;
-        }
-        case EV_GUId:
-        {
-          *this << id.GuidData.NamespaceIndex;
-          *this << id.GuidData.Identifier;
-          break;
-        }
-
-      default:
-        throw std::logic_error("Unable serialize ExpandedNodeId. Unknown encoding type.");
-      };
+      *this << id.GetEncoding();
+      SerializeNodeIdIdentifier(*this, id);
 
       if (id.HasNamespaceURI())
       {
-        *this << id.NamespaceURI;
+        *this << id.GetNamespaceURI();
       }
       if (id.HasServerIndex())
       {
-        *this << id.ServerIndex;
+        *this << id.GetServerIndex();
       }
     }
 
@@ -809,4 +800,3 @@ namespace OpcUa
 
   } // namespace Binary
 } // namespace OpcUa
-
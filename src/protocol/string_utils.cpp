@@ -33,11 +33,11 @@ std::string OpcUa::ToString(const NodeId& id)
 
   if (id.HasServerIndex())
   {
-    stream << "srv=" << id.ServerIndex << ";";
+    stream << "srv=" << id.GetServerIndex() << ";";
   }
   {
   if (id.HasNamespaceURI())
-    stream << "nsu=" << id.NamespaceURI << ";";
+    stream << "nsu=" << id.GetNamespaceURI() << ";";
   }
 
   stream << "ns=" << id.GetNamespaceIndex() << ";";
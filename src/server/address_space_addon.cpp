@@ -123,12 +123,22 @@ namespace OpcUa
       return Registry->SetValueCallback(node, attribute, callback);
     }
 
+    bool AddressSpaceAddon::HasValueCallback(const NodeId& node, AttributeId attribute) const
+    {
+      return Registry->HasValueCallback(node, attribute);
+    }
+
     void AddressSpaceAddon::SetMethod(const NodeId& node, std::function<std::vector<OpcUa::Variant> (NodeId context, std::vector<OpcUa::Variant> arguments)> callback)
     {
       Registry->SetMethod(node, callback);
       return;
     }
 
+    Server::ValueSlot::SharedPtr AddressSpaceAddon::GetValueSlot(const NodeId& node, AttributeId attribute)
+    {
+      return Registry->GetValueSlot(node, attribute);
+    }
+
     std::vector<CallMethodResult> AddressSpaceAddon::Call(const std::vector<CallMethodRequest>& methodsToCall)
     {
       return Registry->Call(methodsToCall);
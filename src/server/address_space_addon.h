@@ -59,7 +59,9 @@ namespace OpcUa
       virtual uint32_t AddDataChangeCallback(const NodeId& node, AttributeId attribute, std::function<Server::DataChangeCallback> callback);
       virtual void DeleteDataChangeCallback(uint32_t clienthandle);
       virtual StatusCode SetValueCallback(const NodeId& node, AttributeId attribute, std::function<DataValue(void)> callback);
+      virtual bool HasValueCallback(const NodeId& node, AttributeId attribute) const;
       virtual void SetMethod(const NodeId& node, std::function<std::vector<OpcUa::Variant> (NodeId context, std::vector<OpcUa::Variant> arguments)> callback);
+      virtual Server::ValueSlot::SharedPtr GetValueSlot(const NodeId& node, AttributeId attribute);
 
     private:
       struct Options
@@ -25,10 +25,156 @@ namespace OpcUa
       MonitoringParameters Parameters;
     };
 
+    AttributeValue* NodeStruct::FindAttribute(AttributeId attribute)
+    {
+      const std::size_t id = static_cast<std::size_t>(attribute);
+      if (id > MaxAttributeId || AttributeSlots[id] == 0)
+      {
+        return nullptr;
+      }
+      return &Attributes[AttributeSlots[id] - 1];
+    }
+
+    const AttributeValue* NodeStruct::FindAttribute(AttributeId attribute) const
+    {
+      return const_cast<NodeStruct*>(this)->FindAttribute(attribute);
+    }
+
+    AttributeValue* NodeStruct::AddAttribute(AttributeId attribute)
+    {
+      const std::size_t id = static_cast<std::size_t>(attribute);
+      if (id > MaxAttributeId)
+      {
+        return nullptr;
+      }
+      if (AttributeSlots[id] == 0)
+      {
+        Attributes.emplace_back();
+        AttributeSlots[id] = static_cast<uint8_t>(Attributes.size());
+      }
+      return &Attributes[AttributeSlots[id] - 1];
+    }
+
+    uint32_t NodeStore::Hash(const NodeId& id)
+    {
+      // NodeId hash is not mixed, sequential numeric ids differ only in low bits.
+      const uint64_t hash = static_cast<uint64_t>(id.GetHash()) * 0x9E3779B97F4A7C15ull;
+      return static_cast<uint32_t>(hash >> 32);
+    }
+
+    std::size_t NodeStore::FindEntry(const NodeId& id, uint32_t hash) const
+    {
+      const std::size_t mask = Index.size() - 1;
+      std::size_t pos = hash & mask;
+      while (Index[pos].Slot != 0)
+      {
+        if (Index[pos].Hash == hash && Nodes[Index[pos].Slot - 1].Id == id)
+        {
+          break;
+        }
+        pos = (pos + 1) & mask;
+      }
+      return pos;
+    }
+
+    void NodeStore::Rehash(std::size_t capacity)
+    {
+      std::vector<IndexEntry> index(capacity);
+      const std::size_t mask = capacity - 1;
+      for (const IndexEntry& entry : Index)
+      {
+        if (entry.Slot == 0)
+        {
+          continue;
+        }
+        std::size_t pos = entry.Hash & mask;
+        while (index[pos].Slot != 0)
+        {
+          pos = (pos + 1) & mask;
+        }
+        index[pos] = entry;
+      }
+      Index.swap(index);
+    }
+
+    NodeStruct* NodeStore::Find(const NodeId& id)
+    {
+      if (Nodes.empty())
+      {
+        return nullptr;
+      }
+      const IndexEntry& entry = Index[FindEntry(id, Hash(id))];
+      return entry.Slot ? &Nodes[entry.Slot - 1] : nullptr;
+    }
+
+    const NodeStruct* NodeStore::Find(const NodeId& id) const
+    {
+      return const_cast<NodeStore*>(this)->Find(id);
+    }
+
+    NodeStruct* NodeStore::Insert(NodeStruct&& node)
+    {
+      // Keep load factor below one half so probe sequences stay short.
+      if ((Nodes.size() + 1) * 2 > Index.size())
+      {
+        Rehash(Index.empty() ? 64 : Index.size() * 2);
+      }
+      const uint32_t hash = Hash(node.Id);
+      IndexEntry& entry = Index[FindEntry(node.Id, hash)];
+      Nodes.push_back(std::move(node));
+      entry.Hash = hash;
+      entry.Slot = static_cast<uint32_t>(Nodes.size());
+      return &Nodes.back();
+    }
+
+    class AttributeValueSlot : public Server::ValueSlot
+    {
+    public:
+      AttributeValueSlot(std::shared_ptr<SlotOwner> owner, const NodeId& node, AttributeId attribute, std::shared_ptr<SharedValue> value)
+        : Owner(owner)
+        , Node(node)
+        , Attribute(attribute)
+        , Value(value)
+      {
+      }
+
+      virtual void SetValue(const DataValue& data)
+      {
+        if (Value->CallbacksCount != 0)
+        {
+          // Notified writes take the shard lock to be delivered in order.
+          // Address space is not destroyed while it is used by the slot.
+          boost::shared_lock<boost::shared_mutex> lock(Owner->Mutex);
+          if (Owner->AddressSpace)
+          {
+            Owner->AddressSpace->SetValue(Node, Attribute, data);
+            return;
+          }
+        }
+        DataValue value(data);
+        value.SetServerTimestamp(DateTime::Current());
+        std::atomic_store(&Value->Current, std::make_shared<const DataValue>(std::move(value)));
+      }
+
+      virtual DataValue GetValue() const
+      {
+        return *std::atomic_load(&Value->Current);
+      }
+
+    private:
+      const std::shared_ptr<SlotOwner> Owner;
+      const NodeId Node;
+      const AttributeId Attribute;
+      const std::shared_ptr<SharedValue> Value;
+    };
+
     AddressSpaceInMemory::AddressSpaceInMemory(bool debug)
         : Debug(debug)
+        , MaxNodeIdNum(2000)
         , DataChangeCallbackHandle(0)
+        , Owner(std::make_shared<SlotOwner>())
     {
+      Owner->AddressSpace = this;
       /*
       ObjectAttributes attrs;
       attrs.Description = LocalizedText(OpcUa::Names::Root);
@@ -46,12 +192,31 @@ namespace OpcUa
 
     AddressSpaceInMemory::~AddressSpaceInMemory()
     {
+      // Slots which outlive the address space keep their value but do not notify anymore.
+      boost::unique_lock<boost::shared_mutex> lock(Owner->Mutex);
+      Owner->AddressSpace = nullptr;
     }
 
-    std::vector<AddNodesResult> AddressSpaceInMemory::AddNodes(const std::vector<AddNodesItem>& items)
+    AddressSpaceInMemory::NodeShard& AddressSpaceInMemory::GetShard(const NodeId& node)
+    {
+      // Upper bits of the hash select the shard, lower bits are used by the shard index.
+      return Shards[NodeStore::Hash(node) >> (32 - ShardBits)];
+    }
+
+    const AddressSpaceInMemory::NodeShard& AddressSpaceInMemory::GetShard(const NodeId& node) const
+    {
+      return const_cast<AddressSpaceInMemory*>(this)->GetShard(node);
+    }
+
+    bool AddressSpaceInMemory::HasNode(const NodeId& node) const
     {
-      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
+      const NodeShard& shard = GetShard(node);
+      boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+      return shard.Nodes.Find(node) != nullptr;
+    }
 
+    std::vector<AddNodesResult> AddressSpaceInMemory::AddNodes(const std::vector<AddNodesItem>& items)
+    {
       std::vector<AddNodesResult> results;
       for (const AddNodesItem& item: items)
       {
@@ -62,8 +227,6 @@ namespace OpcUa
 
     std::vector<StatusCode> AddressSpaceInMemory::AddReferences(const std::vector<AddReferencesItem>& items)
     {
-      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
-
       std::vector<StatusCode> results;
       for (const auto& item : items)
       {
@@ -74,8 +237,6 @@ namespace OpcUa
 
     std::vector<BrowsePathResult> AddressSpaceInMemory::TranslateBrowsePathsToNodeIds(const TranslateBrowsePathsParameters& params) const
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
       std::vector<BrowsePathResult> results;
       for (BrowsePath browsepath : params.BrowsePaths )
       {
@@ -87,8 +248,6 @@ namespace OpcUa
 
     std::vector<BrowseResult> AddressSpaceInMemory::Browse(const OpcUa::NodesQuery& query) const
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
       if (Debug) std::cout << "AddressSpaceInternal | Browsing." << std::endl;
       std::vector<BrowseResult> results;
       for ( BrowseDescription browseDescription: query.NodesToBrowse)
@@ -104,14 +263,21 @@ namespace OpcUa
           std::cout << ", ResultMask: '0x" << std::hex << (unsigned)browseDescription.ResultMask << std::endl;
         }
 
-        NodesMap::const_iterator node_it = Nodes.find(browseDescription.NodeToBrowse);
-        if ( node_it == Nodes.end() )
+        // References are copied because checking reference type walks other nodes.
+        std::vector<ReferenceDescription> references;
         {
-          if (Debug) std::cout << "AddressSpaceInternal | Node '" << OpcUa::ToString(browseDescription.NodeToBrowse) << "' not found in the address space." << std::endl;
-          continue;
+          const NodeShard& shard = GetShard(browseDescription.NodeToBrowse);
+          boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+          const NodeStruct* node = shard.Nodes.Find(browseDescription.NodeToBrowse);
+          if ( !node )
+          {
+            if (Debug) std::cout << "AddressSpaceInternal | Node '" << OpcUa::ToString(browseDescription.NodeToBrowse) << "' not found in the address space." << std::endl;
+            continue;
+          }
+          references = node->References;
         }
 
-        std::copy_if(node_it->second.References.begin(), node_it->second.References.end(), std::back_inserter(result.Referencies),
+        std::copy_if(references.begin(), references.end(), std::back_inserter(result.Referencies),
             std::bind(&AddressSpaceInMemory::IsSuitableReference, this, std::cref(browseDescription), std::placeholders::_1)
         );
         results.push_back(result);
@@ -121,30 +287,23 @@ namespace OpcUa
 
     std::vector<BrowseResult> AddressSpaceInMemory::BrowseNext() const
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
       return std::vector<BrowseResult>();
     }
 
 	std::vector<NodeId> AddressSpaceInMemory::RegisterNodes(const std::vector<NodeId>& params) const
 	{
-		boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
 		return params;
 	}
 
 	void AddressSpaceInMemory::UnregisterNodes(const std::vector<NodeId>& params) const
 	{
-		boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
 		return;
 	}
 
     std::vector<DataValue> AddressSpaceInMemory::Read(const ReadParameters& params) const
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
       std::vector<DataValue> values;
+      values.reserve(params.AttributesToRead.size());
       for (const ReadValueId& attribute : params.AttributesToRead)
       {
         values.push_back(GetValue(attribute.NodeId, attribute.AttributeId));
@@ -154,10 +313,8 @@ namespace OpcUa
 
     std::vector<StatusCode> AddressSpaceInMemory::Write(const std::vector<OpcUa::WriteValue>& values)
     {
-      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
-
       std::vector<StatusCode> statuses;
-      for (WriteValue value : values)
+      for (const WriteValue& value : values)
       {
         if (value.Value.Encoding & DATA_VALUE)
         {
@@ -171,10 +328,13 @@ namespace OpcUa
 
     std::tuple<bool, NodeId> AddressSpaceInMemory::FindElementInNode(const NodeId& nodeid, const RelativePathElement& element) const
     {
-      NodesMap::const_iterator nodeit = Nodes.find(nodeid);
-      if ( nodeit != Nodes.end() )
+      const NodeShard& shard = GetShard(nodeid);
+      boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+
+      const NodeStruct* node = shard.Nodes.Find(nodeid);
+      if ( node )
       {
-        for (auto reference : nodeit->second.References)
+        for (const auto& reference : node->References)
         {
           //if (reference.first == current) { std::cout <<   reference.second.BrowseName.NamespaceIndex << reference.second.BrowseName.Name << " to " << element.TargetName.NamespaceIndex << element.TargetName.Name <<std::endl; }
           if (reference.BrowseName == element.TargetName)
@@ -214,29 +374,44 @@ namespace OpcUa
 
     DataValue AddressSpaceInMemory::GetValue(const NodeId& node, AttributeId attribute) const
     {
-      NodesMap::const_iterator nodeit = Nodes.find(node);
-      if ( nodeit == Nodes.end() )
+      std::function<DataValue(void)> callback;
       {
-        if (Debug) std::cout << "AddressSpaceInternal | Bad node not found: " << node << std::endl;
-      }
-      else
-      {
-        AttributesMap::const_iterator attrit = nodeit->second.Attributes.find(attribute);
-        if ( attrit == nodeit->second.Attributes.end() )
+        const NodeShard& shard = GetShard(node);
+        boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+
+        const NodeStruct* nodeStruct = shard.Nodes.Find(node);
+        if ( !nodeStruct )
         {
-          if (Debug) std::cout << "AddressSpaceInternal | node " << node << " has not attribute: " << (uint32_t)attribute << std::endl;
+          if (Debug) std::cout << "AddressSpaceInternal | Bad node not found: " << node << std::endl;
         }
         else
         {
-          if ( attrit->second.GetValueCallback )
+          const AttributeValue* attrval = nodeStruct->FindAttribute(attribute);
+          if ( !attrval )
           {
-            if (Debug) std::cout << "AddressSpaceInternal | A callback is set for this value, calling callback" << std::endl;
-            return attrit->second.GetValueCallback();
+            if (Debug) std::cout << "AddressSpaceInternal | node " << node << " has not attribute: " << (uint32_t)attribute << std::endl;
+          }
+          else if ( !attrval->GetValueCallback )
+          {
+            if (Debug) std::cout << "AddressSpaceInternal | No callback is set for this value returning stored value" << std::endl;
+            if ( attrval->Shared )
+            {
+              return *std::atomic_load(&attrval->Shared->Current);
+            }
+            return attrval->Value;
+          }
+          else
+          {
+            callback = attrval->GetValueCallback;
           }
-          if (Debug) std::cout << "AddressSpaceInternal | No callback is set for this value returning stored value" << std::endl;
-          return attrit->second.Value;
         }
       }
+
+      if ( callback )
+      {
+        if (Debug) std::cout << "AddressSpaceInternal | A callback is set for this value, calling callback" << std::endl;
+        return callback();
+      }
       DataValue value;
       value.Encoding = DATA_VALUE_STATUS_CODE;
       value.Status = StatusCode::BadNotReadable;
@@ -247,14 +422,18 @@ namespace OpcUa
     {
       if (Debug) std::cout << "AddressSpaceInternal| Set data changes callback for node " << node
          << " and attribute " << (unsigned)attribute <<  std::endl;
-      NodesMap::iterator it = Nodes.find(node);
-      if ( it == Nodes.end() )
+
+      NodeShard& shard = GetShard(node);
+      boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+
+      NodeStruct* nodeStruct = shard.Nodes.Find(node);
+      if ( !nodeStruct )
       {
         if (Debug) std::cout << "AddressSpaceInternal| Node '" << node << "' not found." << std::endl;
         throw std::runtime_error("AddressSpaceInternal | NodeId not found");
       }
-      AttributesMap::iterator ait = it->second.Attributes.find(attribute);
-      if ( ait == it->second.Attributes.end() )
+      AttributeValue* attrval = nodeStruct->FindAttribute(attribute);
+      if ( !attrval )
       {
         if (Debug) std::cout << "address_space| Attribute " << (unsigned)attribute << " of node '" << node << "' not found." << std::endl;
         throw std::runtime_error("Attribute not found");
@@ -263,7 +442,18 @@ namespace OpcUa
       uint32_t handle = ++DataChangeCallbackHandle;
       DataChangeCallbackData data;
       data.Callback = callback;
-      ait->second.DataChangeCallbacks[handle] = data;
+      attrval->DataChangeCallbacks[handle] = data;
+      if ( !attrval->Delivery )
+      {
+        attrval->Delivery = std::make_shared<DataChangeDelivery>();
+      }
+      if ( attrval->Shared )
+      {
+        attrval->Shared->CallbacksCount = attrval->DataChangeCallbacks.size();
+      }
+      lock.unlock();
+
+      std::lock_guard<std::mutex> callbacksLock(CallbacksMutex);
       ClientIdToAttributeMap[handle] = NodeAttribute(node, attribute);
       return handle;
     }
@@ -272,22 +462,34 @@ namespace OpcUa
     {
       if (Debug) std::cout << "AddressSpaceInternal | Deleting callback with client id. " << serverhandle << std::endl;
 
-      ClientIdToAttributeMapType::iterator it = ClientIdToAttributeMap.find(serverhandle);
-      if ( it == ClientIdToAttributeMap.end() )
+      NodeAttribute nodeAttribute;
       {
-        std::cout << "AddressSpaceInternal | Error, request to delete a callback using unknown handle: " << serverhandle << std::endl;
-        return;
+        std::lock_guard<std::mutex> lock(CallbacksMutex);
+        ClientIdToAttributeMapType::iterator it = ClientIdToAttributeMap.find(serverhandle);
+        if ( it == ClientIdToAttributeMap.end() )
+        {
+          std::cout << "AddressSpaceInternal | Error, request to delete a callback using unknown handle: " << serverhandle << std::endl;
+          return;
+        }
+        nodeAttribute = it->second;
+        ClientIdToAttributeMap.erase(it);
       }
 
-      NodesMap::iterator nodeit = Nodes.find(it->second.Node);
-      if ( nodeit != Nodes.end() )
+      NodeShard& shard = GetShard(nodeAttribute.Node);
+      boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+
+      NodeStruct* node = shard.Nodes.Find(nodeAttribute.Node);
+      if ( node )
       {
-        AttributesMap::iterator ait = nodeit->second.Attributes.find(it->second.Attribute);
-        if ( ait != nodeit->second.Attributes.end() )
+        AttributeValue* attrval = node->FindAttribute(nodeAttribute.Attribute);
+        if ( attrval )
         {
-          size_t nb = ait->second.DataChangeCallbacks.erase(serverhandle);
+          size_t nb = attrval->DataChangeCallbacks.erase(serverhandle);
+          if ( attrval->Shared )
+          {
+            attrval->Shared->CallbacksCount = attrval->DataChangeCallbacks.size();
+          }
           if (Debug) std::cout << "AddressSpaceInternal | deleted " << nb << " callbacks" << std::endl;
-          ClientIdToAttributeMap.erase(serverhandle);
           return;
         }
       }
@@ -296,32 +498,72 @@ namespace OpcUa
 
     StatusCode AddressSpaceInMemory::SetValueCallback(const NodeId& node, AttributeId attribute, std::function<DataValue(void)> callback)
     {
-      NodesMap::iterator it = Nodes.find(node);
-      if ( it != Nodes.end() )
+      NodeShard& shard = GetShard(node);
+      boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+
+      NodeStruct* nodeStruct = shard.Nodes.Find(node);
+      if ( nodeStruct )
       {
-        AttributesMap::iterator ait = it->second.Attributes.find(attribute);
-        if ( ait != it->second.Attributes.end() )
+        AttributeValue* attrval = nodeStruct->FindAttribute(attribute);
+        if ( attrval )
         {
-          ait->second.GetValueCallback = callback;
+          attrval->GetValueCallback = callback;
           return StatusCode::Good;
         }
       }
       return StatusCode::BadAttributeIdInvalid;
     }
 
+    bool AddressSpaceInMemory::HasValueCallback(const NodeId& node, AttributeId attribute) const
+    {
+      const NodeShard& shard = GetShard(node);
+      boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+
+      const NodeStruct* nodeStruct = shard.Nodes.Find(node);
+      const AttributeValue* attrval = nodeStruct ? nodeStruct->FindAttribute(attribute) : nullptr;
+      return attrval && attrval->GetValueCallback;
+    }
+
     void AddressSpaceInMemory::SetMethod(const NodeId& node, std::function<std::vector<OpcUa::Variant> (NodeId context, std::vector<OpcUa::Variant> arguments)> callback)
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
+      NodeShard& shard = GetShard(node);
+      boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
 
-      NodesMap::iterator it = Nodes.find(node);
-      if ( it != Nodes.end() )
+      NodeStruct* nodeStruct = shard.Nodes.Find(node);
+      if ( nodeStruct )
       {
-        it->second.Method = callback;
+        nodeStruct->Method = callback;
       }
       else
         throw std::runtime_error("While setting node callback: node does not exist.");
     }
 
+    Server::ValueSlot::SharedPtr AddressSpaceInMemory::GetValueSlot(const NodeId& node, AttributeId attribute)
+    {
+      NodeShard& shard = GetShard(node);
+      boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+
+      NodeStruct* nodeStruct = shard.Nodes.Find(node);
+      if ( !nodeStruct )
+      {
+        throw std::runtime_error("AddressSpaceInternal | NodeId not found");
+      }
+      AttributeValue* attrval = nodeStruct->FindAttribute(attribute);
+      if ( !attrval )
+      {
+        throw std::runtime_error("Attribute not found");
+      }
+      if ( !attrval->Shared )
+      {
+        std::shared_ptr<SharedValue> shared = std::make_shared<SharedValue>();
+        shared->Current = std::make_shared<const DataValue>(attrval->Value);
+        shared->CallbacksCount = attrval->DataChangeCallbacks.size();
+        attrval->Shared = shared;
+        attrval->Value = DataValue();
+      }
+      return std::make_shared<AttributeValueSlot>(Owner, node, attribute, attrval->Shared);
+    }
+
     std::vector<OpcUa::CallMethodResult> AddressSpaceInMemory::Call(const std::vector<OpcUa::CallMethodRequest>& methodsToCall)
     {
       std::vector<OpcUa::CallMethodResult>  results;
@@ -334,22 +576,26 @@ namespace OpcUa
 
     CallMethodResult AddressSpaceInMemory::CallMethod(CallMethodRequest request)
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
       CallMethodResult result;
-      NodesMap::iterator node_it = Nodes.find(request.ObjectId);
-      if ( node_it == Nodes.end() )
+      if ( !HasNode(request.ObjectId) )
       {
         result.Status = StatusCode::BadNodeIdUnknown;
         return result;
       }
-      NodesMap::iterator method_it = Nodes.find(request.MethodId);
-      if ( method_it == Nodes.end() )
+
+      std::function<std::vector<OpcUa::Variant> (NodeId, std::vector<OpcUa::Variant>)> method;
       {
-        result.Status = StatusCode::BadNodeIdUnknown;
-        return result;
+        const NodeShard& shard = GetShard(request.MethodId);
+        boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+        const NodeStruct* methodNode = shard.Nodes.Find(request.MethodId);
+        if ( !methodNode )
+        {
+          result.Status = StatusCode::BadNodeIdUnknown;
+          return result;
+        }
+        method = methodNode->Method;
       }
-      if ( ! method_it->second.Method )
+      if ( ! method )
       {
         result.Status = StatusCode::BadNothingToDo;
         return result;
@@ -357,7 +603,7 @@ namespace OpcUa
       //FIXME: find a way to return more information about failure to client
       try
       {
-        result.OutputArguments = method_it->second.Method(node_it->first, request.InputArguments);
+        result.OutputArguments = method(request.ObjectId, request.InputArguments);
       }
       catch (std::exception& ex)
       {
@@ -375,24 +621,86 @@ namespace OpcUa
 
     StatusCode AddressSpaceInMemory::SetValue(const NodeId& node, AttributeId attribute, const DataValue& data)
     {
-      NodesMap::iterator it = Nodes.find(node);
-      if ( it != Nodes.end() )
+      DataValue value(data);
+      value.SetServerTimestamp(DateTime::Current());
+
+      DataChangeDelivery::Callbacks callbacks;
+      std::shared_ptr<DataChangeDelivery> delivery;
+      uint64_t version = 0;
       {
-        AttributesMap::iterator ait = it->second.Attributes.find(attribute);
-        if ( ait != it->second.Attributes.end() )
+        NodeShard& shard = GetShard(node);
+        boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+
+        NodeStruct* nodeStruct = shard.Nodes.Find(node);
+        AttributeValue* attrval = nodeStruct ? nodeStruct->FindAttribute(attribute) : nullptr;
+        if ( !attrval )
         {
-          DataValue value(data);
-          value.SetServerTimestamp(DateTime::Current());
-          ait->second.Value = value;
-          //call registered callback
-          for (auto pair : ait->second.DataChangeCallbacks)
+          return StatusCode::BadAttributeIdInvalid;
+        }
+        if ( attrval->Shared )
+        {
+          std::atomic_store(&attrval->Shared->Current, std::make_shared<const DataValue>(value));
+        }
+        else
+        {
+          attrval->Value = value;
+        }
+        if ( attrval->DataChangeCallbacks.empty() )
+        {
+          return StatusCode::Good;
+        }
+        version = ++attrval->Version;
+        delivery = attrval->Delivery;
+        callbacks.reserve(attrval->DataChangeCallbacks.size());
+        for (const auto& pair : attrval->DataChangeCallbacks)
+        {
+          callbacks.push_back(pair.second.Callback);
+        }
+      }
+
+      //call registered callback
+      delivery->Notify(node, attribute, version, value, std::move(callbacks));
+      return StatusCode::Good;
+    }
+
+    void DataChangeDelivery::Notify(const NodeId& node, AttributeId attribute, uint64_t version, const DataValue& value, Callbacks&& callbacks)
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      if ( version > Pending )
+      {
+        Pending = version;
+        PendingValue = value;
+        PendingCallbacks = std::move(callbacks);
+      }
+      if ( Delivering )
+      {
+        // Thread which delivers now sends the value as well, also when a callback writes the attribute again.
+        return;
+      }
+
+      Delivering = true;
+      while ( Pending > Delivered )
+      {
+        Delivered = Pending;
+        const DataValue current = std::move(PendingValue);
+        const Callbacks currentCallbacks = std::move(PendingCallbacks);
+        lock.unlock();
+        try
+        {
+          for (const auto& callback : currentCallbacks)
           {
-            pair.second.Callback(it->first, ait->first, ait->second.Value);
+            callback(node, attribute, current);
           }
-          return StatusCode::Good;
         }
+        catch (...)
+        {
+          lock.lock();
+          Delivering = false;
+          throw;
+        }
+        lock.lock();
       }
-      return StatusCode::BadAttributeIdInvalid;
+      Delivering = false;
     }
 
     bool AddressSpaceInMemory::IsSuitableReference(const BrowseDescription& desc, const ReferenceDescription& reference) const
@@ -434,10 +742,12 @@ namespace OpcUa
       std::vector<NodeId> subNodes;
       for ( NodeId nodeid: sourceNodes )
       {
-          NodesMap::const_iterator node_it = Nodes.find(nodeid);
-          if ( node_it != Nodes.end() )
+          const NodeShard& shard = GetShard(nodeid);
+          boost::shared_lock<boost::shared_mutex> lock(shard.Mutex);
+          const NodeStruct* node = shard.Nodes.Find(nodeid);
+          if ( node )
           {
-            for (auto& ref:  node_it->second.References )
+            for (auto& ref:  node->References )
             {
               subNodes.push_back(ref.TargetNodeId);
           }
@@ -460,43 +770,54 @@ namespace OpcUa
 
       const NodeId resultId = GetNewNodeId(item.RequestedNewNodeId);
 
-      if (!Nodes.empty() && resultId != ObjectId::Null && Nodes.find(resultId) != Nodes.end())
+      if (resultId != ObjectId::Null && HasNode(resultId))
       {
         std::cerr << "AddressSpaceInternal | Error: NodeId '"<< resultId << "' allready exist: " << std::endl;
         result.Status = StatusCode::BadNodeIdExists;
         return result;
       }
 
-      NodesMap::iterator parent_node_it = Nodes.end();
-      if (item.ParentNodeId != NodeId())
+      const bool hasParent = item.ParentNodeId != NodeId();
+      if (hasParent && !HasNode(item.ParentNodeId))
       {
-        parent_node_it = Nodes.find(item.ParentNodeId);
-        if ( parent_node_it == Nodes.end() )
-        {
-          if (Debug) std::cout << "AddressSpaceInternal | Error: Parent node '"<< item.ParentNodeId << "'does not exist" << std::endl;
-          result.Status = StatusCode::BadParentNodeIdInvalid;
-          return result;
-        }
+        if (Debug) std::cout << "AddressSpaceInternal | Error: Parent node '"<< item.ParentNodeId << "'does not exist" << std::endl;
+        result.Status = StatusCode::BadParentNodeIdInvalid;
+        return result;
       }
 
       NodeStruct nodestruct;
+      nodestruct.Id = resultId;
       //Add Common attributes
-      nodestruct.Attributes[AttributeId::NodeId].Value = resultId;
-      nodestruct.Attributes[AttributeId::BrowseName].Value = item.BrowseName;
-      nodestruct.Attributes[AttributeId::NodeClass].Value = static_cast<int32_t>(item.Class);
+      nodestruct.AddAttribute(AttributeId::NodeId)->Value = resultId;
+      nodestruct.AddAttribute(AttributeId::BrowseName)->Value = item.BrowseName;
+      nodestruct.AddAttribute(AttributeId::NodeClass)->Value = static_cast<int32_t>(item.Class);
 
       // Add requested attributes
       for (const auto& attr: item.Attributes.Attributes)
       {
-        AttributeValue attval;
-        attval.Value = attr.second;
-
-        nodestruct.Attributes.insert(std::make_pair(attr.first, attval));
+        if (nodestruct.FindAttribute(attr.first))
+        {
+          continue;
+        }
+        if (AttributeValue* attval = nodestruct.AddAttribute(attr.first))
+        {
+          attval->Value = attr.second;
+        }
       }
 
-      Nodes.insert(std::make_pair(resultId, nodestruct));
+      {
+        NodeShard& shard = GetShard(resultId);
+        boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+        // Node with the same id could be added by other thread in the meantime.
+        if (shard.Nodes.Find(resultId))
+        {
+          result.Status = StatusCode::BadNodeIdExists;
+          return result;
+        }
+        shard.Nodes.Insert(std::move(nodestruct));
+      }
 
-      if (parent_node_it != Nodes.end())
+      if (hasParent)
       {
         // Link to parent
         ReferenceDescription desc;
@@ -508,7 +829,10 @@ namespace OpcUa
         desc.TargetNodeTypeDefinition = item.TypeDefinition;
         desc.IsForward = true; // should this be in constructor?
 
-        parent_node_it->second.References.push_back(desc);
+        // Nodes are never removed, parent still exists.
+        NodeShard& shard = GetShard(item.ParentNodeId);
+        boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+        shard.Nodes.Find(item.ParentNodeId)->References.push_back(desc);
       }
 
       if (item.TypeDefinition != ObjectId::Null)
@@ -531,13 +855,11 @@ namespace OpcUa
 
     StatusCode AddressSpaceInMemory::AddReference(const AddReferencesItem& item)
     {
-      NodesMap::iterator node_it = Nodes.find(item.SourceNodeId);
-      if ( node_it == Nodes.end() )
+      if ( !HasNode(item.SourceNodeId) )
       {
         return StatusCode::BadSourceNodeIdInvalid;
       }
-      NodesMap::iterator targetnode_it = Nodes.find(item.TargetNodeId);
-      if ( targetnode_it == Nodes.end() )
+      if ( !HasNode(item.TargetNodeId) )
       {
         return StatusCode::BadTargetNodeIdInvalid;
       }
@@ -564,7 +886,10 @@ namespace OpcUa
       {
         desc.DisplayName = LocalizedText(desc.BrowseName.Name);
       }
-      node_it->second.References.push_back(desc);
+
+      NodeShard& shard = GetShard(item.SourceNodeId);
+      boost::unique_lock<boost::shared_mutex> lock(shard.Mutex);
+      shard.Nodes.Find(item.SourceNodeId)->References.push_back(desc);
       return StatusCode::Good;
     }
 
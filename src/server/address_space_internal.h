@@ -20,10 +20,13 @@
 
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <atomic>
 #include <ctime>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <deque>
 #include <set>
@@ -56,25 +59,117 @@ namespace OpcUa
 
     typedef std::map<uint32_t, DataChangeCallbackData> DataChangeCallbackMap;
 
+    //Value of an attribute which is updated through a value slot.
+    //Value is replaced as a whole, it is read and written only with std::atomic_load/std::atomic_store.
+    struct SharedValue
+    {
+      std::shared_ptr<const DataValue> Current;
+      //Number of data change callbacks of the attribute, allows slot to skip callbacks lookup.
+      std::atomic<std::size_t> CallbacksCount;
+
+      SharedValue() : CallbacksCount(0) {}
+    };
+
+    //Data change notifications of an attribute, delivered after the shard lock is released.
+    //Writes are stamped with a version under the shard lock; a thread delivers
+    //pending versions in order and values overtaken by a newer one are skipped.
+    struct DataChangeDelivery
+    {
+      typedef std::vector<std::function<Server::DataChangeCallback>> Callbacks;
+
+      void Notify(const NodeId& node, AttributeId attribute, uint64_t version, const DataValue& value, Callbacks&& callbacks);
+
+    private:
+      std::mutex Mutex;
+      bool Delivering = false;
+      uint64_t Delivered = 0;
+      uint64_t Pending = 0;
+      DataValue PendingValue;
+      Callbacks PendingCallbacks;
+    };
+
     //Store an attribute value together with a link to all its suscriptions
     struct AttributeValue
     {
       DataValue Value;
       DataChangeCallbackMap DataChangeCallbacks;
       std::function<DataValue(void)> GetValueCallback;
+      //Set when a value slot is requested for the attribute, holds the value instead of Value since then.
+      std::shared_ptr<SharedValue> Shared;
+      //Version of the last write which notified data change callbacks.
+      uint64_t Version = 0;
+      //Created with the first data change callback.
+      std::shared_ptr<DataChangeDelivery> Delivery;
     };
 
-    typedef std::map<AttributeId, AttributeValue> AttributesMap;
-
     //Store all data related to a Node
     struct NodeStruct
     {
-      AttributesMap Attributes;
+      NodeId Id;
       std::vector<ReferenceDescription> References;
       std::function<std::vector<OpcUa::Variant> (NodeId, std::vector<OpcUa::Variant>)> Method;
+
+      /// @brief Find attribute of the node.
+      /// @return nullptr if node has not such attribute.
+      AttributeValue* FindAttribute(AttributeId attribute);
+      const AttributeValue* FindAttribute(AttributeId attribute) const;
+
+      /// @brief Add attribute if it does not exist yet.
+      /// @return existing or added attribute, nullptr if attribute id is out of range.
+      AttributeValue* AddAttribute(AttributeId attribute);
+
+    private:
+      static const std::size_t MaxAttributeId = static_cast<std::size_t>(AttributeId::UserExecutable);
+
+      // Position+1 of every attribute in Attributes, 0 if node has not such attribute.
+      uint8_t AttributeSlots[MaxAttributeId + 1] = {};
+      std::vector<AttributeValue> Attributes;
+    };
+
+    /// @brief Storage of nodes of the address space.
+    /// Nodes are stored densely and never move, lookup by node id is done
+    /// through an open addressing hash index with linear probing.
+    class NodeStore
+    {
+      public:
+        NodeStruct* Find(const NodeId& id);
+        const NodeStruct* Find(const NodeId& id) const;
+
+        /// @brief Insert new node. Node id must not exist in the store.
+        /// @return inserted node.
+        NodeStruct* Insert(NodeStruct&& node);
+
+        bool Empty() const { return Nodes.empty(); }
+        std::size_t Size() const { return Nodes.size(); }
+
+        /// @brief Well mixed hash of node id.
+        static uint32_t Hash(const NodeId& id);
+
+      private:
+        struct IndexEntry
+        {
+          uint32_t Hash = 0;
+          // Position+1 of the node in Nodes, 0 for empty entry.
+          uint32_t Slot = 0;
+        };
+
+        std::size_t FindEntry(const NodeId& id, uint32_t hash) const;
+        void Rehash(std::size_t capacity);
+
+      private:
+        std::deque<NodeStruct> Nodes;
+        std::vector<IndexEntry> Index;
     };
 
-    typedef std::map<NodeId, NodeStruct> NodesMap;
+    class AttributeValueSlot;
+    class AddressSpaceInMemory;
+
+    //Link of value slots to the address space, cleared when the address space is destroyed.
+    struct SlotOwner
+    {
+      boost::shared_mutex Mutex;
+      AddressSpaceInMemory* AddressSpace = nullptr;
+    };
 
     //In memory storage of server opc-ua data model
     class AddressSpaceInMemory : public Server::AddressSpace
@@ -107,10 +202,14 @@ namespace OpcUa
 
         /// @brief Set callback which will be called to read new value of the attribue.
         StatusCode SetValueCallback(const NodeId& node, AttributeId attribute, std::function<DataValue(void)> callback);
+        bool HasValueCallback(const NodeId& node, AttributeId attribute) const;
 
         /// @brief Set method function for a method node.
         void SetMethod(const NodeId& node, std::function<std::vector<OpcUa::Variant> (NodeId context, std::vector<OpcUa::Variant> arguments)> callback);
 
+        /// @brief Get value slot for high rate updates of the attribute.
+        Server::ValueSlot::SharedPtr GetValueSlot(const NodeId& node, AttributeId attribute);
+
       private:
         std::tuple<bool, NodeId> FindElementInNode(const NodeId& nodeid, const RelativePathElement& element) const;
         BrowsePathResult TranslateBrowsePath(const BrowsePath& browsepath) const;
@@ -124,14 +223,32 @@ namespace OpcUa
         NodeId GetNewNodeId(const NodeId& id);
         CallMethodResult CallMethod(CallMethodRequest method);
 
+        //Nodes are distributed over shards by hash of node id, every shard has its own lock.
+        //A thread never holds locks of two shards at once, callbacks are called without any lock held.
+        //Data change callbacks of an attribute are still called in order of writes, see DataChangeDelivery.
+        struct NodeShard
+        {
+          mutable boost::shared_mutex Mutex;
+          NodeStore Nodes;
+        };
+
+        NodeShard& GetShard(const NodeId& node);
+        const NodeShard& GetShard(const NodeId& node) const;
+        bool HasNode(const NodeId& node) const;
+
       private:
+        static const std::size_t ShardBits = 4;
+
         bool Debug = false;
-        mutable boost::shared_mutex DbMutex;
-        NodesMap Nodes;
+        NodeShard Shards[1 << ShardBits];
+        std::mutex CallbacksMutex;
         ClientIdToAttributeMapType ClientIdToAttributeMap; //Use to find callback using callback subcsriptionid
-        uint32_t MaxNodeIdNum = 2000;
+        std::atomic<uint32_t> MaxNodeIdNum;
         uint32_t DefaultIdx = 2;
         std::atomic<uint32_t> DataChangeCallbackHandle;
+        std::shared_ptr<SlotOwner> Owner;
+
+        friend class AttributeValueSlot;
     };
   }
 
@@ -19,8 +19,11 @@
 
 #include <opc/ua/server/addons/asio_addon.h>
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 namespace
@@ -29,20 +32,28 @@ namespace
   {
   public:
     AsioAddonImpl()
-      : Work(IoService)
     {
+      AddIoService();
     }
 
-
     void Initialize(Common::AddonsManager&, const Common::AddonParameters& params) override
     {
-      const unsigned threadsNumber = GetThreadsNumber(params);
+      const unsigned threadsNumber = std::max(1u, GetThreadsNumber(params));
+      // Either every thread runs its own io_service or all threads share one.
+      const unsigned servicesNumber = IsIoServicePerThread(params) ? threadsNumber : 1;
+      while (IoServices.size() < servicesNumber)
+      {
+        AddIoService();
+      }
+      ConnectionsCount.assign(IoServices.size(), 0);
+
       //std::cout << "asio| Starting " << threadsNumber << "threads." << std::endl;
       for (unsigned i = 0; i < threadsNumber; ++i)
       {
-        Threads.emplace_back([this, i](){
+        boost::asio::io_service& io = *IoServices[i % servicesNumber];
+        Threads.emplace_back([&io, i](){
           //std::cout << "asio| Starting thread " << i << "." << std::endl;
-          IoService.run();
+          io.run();
           //std::cout << "asio| Thread " << i << "exited." << std::endl;
         });
       }
@@ -51,7 +62,10 @@ namespace
     void Stop() override
     {
       //std::cout << "asio| stopping io service." << std::endl;
-      IoService.stop();
+      for (const std::unique_ptr<boost::asio::io_service>& io : IoServices)
+      {
+        io->stop();
+      }
       //std::cout << "asio| joining threads." << std::endl;
       std::for_each(Threads.begin(), Threads.end(), [](std::thread& thread){
         thread.join();
@@ -60,7 +74,28 @@ namespace
 
     virtual boost::asio::io_service& GetIoService() override
     {
-      return IoService;
+      return *IoServices.front();
+    }
+
+    virtual boost::asio::io_service& GetConnectionIoService() override
+    {
+      std::unique_lock<std::mutex> lock(ConnectionsMutex);
+      const std::size_t index = std::min_element(ConnectionsCount.begin(), ConnectionsCount.end()) - ConnectionsCount.begin();
+      ++ConnectionsCount[index];
+      return *IoServices[index];
+    }
+
+    virtual void ReleaseConnectionIoService(boost::asio::io_service& io) override
+    {
+      std::unique_lock<std::mutex> lock(ConnectionsMutex);
+      for (std::size_t i = 0; i < IoServices.size(); ++i)
+      {
+        if (IoServices[i].get() == &io && ConnectionsCount[i] > 0)
+        {
+          --ConnectionsCount[i];
+          return;
+        }
+      }
     }
 
   unsigned GetThreadsNumber(const Common::AddonParameters& params) const
@@ -77,10 +112,31 @@ namespace
     return num;
   }
 
+  void AddIoService()
+  {
+    IoServices.emplace_back(new boost::asio::io_service);
+    Works.emplace_back(new boost::asio::io_service::work(*IoServices.back()));
+  }
+
+  bool IsIoServicePerThread(const Common::AddonParameters& params) const
+  {
+    for (auto paramIt : params.Parameters)
+    {
+      if (paramIt.Name == "io_service_per_thread")
+      {
+        return !paramIt.Value.empty() && paramIt.Value != "0" && paramIt.Value != "false";
+      }
+    }
+    return false;
+  }
+
   private:
-    boost::asio::io_service IoService;
-    boost::asio::io_service::work Work;
+    std::vector<std::unique_ptr<boost::asio::io_service>> IoServices;
+    std::vector<std::unique_ptr<boost::asio::io_service::work>> Works;
     std::vector<std::thread> Threads;
+    // Connections run by every io_service.
+    std::mutex ConnectionsMutex;
+    std::vector<unsigned> ConnectionsCount;
   };
 }
 
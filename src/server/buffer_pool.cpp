@@ -0,0 +1,75 @@
+/// @brief Pool of memory buffers.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include "buffer_pool.h"
+
+#include <algorithm>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    BufferPool::BufferPool(std::size_t minSize, std::size_t maxSize, std::size_t maxFree)
+      : MaxFree(maxFree)
+    {
+      std::size_t size = 1;
+      while (size < minSize)
+      {
+        size *= 2;
+      }
+      for (; size <= maxSize; size *= 2)
+      {
+        Sizes.push_back(size);
+      }
+      Free.resize(Sizes.size());
+    }
+
+    std::size_t BufferPool::ClassOf(std::size_t size) const
+    {
+      return std::lower_bound(Sizes.begin(), Sizes.end(), size) - Sizes.begin();
+    }
+
+    std::vector<char> BufferPool::Acquire(std::size_t size)
+    {
+      const std::size_t index = ClassOf(size);
+      if (index == Sizes.size())
+      {
+        return std::vector<char>(size);
+      }
+
+      {
+        std::unique_lock<std::mutex> lock(Mutex);
+        if (!Free[index].empty())
+        {
+          std::vector<char> buffer = std::move(Free[index].back());
+          Free[index].pop_back();
+          return buffer;
+        }
+      }
+      return std::vector<char>(Sizes[index]);
+    }
+
+    void BufferPool::Release(std::vector<char>&& buffer)
+    {
+      const std::size_t index = ClassOf(buffer.size());
+      if (index == Sizes.size() || Sizes[index] != buffer.size())
+      {
+        return;
+      }
+
+      std::vector<char> released = std::move(buffer);
+      std::unique_lock<std::mutex> lock(Mutex);
+      if (Free[index].size() < MaxFree)
+      {
+        Free[index].push_back(std::move(released));
+      }
+    }
+
+  }
+}
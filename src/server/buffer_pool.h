@@ -0,0 +1,47 @@
+/// @brief Pool of memory buffers.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    /// @brief Buffers of power of two sizes shared by connections.
+    /// A buffer is taken with the smallest size class which fits the requested
+    /// size and given back when it is not needed any more. Buffers larger than
+    /// the largest class are allocated and released as usual.
+    class BufferPool
+    {
+      public:
+        /// @param minSize size of the smallest class, rounded up to power of two.
+        /// @param maxSize size of the largest class.
+        /// @param maxFree number of free buffers kept in every class.
+        BufferPool(std::size_t minSize, std::size_t maxSize, std::size_t maxFree);
+
+        /// @brief Buffer with size of the class for 'size' bytes or with 'size' bytes if it is larger than all classes.
+        std::vector<char> Acquire(std::size_t size);
+        /// @brief Give buffer back for reuse, buffers not taken from the pool are released.
+        void Release(std::vector<char>&& buffer);
+
+      private:
+        std::size_t ClassOf(std::size_t size) const;
+
+      private:
+        const std::size_t MaxFree;
+        std::vector<std::size_t> Sizes;
+        std::mutex Mutex;
+        std::vector<std::vector<std::vector<char>>> Free; // per class
+    };
+
+  }
+}
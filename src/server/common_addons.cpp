@@ -114,6 +114,7 @@ namespace
 
     Common::ParametersGroup async("async");
     async.Parameters.push_back(Common::Parameter("threads", std::to_string(serverParams.ThreadsCount)));
+    async.Parameters.push_back(Common::Parameter("io_service_per_thread", std::to_string(serverParams.IoServicePerThread)));
     async.Parameters.push_back(debugMode);
     addons.Groups.push_back(async);
 
@@ -131,6 +132,7 @@ namespace
 
     Common::ParametersGroup opc_tcp(OpcUa::Server::AsyncOpcTcpAddonId);
     opc_tcp.Parameters.push_back(debugMode);
+    opc_tcp.Parameters.push_back(Common::Parameter("service_threads", std::to_string(serverParams.ServiceThreadsCount)));
     OpcUa::Server::ApplicationData applicationData;
     applicationData.Application = serverParams.Endpoint.Server;
     applicationData.Endpoints.push_back(serverParams.Endpoint);
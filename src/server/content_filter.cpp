@@ -0,0 +1,444 @@
+/// @brief Evaluation of event filters.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include "content_filter.h"
+
+#include <algorithm>
+
+namespace
+{
+  using namespace OpcUa;
+
+  // Limit of a where clause, every element is evaluated once for every event.
+  const std::size_t MaxFilterElements = 1024;
+
+  const Variant& NullValue()
+  {
+    static const Variant value;
+    return value;
+  }
+
+  const Variant& BooleanValue(bool value)
+  {
+    static const Variant trueValue(true);
+    static const Variant falseValue(false);
+    return value ? trueValue : falseValue;
+  }
+
+  bool ToNumber(const Variant& value, double& number)
+  {
+    if (value.IsNul() || value.IsArray())
+    {
+      return false;
+    }
+    switch (value.Type())
+    {
+      case VariantType::BOOLEAN: number = value.As<bool>() ? 1 : 0; return true;
+      case VariantType::SBYTE: number = value.As<int8_t>(); return true;
+      case VariantType::BYTE: number = value.As<uint8_t>(); return true;
+      case VariantType::INT16: number = value.As<int16_t>(); return true;
+      case VariantType::UINT16: number = value.As<uint16_t>(); return true;
+      case VariantType::INT32: number = value.As<int32_t>(); return true;
+      case VariantType::UINT32: number = value.As<uint32_t>(); return true;
+      case VariantType::INT64: number = static_cast<double>(value.As<int64_t>()); return true;
+      case VariantType::UINT64: number = static_cast<double>(value.As<uint64_t>()); return true;
+      case VariantType::FLOAT: number = value.As<float>(); return true;
+      case VariantType::DOUBLE: number = value.As<double>(); return true;
+      default: return false;
+    }
+  }
+
+  // Order of two values, false if they can not be ordered.
+  bool Compare(const Variant& left, const Variant& right, int& result)
+  {
+    double leftNumber = 0;
+    double rightNumber = 0;
+    if (ToNumber(left, leftNumber) && ToNumber(right, rightNumber))
+    {
+      result = leftNumber < rightNumber ? -1 : (rightNumber < leftNumber ? 1 : 0);
+      return true;
+    }
+    if (left.Type() == VariantType::DATE_TIME && right.Type() == VariantType::DATE_TIME && left.IsScalar() && right.IsScalar())
+    {
+      const int64_t leftTime = left.As<DateTime>().Value;
+      const int64_t rightTime = right.As<DateTime>().Value;
+      result = leftTime < rightTime ? -1 : (rightTime < leftTime ? 1 : 0);
+      return true;
+    }
+    return false;
+  }
+
+  bool IsEqual(const Variant& left, const Variant& right)
+  {
+    int order = 0;
+    if (Compare(left, right, order))
+    {
+      return order == 0;
+    }
+    return !left.IsNul() && left == right;
+  }
+
+  bool CheckOperandCount(FilterOperator op, std::size_t count, StatusCode& status)
+  {
+    switch (op)
+    {
+      case FilterOperator::Equals:
+      case FilterOperator::GreaterThan:
+      case FilterOperator::LessThan:
+      case FilterOperator::GreaterThanOrEqual:
+      case FilterOperator::LessThanOrEqual:
+      case FilterOperator::And:
+      case FilterOperator::Or:
+        status = count == 2 ? StatusCode::Good : StatusCode::BadFilterOperandCountMismatch;
+        return true;
+      case FilterOperator::IsNull:
+      case FilterOperator::Not:
+      case FilterOperator::OfType:
+        status = count == 1 ? StatusCode::Good : StatusCode::BadFilterOperandCountMismatch;
+        return true;
+      case FilterOperator::Between:
+        status = count == 3 ? StatusCode::Good : StatusCode::BadFilterOperandCountMismatch;
+        return true;
+      case FilterOperator::InList:
+        status = count >= 2 ? StatusCode::Good : StatusCode::BadFilterOperandCountMismatch;
+        return true;
+      case FilterOperator::Like:
+      case FilterOperator::Cast:
+      case FilterOperator::InView:
+      case FilterOperator::RelatedTo:
+      case FilterOperator::BitwiseAnd:
+      case FilterOperator::BitwiseOr:
+        status = StatusCode::BadFilterOperatorUnsupported;
+        return false;
+      default:
+        status = StatusCode::BadFilterOperatorInvalid;
+        return false;
+    }
+  }
+
+  void AddSubtypes(const NodeId& type, Server::AddressSpace& addressSpace, std::vector<NodeId>& types)
+  {
+    if (std::find(types.begin(), types.end(), type) != types.end())
+    {
+      return;
+    }
+    types.push_back(type);
+
+    BrowseDescription description;
+    description.NodeToBrowse = type;
+    description.Direction = BrowseDirection::Forward;
+    description.ReferenceTypeId = ObjectId::HasSubtype;
+    description.IncludeSubtypes = true;
+    description.ResultMask = BrowseResultMask::All;
+    NodesQuery query;
+    query.NodesToBrowse.push_back(description);
+    for (const BrowseResult& result : addressSpace.Browse(query))
+    {
+      for (const ReferenceDescription& reference : result.Referencies)
+      {
+        AddSubtypes(reference.TargetNodeId, addressSpace, types);
+      }
+    }
+  }
+}
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    EventField::EventField()
+      : Field(Kind::Null)
+      , Attribute(AttributeId::Unknown)
+    {
+    }
+
+    EventField::EventField(const SimpleAttributeOperand& operand)
+      : Field(Kind::Path)
+      , Path(operand.BrowsePath)
+      , Attribute(operand.Attribute)
+    {
+      if (Path.empty())
+      {
+        Field = Kind::Attribute;
+        return;
+      }
+      if (Path.size() != 1 || Path[0].NamespaceIndex != 0)
+      {
+        return;
+      }
+
+      static const struct
+      {
+        const char* Name;
+        Kind Field;
+      } standardFields[] =
+      {
+        {"EventId", Kind::EventId},
+        {"EventType", Kind::EventType},
+        {"SourceNode", Kind::SourceNode},
+        {"SourceName", Kind::SourceName},
+        {"Message", Kind::Message},
+        {"Severity", Kind::Severity},
+        {"LocalTime", Kind::LocalTime},
+        {"ReceiveTime", Kind::ReceiveTime},
+        {"Time", Kind::Time},
+      };
+      for (const auto& standard : standardFields)
+      {
+        if (Path[0].Name == standard.Name)
+        {
+          Field = standard.Field;
+          return;
+        }
+      }
+    }
+
+    const Variant& EventField::Get(const Event& event, Variant& buffer) const
+    {
+      switch (Field)
+      {
+        case Kind::EventId: buffer = event.EventId; return buffer;
+        case Kind::EventType: buffer = event.EventType; return buffer;
+        case Kind::SourceNode: buffer = event.SourceNode; return buffer;
+        case Kind::SourceName: buffer = event.SourceName; return buffer;
+        case Kind::Message: buffer = event.Message; return buffer;
+        case Kind::Severity: buffer = event.Severity; return buffer;
+        case Kind::LocalTime: buffer = event.LocalTime; return buffer;
+        case Kind::ReceiveTime: buffer = event.ReceiveTime; return buffer;
+        case Kind::Time: buffer = event.Time; return buffer;
+        case Kind::Path:
+        {
+          const Variant* value = event.FindValue(Path);
+          return value ? *value : NullValue();
+        }
+        case Kind::Attribute:
+        {
+          const Variant* value = event.FindValue(Attribute);
+          return value ? *value : NullValue();
+        }
+        default:
+          return NullValue();
+      }
+    }
+
+    void EventSelector::Compile(const std::vector<SimpleAttributeOperand>& clauses)
+    {
+      Fields.clear();
+      Fields.reserve(clauses.size());
+      for (const SimpleAttributeOperand& clause : clauses)
+      {
+        Fields.push_back(EventField(clause));
+      }
+    }
+
+    std::vector<Variant> EventSelector::Select(const Event& event) const
+    {
+      std::vector<Variant> values;
+      values.reserve(Fields.size());
+      for (const EventField& field : Fields)
+      {
+        Variant buffer;
+        const Variant& value = field.Get(event, buffer);
+        if (&value == &buffer)
+        {
+          values.push_back(std::move(buffer));
+        }
+        else
+        {
+          values.push_back(value);
+        }
+      }
+      return values;
+    }
+
+    StatusCode ContentFilterEvaluator::Compile(const std::vector<ContentFilterElement>& elements, Server::AddressSpace& addressSpace)
+    {
+      Instructions.clear();
+      Operands.clear();
+      Literals.clear();
+      Fields.clear();
+      Buffers.clear();
+      TypeSets.clear();
+
+      if (elements.size() > MaxFilterElements)
+      {
+        return StatusCode::BadContentFilterInvalid;
+      }
+
+      for (uint32_t i = 0; i < elements.size(); ++i)
+      {
+        const ContentFilterElement& element = elements[i];
+        StatusCode status = StatusCode::Good;
+        if (!CheckOperandCount(element.Operator, element.FilterOperands.size(), status) || status != StatusCode::Good)
+        {
+          Instructions.clear();
+          return status;
+        }
+
+        Instruction instruction;
+        instruction.Operator = element.Operator;
+        instruction.FirstOperand = Operands.size();
+        instruction.OperandCount = element.FilterOperands.size();
+        instruction.TypeSet = 0;
+        for (const FilterOperand& operand : element.FilterOperands)
+        {
+          status = CompileOperand(operand, i, elements.size());
+          if (status != StatusCode::Good)
+          {
+            Instructions.clear();
+            return status;
+          }
+        }
+
+        if (element.Operator == FilterOperator::OfType)
+        {
+          const Operand& type = Operands[instruction.FirstOperand];
+          if (type.Type != OperandType::Literal || Literals[type.Index].Type() != VariantType::NODE_Id || !Literals[type.Index].IsScalar())
+          {
+            Instructions.clear();
+            return StatusCode::BadFilterOperandInvalid;
+          }
+          std::vector<NodeId> types;
+          AddSubtypes(Literals[type.Index].As<NodeId>(), addressSpace, types);
+          std::sort(types.begin(), types.end());
+          instruction.TypeSet = TypeSets.size();
+          TypeSets.push_back(std::move(types));
+        }
+        Instructions.push_back(instruction);
+      }
+
+      Buffers.resize(Fields.size());
+      Results.assign(Instructions.size(), 0);
+      return StatusCode::Good;
+    }
+
+    StatusCode ContentFilterEvaluator::CompileOperand(const FilterOperand& operand, uint32_t element, uint32_t elementCount)
+    {
+      Operand compiled;
+      if (operand.Header.TypeId == ExpandedObjectId::ElementOperand)
+      {
+        // Elements may only refer to elements after them, so evaluation can not loop.
+        if (operand.Element.Index <= element || operand.Element.Index >= elementCount)
+        {
+          return StatusCode::BadFilterOperandInvalid;
+        }
+        compiled.Type = OperandType::Element;
+        compiled.Index = operand.Element.Index;
+      }
+      else if (operand.Header.TypeId == ExpandedObjectId::LiteralOperand)
+      {
+        compiled.Type = OperandType::Literal;
+        compiled.Index = Literals.size();
+        Literals.push_back(operand.Literal.Value);
+      }
+      else if (operand.Header.TypeId == ExpandedObjectId::SimpleAttributeOperand)
+      {
+        compiled.Type = OperandType::Field;
+        compiled.Index = Fields.size();
+        Fields.push_back(EventField(operand.SimpleAttribute));
+      }
+      else
+      {
+        return StatusCode::BadFilterOperandInvalid;
+      }
+      Operands.push_back(compiled);
+      return StatusCode::Good;
+    }
+
+    bool ContentFilterEvaluator::Match(const Event& event) const
+    {
+      // Elements refer only to elements after them, so walking backwards every
+      // operand element is already evaluated. Shared elements are evaluated once.
+      for (uint32_t i = Instructions.size(); i-- > 0;)
+      {
+        Results[i] = Evaluate(i, event);
+      }
+      return Instructions.empty() || Results[0];
+    }
+
+    bool ContentFilterEvaluator::Evaluate(uint32_t element, const Event& event) const
+    {
+      const Instruction& instruction = Instructions[element];
+      const Operand* operands = &Operands[instruction.FirstOperand];
+      int order = 0;
+      switch (instruction.Operator)
+      {
+        case FilterOperator::Equals:
+          return IsEqual(GetValue(operands[0], event), GetValue(operands[1], event));
+        case FilterOperator::IsNull:
+          return GetValue(operands[0], event).IsNul();
+        case FilterOperator::GreaterThan:
+          return Compare(GetValue(operands[0], event), GetValue(operands[1], event), order) && order > 0;
+        case FilterOperator::LessThan:
+          return Compare(GetValue(operands[0], event), GetValue(operands[1], event), order) && order < 0;
+        case FilterOperator::GreaterThanOrEqual:
+          return Compare(GetValue(operands[0], event), GetValue(operands[1], event), order) && order >= 0;
+        case FilterOperator::LessThanOrEqual:
+          return Compare(GetValue(operands[0], event), GetValue(operands[1], event), order) && order <= 0;
+        case FilterOperator::Not:
+          return !IsTrue(operands[0], event);
+        case FilterOperator::Between:
+        {
+          const Variant& value = GetValue(operands[0], event);
+          return Compare(value, GetValue(operands[1], event), order) && order >= 0
+              && Compare(value, GetValue(operands[2], event), order) && order <= 0;
+        }
+        case FilterOperator::InList:
+        {
+          const Variant& value = GetValue(operands[0], event);
+          for (uint32_t i = 1; i < instruction.OperandCount; ++i)
+          {
+            if (IsEqual(value, GetValue(operands[i], event)))
+            {
+              return true;
+            }
+          }
+          return false;
+        }
+        case FilterOperator::And:
+          return IsTrue(operands[0], event) && IsTrue(operands[1], event);
+        case FilterOperator::Or:
+          return IsTrue(operands[0], event) || IsTrue(operands[1], event);
+        case FilterOperator::OfType:
+        {
+          const std::vector<NodeId>& types = TypeSets[instruction.TypeSet];
+          return std::binary_search(types.begin(), types.end(), event.EventType);
+        }
+        default:
+          return false;
+      }
+    }
+
+    bool ContentFilterEvaluator::IsTrue(const Operand& operand, const Event& event) const
+    {
+      if (operand.Type == OperandType::Element)
+      {
+        return Results[operand.Index] != 0;
+      }
+      const Variant& value = GetValue(operand, event);
+      return value.Type() == VariantType::BOOLEAN && value.IsScalar() && value.As<bool>();
+    }
+
+    const Variant& ContentFilterEvaluator::GetValue(const Operand& operand, const Event& event) const
+    {
+      switch (operand.Type)
+      {
+        case OperandType::Element:
+          return BooleanValue(Results[operand.Index] != 0);
+        case OperandType::Literal:
+          return Literals[operand.Index];
+        case OperandType::Field:
+          return Fields[operand.Index].Get(event, Buffers[operand.Index]);
+        default:
+          return NullValue();
+      }
+    }
+
+  }
+}
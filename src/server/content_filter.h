@@ -0,0 +1,125 @@
+/// @brief Evaluation of event filters.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#pragma once
+
+#include <opc/ua/event.h>
+#include <opc/ua/protocol/monitored_items.h>
+#include <opc/ua/server/address_space.h>
+
+#include <vector>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    /// @brief Field of an event selected by a SimpleAttributeOperand.
+    /// The operand is resolved once, standard fields of BaseEventType are
+    /// then read from the event members without comparing browse names.
+    class EventField
+    {
+      public:
+        EventField();
+        explicit EventField(const SimpleAttributeOperand& operand);
+
+        /// @brief Value of the field in the event.
+        /// Standard fields are assigned to 'buffer', which keeps its memory between events.
+        const Variant& Get(const Event& event, Variant& buffer) const;
+
+      private:
+        enum class Kind
+        {
+          Null,
+          EventId,
+          EventType,
+          SourceNode,
+          SourceName,
+          Message,
+          Severity,
+          LocalTime,
+          ReceiveTime,
+          Time,
+          Path,
+          Attribute,
+        };
+
+        Kind Field;
+        std::vector<QualifiedName> Path;
+        AttributeId Attribute;
+    };
+
+    /// @brief SelectClauses of an event filter resolved to event fields.
+    class EventSelector
+    {
+      public:
+        void Compile(const std::vector<SimpleAttributeOperand>& clauses);
+
+        /// @brief Values of the selected fields in order of the select clauses.
+        std::vector<Variant> Select(const Event& event) const;
+
+      private:
+        std::vector<EventField> Fields;
+    };
+
+    /// @brief WhereClause of an event filter compiled into a flat array of instructions.
+    /// Instructions are evaluated once per event from the last one to the first one,
+    /// so cost is linear in number of elements even if elements share operands.
+    /// Operands are resolved at compile time, matching an event does not allocate memory
+    /// once buffers of event fields have grown to the size of the values.
+    /// Not thread safe: buffers are shared by all calls of Match.
+    class ContentFilterEvaluator
+    {
+      public:
+        /// @brief Compile the content filter, subtypes of OfType operands are taken from 'addressSpace'.
+        /// @return Good or status of the first invalid element, BadContentFilterInvalid
+        /// if the filter has too many elements.
+        StatusCode Compile(const std::vector<ContentFilterElement>& elements, Server::AddressSpace& addressSpace);
+
+        /// @brief Check the event against the filter, an empty filter matches every event.
+        bool Match(const Event& event) const;
+
+      private:
+        enum class OperandType
+        {
+          Element,
+          Literal,
+          Field,
+        };
+
+        struct Operand
+        {
+          OperandType Type;
+          uint32_t Index; // in Instructions, Literals or Fields
+        };
+
+        struct Instruction
+        {
+          FilterOperator Operator;
+          uint32_t FirstOperand;
+          uint32_t OperandCount;
+          uint32_t TypeSet; // index of types for OfType
+        };
+
+        StatusCode CompileOperand(const FilterOperand& operand, uint32_t element, uint32_t elementCount);
+        bool Evaluate(uint32_t element, const Event& event) const;
+        bool IsTrue(const Operand& operand, const Event& event) const;
+        const Variant& GetValue(const Operand& operand, const Event& event) const;
+
+      private:
+        std::vector<Instruction> Instructions;
+        std::vector<Operand> Operands;
+        std::vector<Variant> Literals;
+        std::vector<EventField> Fields;
+        mutable std::vector<Variant> Buffers; // one per field
+        mutable std::vector<uint8_t> Results; // one per instruction, filled from the last one
+        std::vector<std::vector<NodeId>> TypeSets; // sorted event type with all its subtypes
+    };
+
+  }
+}
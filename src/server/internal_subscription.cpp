@@ -1,20 +1,170 @@
 #include "internal_subscription.h"
 
 #include <boost/thread/locks.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  using namespace OpcUa;
+
+  const uint32_t MaxMonitoredItemQueueSize = 1000;
+  const double MinSamplingInterval = 10;
+
+  void SetOverflow(DataValue& value)
+  {
+    // InfoType is DataValue, Overflow bit is set.
+    value.Status = static_cast<StatusCode>(static_cast<uint32_t>(value.Status) | 0x480);
+    value.Encoding |= DATA_VALUE_STATUS_CODE;
+  }
+
+  template <typename T>
+  bool ExceedsDeadband(const Variant& last, const Variant& current, double deadband)
+  {
+    if (last.IsScalar())
+    {
+      return std::fabs(static_cast<double>(current.As<T>()) - static_cast<double>(last.As<T>())) > deadband;
+    }
+    const std::vector<T> lastValues = last.As<std::vector<T>>();
+    const std::vector<T> currentValues = current.As<std::vector<T>>();
+    if (lastValues.size() != currentValues.size())
+    {
+      return true;
+    }
+    for (std::size_t i = 0; i < lastValues.size(); ++i)
+    {
+      if (std::fabs(static_cast<double>(currentValues[i]) - static_cast<double>(lastValues[i])) > deadband)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// @brief Check whether the value moved further than 'deadband' from the last reported one.
+  /// Values which are not numeric are compared for equality.
+  bool ValueChanged(const Variant& last, const Variant& current, double deadband)
+  {
+    if (deadband <= 0 || last.Type() != current.Type() || last.IsArray() != current.IsArray())
+    {
+      return last != current;
+    }
+    switch (current.Type())
+    {
+      case VariantType::SBYTE:  return ExceedsDeadband<int8_t>(last, current, deadband);
+      case VariantType::BYTE:   return ExceedsDeadband<uint8_t>(last, current, deadband);
+      case VariantType::INT16:  return ExceedsDeadband<int16_t>(last, current, deadband);
+      case VariantType::UINT16: return ExceedsDeadband<uint16_t>(last, current, deadband);
+      case VariantType::INT32:  return ExceedsDeadband<int32_t>(last, current, deadband);
+      case VariantType::UINT32: return ExceedsDeadband<uint32_t>(last, current, deadband);
+      case VariantType::INT64:  return ExceedsDeadband<int64_t>(last, current, deadband);
+      case VariantType::UINT64: return ExceedsDeadband<uint64_t>(last, current, deadband);
+      case VariantType::FLOAT:  return ExceedsDeadband<float>(last, current, deadband);
+      case VariantType::DOUBLE: return ExceedsDeadband<double>(last, current, deadband);
+      default:                  return last != current;
+    }
+  }
+
+  /// @brief Evaluate DataChangeFilter of the monitored item against the new value.
+  /// Every write is reported for items without filter, while sampled values
+  /// are reported only if status or value changed, which is the default filter.
+  bool IsReported(const Internal::MonitoredDataChange& item, const DataValue& value, bool sampled)
+  {
+    if (!item.HasFilter && !sampled)
+    {
+      return true;
+    }
+    const DataChangeTrigger trigger = item.HasFilter ? item.Filter.Trigger : DataChangeTrigger::StatusValue;
+    const DataValue& last = item.LastValue;
+    if (last.Status != value.Status)
+    {
+      return true;
+    }
+    if (trigger == DataChangeTrigger::Status)
+    {
+      return false;
+    }
+    if (ValueChanged(last.Value, value.Value, item.Deadband))
+    {
+      return true;
+    }
+    return trigger == DataChangeTrigger::StatusValueTimestamp && last.SourceTimestamp != value.SourceTimestamp;
+  }
+
+  /// @brief Negative interval means publishing interval of the subscription.
+  double ReviseSamplingInterval(double requested, double publishingInterval)
+  {
+    if (requested < 0)
+    {
+      requested = publishingInterval;
+    }
+    return std::max(requested, MinSamplingInterval);
+  }
+}
 
 namespace OpcUa
 {
   namespace Internal
   {
 
-    InternalSubscription::InternalSubscription(SubscriptionServiceInternal& service, const SubscriptionData& data, const NodeId& SessionAuthenticationToken, std::function<void (PublishResult)> callback, bool debug)
+    void MonitoredItemQueue::Reset(uint32_t capacity, bool discardOldest)
+    {
+      Items.clear();
+      Items.resize(capacity);
+      First = 0;
+      Count = 0;
+      DiscardOldest = discardOldest;
+    }
+
+    void MonitoredItemQueue::Push(const MonitoredItems& item)
+    {
+      const std::size_t capacity = Items.size();
+      if (Count < capacity)
+      {
+        Items[(First + Count) % capacity] = item;
+        ++Count;
+        return;
+      }
+      // Queue of size 1 always keeps the latest value and never reports overflow.
+      if (capacity == 1)
+      {
+        Items[First] = item;
+        return;
+      }
+      if (DiscardOldest)
+      {
+        Items[First] = item;
+        First = (First + 1) % capacity;
+        SetOverflow(Items[First].Value);
+      }
+      else
+      {
+        MonitoredItems& last = Items[(First + Count - 1) % capacity];
+        last = item;
+        SetOverflow(last.Value);
+      }
+    }
+
+    void MonitoredItemQueue::Pop(std::vector<MonitoredItems>& result, std::size_t maxCount)
+    {
+      const std::size_t count = std::min(Count, maxCount);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        result.push_back(std::move(Items[(First + i) % Items.size()]));
+      }
+      First = (First + count) % Items.size();
+      Count -= count;
+    }
+
+    InternalSubscription::InternalSubscription(SubscriptionServiceInternal& service, SubscriptionReactor& reactor, const SubscriptionData& data, uint32_t maxNotificationsPerPublish, const NodeId& SessionAuthenticationToken, std::function<void (PublishResult)> callback, bool debug)
       : Service(service)
+      , Reactor(reactor)
       , AddressSpace(Service.GetAddressSpace())
       , Data(data)
+      , MaxNotificationsPerPublish(maxNotificationsPerPublish)
       , CurrentSession(SessionAuthenticationToken)
       , Callback(callback)
-      , io(service.GetIOService())
-      , Timer(io, boost::posix_time::milliseconds(data.RevisedPublishingInterval))
       , LifeTimeCount(data.RevisedLifetimeCount)
       , Debug(debug)
     {
@@ -22,8 +172,15 @@ namespace OpcUa
 
     void InternalSubscription::Start()
     {
-      std::shared_ptr<InternalSubscription> self = shared_from_this();
-      Timer.async_wait([self](const boost::system::error_code& error){ self->PublishResults(error); });
+      std::weak_ptr<InternalSubscription> self = shared_from_this();
+      const uint32_t handle = Reactor.Publisher.AddSubscription(Data.RevisedPublishingInterval, [self](uint32_t periods) -> uint32_t
+        {
+          std::shared_ptr<InternalSubscription> subscription = self.lock();
+          return subscription ? subscription->PublishResults(periods) : 0;
+        });
+
+      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
+      PublishingHandle = handle;
     }
 
     InternalSubscription::~InternalSubscription()
@@ -34,7 +191,7 @@ namespace OpcUa
     void InternalSubscription::Stop()
     {
       DeleteAllMonitoredItems();
-      Timer.cancel();
+      Reactor.Publisher.RemoveSubscription(PublishingHandle);
     }
 
     void InternalSubscription::DeleteAllMonitoredItems()
@@ -61,48 +218,125 @@ namespace OpcUa
       return expired;
     }
 
-    void InternalSubscription::PublishResults(const boost::system::error_code& error)
+    const NodeId& InternalSubscription::GetSession() const
+    {
+      return CurrentSession;
+    }
+
+    uint32_t InternalSubscription::PublishResults(uint32_t periods)
     {
-      if ( error )
+      std::unique_lock<std::mutex> publishLock(PublishMutex);
       {
-        if (Debug) std::cout << "InternalSubscription | Stopping subscription timer" << std::endl;
-        return; 
+        // Every skipped publishing interval is an interval without notifications,
+        // unless a message was dispatched in between.
+        boost::unique_lock<boost::shared_mutex> lock(DbMutex);
+        if ( ! PublishedSinceCycle )
+        {
+          KeepAliveCount += periods > 0 ? periods - 1 : 0;
+        }
+        PublishedSinceCycle = false;
       }
       if ( HasExpired() )
       {
         if (Debug) { std::cout << "InternalSubscription | Subscription has expired" << std::endl; }
-        return; 
+        return 0;
+      }
+
+      const bool late = SendPublishResults(HasPublishResult());
+      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
+      PublishedSinceCycle = false;
+      if ( late )
+      {
+        return 1; // wait for next publish request
+      }
+
+      // Nothing to send, sleep until keep-alive or lifetime is due. Queued
+      // notifications wake the subscription up earlier.
+      if ( ! TriggeredDataChanges.empty() || ! TriggeredEvents.empty() )
+      {
+        return 1;
+      }
+      const uint32_t dueCount = std::min(Data.RevisedMaxKeepAliveCount, LifeTimeCount) + 1;
+      return KeepAliveCount < dueCount ? dueCount + 1 - KeepAliveCount : 1;
+    }
+
+    bool InternalSubscription::SendPublishResults(bool hasResult)
+    {
+      // Backlog which does not fit into one notification message is sent
+      // right away as long as the session has publish requests queued.
+      while ( hasResult && Service.PopPublishRequest(CurrentSession) ) //Check we received a publishrequest before sening respomse
+      {
+        PublishResult result = PopPublishResult();
+        hasResult = result.MoreNotifications;
+        if (Debug) { std::cout << "InternalSubscription | Subscription has result, calling callback" << std::endl; }
+        if ( Callback )
+        {
+          Callback(result);
+        }
+        else
+        {
+          if (Debug) std::cout << "InternalSubcsription | No callback defined for this subscription" << std::endl;
+        }
       }
 
-      if ( HasPublishResult() && Service.PopPublishRequest(CurrentSession) ) //Check we received a publishrequest before sening respomse
+      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
+      Late = hasResult;
+      return hasResult;
+    }
+
+    void InternalSubscription::PublishIfLate()
+    {
+      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
+      if ( Late )
       {
+        DispatchPublish();
+      }
+    }
 
-        std::vector<PublishResult> results = PopPublishResult();
-        if (results.size() > 0 )
+    void InternalSubscription::DispatchPublish()
+    {
+      // Called with DbMutex locked; callbacks may not run in the caller's context.
+      if ( DispatchPosted )
+      {
+        return;
+      }
+      DispatchPosted = true;
+      std::shared_ptr<InternalSubscription> self = shared_from_this();
+      Reactor.Io.post([self]()
         {
-          if (Debug) { std::cout << "InternalSubscription | Subscription has " << results.size() << " results, calling callback" << std::endl; }
-          if ( Callback )
+          std::unique_lock<std::mutex> publishLock(self->PublishMutex);
+          bool ready = false;
           {
-            Callback(results[0]);
+            boost::unique_lock<boost::shared_mutex> lock(self->DbMutex);
+            self->DispatchPosted = false;
+            ready = self->Late || ! self->TriggeredDataChanges.empty() || ! self->TriggeredEvents.empty();
           }
-          else
+          if ( ready && ! self->HasExpired() )
           {
-            if (Debug) std::cout << "InternalSubcsription | No callback defined for this subscription" << std::endl;
+            self->SendPublishResults(true);
           }
-         }
-      }
-      TimerStopped = false;
-      Timer.expires_at(Timer.expires_at() + boost::posix_time::milliseconds(Data.RevisedPublishingInterval));
-      std::shared_ptr<InternalSubscription> self = shared_from_this();
-      Timer.async_wait([self](const boost::system::error_code& error){ self->PublishResults(error); });
+        });
     }
 
+    void InternalSubscription::WakeUp()
+    {
+      // Called with DbMutex locked when the first notification is queued.
+      const std::chrono::milliseconds interval(static_cast<int64_t>(Data.RevisedPublishingInterval));
+      if ( std::chrono::steady_clock::now() - LastPublishTime >= interval && Service.HasPublishRequest(CurrentSession) )
+      {
+        DispatchPublish();
+      }
+      else if ( PublishingHandle )
+      {
+        Reactor.Publisher.Wake(PublishingHandle);
+      }
+    }
 
     bool InternalSubscription::HasPublishResult()
     {
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
       
-      if ( Startup || ! TriggeredDataChangeEvents.empty() || ! TriggeredEvents.empty() ) 
+      if ( Startup || ! TriggeredDataChanges.empty() || ! TriggeredEvents.empty() ) 
       {
         return true;
       }
@@ -116,32 +350,27 @@ namespace OpcUa
 
     }
 
-    std::vector<PublishResult> InternalSubscription::PopPublishResult()
+    PublishResult InternalSubscription::PopPublishResult()
     {
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
 
-      //std::cout << "PopPublishresult for subscription: " << Data.SubscriptionId << " with " << TriggeredDataChangeEvents.size() << " triggered items in queue" << std::endl;
       PublishResult result;
       result.SubscriptionId = Data.SubscriptionId;
       result.NotificationMessage.PublishTime = DateTime::Current();
 
-      if ( ! TriggeredDataChangeEvents.empty() )
+      std::size_t available = MaxNotificationsPerPublish ? MaxNotificationsPerPublish : std::numeric_limits<std::size_t>::max();
+      if ( ! TriggeredDataChanges.empty() )
       {
-        NotificationData data = GetNotificationData();
+        NotificationData data = GetNotificationData(available);
+        available -= data.DataChange.Notification.size();
         result.NotificationMessage.NotificationData.push_back(data);
         result.Results.push_back(StatusCode::Good);
       }
           
-      if ( ! TriggeredEvents.empty() )
+      if ( ! TriggeredEvents.empty() && available > 0 )
       {
         if (Debug) { std::cout << "InternalSubcsription | Subscription " << Data.SubscriptionId << " has " << TriggeredEvents.size() << " events to send to client" << std::endl; }
-        EventNotificationList notif;
-        for ( TriggeredEvent ev: TriggeredEvents )
-        {
-          notif.Events.push_back(ev.Data);
-        }
-        TriggeredEvents.clear();
-        NotificationData data(notif);
+        NotificationData data(GetEventNotifications(available));
         result.NotificationMessage.NotificationData.push_back(data);
         result.Results.push_back(StatusCode::Good);
       }
@@ -151,20 +380,19 @@ namespace OpcUa
       
       KeepAliveCount = 0;
       Startup = false;
+      LastPublishTime = std::chrono::steady_clock::now();
+      PublishedSinceCycle = true;
 
       result.NotificationMessage.SequenceNumber = NotificationSequence;
       ++NotificationSequence;
-      result.MoreNotifications = false;
+      result.MoreNotifications = ! TriggeredDataChanges.empty() || ! TriggeredEvents.empty();
       for (const PublishResult& res: NotAcknowledgedResults)
       {
         result.AvailableSequenceNumbers.push_back(res.NotificationMessage.SequenceNumber);
       }
       NotAcknowledgedResults.push_back(result);
       if (Debug) { std::cout << "InternalSubcsription | Sending Notification with " << result.NotificationMessage.NotificationData.size() << " notifications"  << std::endl; }
-      std::vector<PublishResult> resultlist;
-      resultlist.push_back(result);
-
-      return resultlist;
+      return result;
     }
 
     RepublishResponse InternalSubscription::Republish(const RepublishParameters& params)
@@ -185,18 +413,39 @@ namespace OpcUa
       return response;
     }
 
-    NotificationData InternalSubscription::GetNotificationData()
+    NotificationData InternalSubscription::GetNotificationData(std::size_t maxCount)
     {
       DataChangeNotification notification;
-      for ( const TriggeredDataChange& event: TriggeredDataChangeEvents)
+      std::size_t done = 0;
+      for (; done < TriggeredDataChanges.size() && notification.Notification.size() < maxCount; ++done)
       {
-        notification.Notification.push_back(event.Data);
+        MonitoredDataChangeMap::iterator it = MonitoredDataChanges.find(TriggeredDataChanges[done]);
+        if (it == MonitoredDataChanges.end())
+        {
+          continue;
+        }
+        it->second.Queue.Pop(notification.Notification, maxCount - notification.Notification.size());
+        if (!it->second.Queue.Empty())
+        {
+          break; // message is full, rest of the queue goes to the next one
+        }
       }
-      TriggeredDataChangeEvents.clear();
+      TriggeredDataChanges.erase(TriggeredDataChanges.begin(), TriggeredDataChanges.begin() + done);
       NotificationData data(notification);
       return data;
     }
 
+    EventNotificationList InternalSubscription::GetEventNotifications(std::size_t maxCount)
+    {
+      EventNotificationList notification;
+      while ( ! TriggeredEvents.empty() && notification.Events.size() < maxCount )
+      {
+        notification.Events.push_back(std::move(TriggeredEvents.front().Data));
+        TriggeredEvents.pop_front();
+      }
+      return notification;
+    }
+
     void InternalSubscription::NewAcknowlegment(const SubscriptionAcknowledgement& ack)
     {
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
@@ -211,22 +460,45 @@ namespace OpcUa
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
 
       MonitoredItemCreateResult result;
+      MonitoredDataChange mdata;
+      result.Status = SetDataChangeFilter(mdata, request);
+      if (result.Status != StatusCode::Good)
+      {
+        if (Debug) std::cout << "SubscriptionService| Invalid data change filter: " << ToString(result.Status) << std::endl;
+        return result;
+      }
+
       uint32_t callbackHandle = 0;
       result.MonitoredItemId = ++LastMonitoredItemId;
       if (request.ItemToMonitor.AttributeId == AttributeId::EventNotifier )
       {
         if (Debug) std::cout << "SubscriptionService| Subscribed o event notifier " << std::endl;
+        result.Status = mdata.WhereClause.Compile(request.RequestedParameters.Filter.Event.WhereClause, AddressSpace);
+        if (result.Status != StatusCode::Good)
+        {
+          if (Debug) std::cout << "SubscriptionService| Invalid where clause of event filter: " << ToString(result.Status) << std::endl;
+          --LastMonitoredItemId;
+          return result;
+        }
+        mdata.SelectClauses.Compile(request.RequestedParameters.Filter.Event.SelectClauses);
         //client want to subscribe to events
         //FIXME: check attribute EVENT notifier is set for the node
-        MonitoredEvents[request.ItemToMonitor.NodeId] = result.MonitoredItemId;
+        MonitoredEvents[result.MonitoredItemId] = request.ItemToMonitor.NodeId;
+        Service.AddEventListener(request.ItemToMonitor.NodeId, shared_from_this(), result.MonitoredItemId);
       }
       else
       {
         if (Debug) std::cout << "SubscriptionService| Subscribing to data chanes in the address space." << std::endl;
         uint32_t id = result.MonitoredItemId;
-        callbackHandle = AddressSpace.AddDataChangeCallback(request.ItemToMonitor.NodeId, request.ItemToMonitor.AttributeId, [this, id] (const OpcUa::NodeId& nodeId, OpcUa::AttributeId attr, const DataValue& value)
+        // Address space calls callbacks without holding its locks, so a callback can still be running
+        // after it was deleted: do not let it outlive the subscription.
+        std::weak_ptr<InternalSubscription> self = shared_from_this();
+        callbackHandle = AddressSpace.AddDataChangeCallback(request.ItemToMonitor.NodeId, request.ItemToMonitor.AttributeId, [self, id] (const OpcUa::NodeId& nodeId, OpcUa::AttributeId attr, const DataValue& value)
           {
-            this->DataChangeCallback(id, value);
+            if (std::shared_ptr<InternalSubscription> subscription = self.lock())
+            {
+              subscription->DataChangeCallback(id, value);
+            }
           });
 
         if (callbackHandle == 0)
@@ -238,38 +510,147 @@ namespace OpcUa
         }
       }
       result.Status = OpcUa::StatusCode::Good;
-      result.RevisedSamplingInterval = Data.RevisedPublishingInterval; //Force our own rate
-      result.RevisedQueueSize = request.RequestedParameters.QueueSize; // We should check that value, maybe set to a default...
+      result.RevisedSamplingInterval = ReviseSamplingInterval(request.RequestedParameters.SamplingInterval, Data.RevisedPublishingInterval);
+      result.RevisedQueueSize = std::min(std::max(request.RequestedParameters.QueueSize, 1u), MaxMonitoredItemQueueSize);
       result.FilterResult = request.RequestedParameters.Filter; //We can omit that one if we do not change anything in filter
-      MonitoredDataChange mdata;
       mdata.Parameters = result;
       mdata.Mode = request.MonitoringMode;
       mdata.ClientHandle = request.RequestedParameters.ClientHandle;
       mdata.CallbackHandle = callbackHandle;
       mdata.MonitoredItemId = result.MonitoredItemId;
+      if (request.ItemToMonitor.AttributeId != AttributeId::EventNotifier)
+      {
+        mdata.Queue.Reset(result.RevisedQueueSize, request.RequestedParameters.DiscardOldest);
+      }
+      // Writes are reported by data change callback right away. Only values which
+      // change without writes, i.e. values provided by value callbacks, are sampled.
+      if (request.ItemToMonitor.AttributeId != AttributeId::EventNotifier && AddressSpace.HasValueCallback(request.ItemToMonitor.NodeId, request.ItemToMonitor.AttributeId))
+      {
+        const uint32_t id = result.MonitoredItemId;
+        std::weak_ptr<InternalSubscription> self = shared_from_this();
+        mdata.SamplingHandle = Reactor.Sampler.AddItem(request.ItemToMonitor, static_cast<uint32_t>(result.RevisedSamplingInterval), [self, id](const DataValue& value)
+          {
+            if (std::shared_ptr<InternalSubscription> subscription = self.lock())
+            {
+              subscription->SampleCallback(id, value);
+            }
+          });
+      }
       MonitoredDataChanges[result.MonitoredItemId] = mdata;
       if (Debug) std::cout << "Created MonitoredItem with id: " << result.MonitoredItemId << " and client handle " << mdata.ClientHandle << std::endl;
       //Forcing event, 
       if (request.ItemToMonitor.AttributeId != AttributeId::EventNotifier )
       {
-        TriggerDataChangeEvent(mdata, request.ItemToMonitor);
+        TriggerDataChangeEvent(MonitoredDataChanges[result.MonitoredItemId], request.ItemToMonitor);
       }
 
       return result;
     }
 
-    void InternalSubscription::TriggerDataChangeEvent(MonitoredDataChange monitoreditems, ReadValueId attrval)
+    StatusCode InternalSubscription::SetDataChangeFilter(MonitoredDataChange& monitoreditems, const MonitoredItemCreateRequest& request)
+    {
+      const MonitoringFilter& filter = request.RequestedParameters.Filter;
+      if (filter.Header.TypeId != ExpandedObjectId::DataChangeFilter)
+      {
+        return StatusCode::Good;
+      }
+      if (request.ItemToMonitor.AttributeId != AttributeId::Value)
+      {
+        return StatusCode::BadFilterNotAllowed;
+      }
+
+      const DataChangeFilter& dataChange = filter.DataChange;
+      if (dataChange.Trigger > DataChangeTrigger::StatusValueTimestamp || dataChange.Deadband > DeadbandType::Percent)
+      {
+        return StatusCode::BadMonitoredItemFilterInvalid;
+      }
+      if (dataChange.Deadband != DeadbandType::None && !(dataChange.DeadbandValue >= 0))
+      {
+        return StatusCode::BadDeadbandFilterInvalid;
+      }
+
+      double deadband = 0;
+      if (dataChange.Deadband == DeadbandType::Absolute)
+      {
+        deadband = dataChange.DeadbandValue;
+      }
+      else if (dataChange.Deadband == DeadbandType::Percent)
+      {
+        double low = 0, high = 0;
+        if (dataChange.DeadbandValue > 100)
+        {
+          return StatusCode::BadDeadbandFilterInvalid;
+        }
+        if (!GetEURange(request.ItemToMonitor.NodeId, low, high))
+        {
+          return StatusCode::BadMonitoredItemFilterUnsupported;
+        }
+        deadband = dataChange.DeadbandValue / 100 * (high - low);
+      }
+
+      monitoreditems.HasFilter = true;
+      monitoreditems.Filter = dataChange;
+      monitoreditems.Deadband = deadband;
+      return StatusCode::Good;
+    }
+
+    bool InternalSubscription::GetEURange(const NodeId& node, double& low, double& high)
+    {
+      // Range structure is not supported by Variant yet, so EURange property
+      // is expected to hold array of two doubles: low and high limits.
+      RelativePathElement element;
+      element.ReferenceTypeId = ObjectId::HasProperty;
+      element.TargetName = QualifiedName("EURange", 0);
+      BrowsePath path;
+      path.StartingNode = node;
+      path.Path.Elements.push_back(element);
+      TranslateBrowsePathsParameters params;
+      params.BrowsePaths.push_back(path);
+      const std::vector<BrowsePathResult> paths = AddressSpace.TranslateBrowsePathsToNodeIds(params);
+      if (paths.empty() || paths[0].Status != StatusCode::Good || paths[0].Targets.empty())
+      {
+        return false;
+      }
+
+      ReadParameters read;
+      read.AttributesToRead.push_back(ToReadValueId(paths[0].Targets[0].Node, AttributeId::Value));
+      const std::vector<DataValue> values = AddressSpace.Read(read);
+      if (values.empty() || values[0].Value.Type() != VariantType::DOUBLE || !values[0].Value.IsArray())
+      {
+        return false;
+      }
+      const std::vector<double> range = values[0].Value.As<std::vector<double>>();
+      if (range.size() != 2 || !(range[1] > range[0]))
+      {
+        return false;
+      }
+      low = range[0];
+      high = range[1];
+      return true;
+    }
+
+    void InternalSubscription::TriggerDataChangeEvent(MonitoredDataChange& monitoreditems, ReadValueId attrval)
     {
       if (Debug) { std::cout << "InternalSubcsription | Manual Trigger of DataChangeEvent for sub: " << Data.SubscriptionId << " and clienthandle: " << monitoreditems.ClientHandle << std::endl; }
       ReadParameters params;
       params.AttributesToRead.push_back(attrval);
       std::vector<DataValue> vals = AddressSpace.Read(params);
       
-      TriggeredDataChange event;
-      event.MonitoredItemId = monitoreditems.MonitoredItemId;
-      event.Data.ClientHandle = monitoreditems.ClientHandle; 
-      event.Data.Value = vals[0];
-      TriggeredDataChangeEvents.push_back(event);
+      monitoreditems.LastValue = vals[0];
+      QueueDataChange(monitoreditems, vals[0]);
+    }
+
+    void InternalSubscription::QueueDataChange(MonitoredDataChange& monitoreditems, const DataValue& value)
+    {
+      if (monitoreditems.Queue.Empty())
+      {
+        TriggeredDataChanges.push_back(monitoreditems.MonitoredItemId);
+        WakeUp();
+      }
+      MonitoredItems item;
+      item.ClientHandle = monitoreditems.ClientHandle;
+      item.Value = value;
+      monitoreditems.Queue.Push(item);
     }
 
     std::vector<StatusCode> InternalSubscription::DeleteMonitoredItemsIds(const std::vector<uint32_t>& monitoreditemsids)
@@ -283,6 +664,7 @@ namespace OpcUa
 
         if ( DeleteMonitoredEvent(handle) )
         {
+          DeleteMonitoredDataChange(handle);
           results.push_back(StatusCode::Good);
           continue;
         }
@@ -311,81 +693,74 @@ namespace OpcUa
           if (it->second.CallbackHandle != 0){ //if 0 this monitoreditem did not use callbacks
             AddressSpace.DeleteDataChangeCallback(it->second.CallbackHandle);
           }
-          MonitoredDataChanges.erase(handle);
-          //We remove you our monitoreditem, now empty events which are already triggered
-          for(auto ev = TriggeredDataChangeEvents.begin(); ev != TriggeredDataChangeEvents.end();)
+          if (it->second.SamplingHandle != 0)
           {
-            if(ev->MonitoredItemId == handle)
-            {
-              if (Debug) std::cout << "InternalSubscription | Remove triggeredEvent for monitoreditemid " << handle << std::endl;
-              ev = TriggeredDataChangeEvents.erase(ev);
-            }
-            else
-            {
-              ++ev;
-            }
+            Reactor.Sampler.RemoveItem(it->second.SamplingHandle);
           }
+          MonitoredDataChanges.erase(handle);
+          //We remove you our monitoreditem, now forget notifications which are already triggered
+          TriggeredDataChanges.erase(std::remove(TriggeredDataChanges.begin(), TriggeredDataChanges.end(), handle), TriggeredDataChanges.end());
           return true;
         }
     }
 
     bool InternalSubscription::DeleteMonitoredEvent(uint32_t handle)
     {
-       for (auto pair : MonitoredEvents)
+      MonitoredEventsMap::iterator it = MonitoredEvents.find(handle);
+      if ( it == MonitoredEvents.end() )
+      {
+        return false;
+      }
+      Service.RemoveEventListener(it->second, this, handle);
+      MonitoredEvents.erase(it);
+      //We remove you our monitoreditem, now empty events which are already triggered
+      for(auto ev = TriggeredEvents.begin(); ev != TriggeredEvents.end();)
+      {
+        if(ev->MonitoredItemId == handle)
         {
-          if ( pair.second == handle )
-          {
-            MonitoredEvents.erase(pair.first);
-            //We remove you our monitoreditem, now empty events which are already triggered
-            for(auto ev = TriggeredEvents.begin(); ev != TriggeredEvents.end();)
-            {
-              if(ev->MonitoredItemId == handle)
-              {
-                if (Debug) std::cout << "InternalSubscription | Remove triggeredEvent for monitoreditemid " << handle << std::endl;
-                ev = TriggeredEvents.erase(ev);
-              }
-              else
-              {
-                ++ev;
-              }
-            }
-            return true;
-          }
+          if (Debug) std::cout << "InternalSubscription | Remove triggeredEvent for monitoreditemid " << handle << std::endl;
+          ev = TriggeredEvents.erase(ev);
         }
-      return false;
+        else
+        {
+          ++ev;
+        }
+      }
+      return true;
     }
 
     void InternalSubscription::DataChangeCallback(const uint32_t& m_id, const DataValue& value)
     {
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
 
-      TriggeredDataChange event;
       MonitoredDataChangeMap::iterator it_monitoreditem = MonitoredDataChanges.find(m_id);
       if ( it_monitoreditem == MonitoredDataChanges.end()) 
       {
-        std::cout << "InternalSubcsription | DataChangeCallback called for unknown item" << std::endl;
+        if (Debug) std::cout << "InternalSubcsription | DataChangeCallback called for unknown item" << std::endl;
         return ;
       }
 
-      event.MonitoredItemId = it_monitoreditem->first;
-      event.Data.ClientHandle = it_monitoreditem->second.ClientHandle; 
-      event.Data.Value = value;
-      if (Debug) { std::cout << "InternalSubcsription | Enqueued DataChange triggered item for sub: " << Data.SubscriptionId << " and clienthandle: " << event.Data.ClientHandle << std::endl; }
-      TriggeredDataChangeEvents.push_back(event);
+      if (!IsReported(it_monitoreditem->second, value, false))
+      {
+        return;
+      }
+      it_monitoreditem->second.LastValue = value;
+
+      if (Debug) { std::cout << "InternalSubcsription | Enqueued DataChange triggered item for sub: " << Data.SubscriptionId << " and clienthandle: " << it_monitoreditem->second.ClientHandle << std::endl; }
+      QueueDataChange(it_monitoreditem->second, value);
     }
 
-    void InternalSubscription::TriggerEvent(NodeId node, Event event)
+    void InternalSubscription::SampleCallback(uint32_t monitoreditemid, const DataValue& value)
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
+      boost::unique_lock<boost::shared_mutex> lock(DbMutex);
 
-      MonitoredEventsMap::iterator it = MonitoredEvents.find(node);
-      if ( it == MonitoredEvents.end() )
+      MonitoredDataChangeMap::iterator it_monitoreditem = MonitoredDataChanges.find(monitoreditemid);
+      if ( it_monitoreditem == MonitoredDataChanges.end() || !IsReported(it_monitoreditem->second, value, true) )
       {
-        if (Debug) std::cout << "InternalSubcsription | Subscription: " << Data.SubscriptionId << " has no subcsription for this event" << std::endl;
         return;
       }
-      lock.unlock();//Enqueue vill need to set a unique lock
-      EnqueueEvent(it->second, event);
+      it_monitoreditem->second.LastValue = value;
+      QueueDataChange(it_monitoreditem->second, value);
     }
 
     bool InternalSubscription::EnqueueEvent(uint32_t monitoreditemid, const Event& event)
@@ -404,78 +779,22 @@ namespace OpcUa
       }
           
       //Check filter against event data and create EventFieldList to send
-      //FIXME: Here we should also check event agains WhereClause of filter
+      if ( ! mii_it->second.WhereClause.Match(event) )
+      {
+        if (Debug) std::cout << "InternalSubcsription | event does not match where clause of monitoreditem " << monitoreditemid << std::endl;
+        return false;
+      }
       EventFieldList fieldlist;
       fieldlist.ClientHandle = mii_it->second.ClientHandle; 
-      fieldlist.EventFields = GetEventFields(mii_it->second.Parameters.FilterResult.Event, event);
+      fieldlist.EventFields = mii_it->second.SelectClauses.Select(event);
       TriggeredEvent ev;
       ev.Data = fieldlist;
       ev.MonitoredItemId = monitoreditemid;
       TriggeredEvents.push_back(ev);
+      WakeUp();
       return true;
     }
 
-    std::vector<Variant> InternalSubscription::GetEventFields(const EventFilter& filter, const Event& event)
-    {
-      //Go through filter and add value og matches as in spec
-      std::vector<Variant> fields;
-      if(Debug) std::cout << "InternalSubscription | InternalGetEventField " << filter.SelectClauses.size() << std::endl;
-      for (SimpleAttributeOperand sattr : filter.SelectClauses)
-      {
-        if(Debug) std::cout << "InternalSubscription | BrowsePath size " << sattr.BrowsePath.size() << std::endl;
-        if ( sattr.BrowsePath.size() == 0 )
-        {
-          fields.push_back(event.GetValue(sattr.Attribute));
-        }
-        else
-        {
-          if(Debug) std::cout << "InternalSubscription | sending value for : " << sattr.BrowsePath[0] << std::endl;
-          if ( sattr.BrowsePath[0] == QualifiedName("EventId", 0) )
-          {
-            fields.push_back(event.EventId);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("EventType", 0) )
-          {
-            fields.push_back(event.EventType);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("SourceNode", 0) )
-          {
-            fields.push_back(event.SourceNode);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("SourceName", 0) )
-          {
-            fields.push_back(event.SourceName);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("Message", 0) )
-          {
-            if (Debug) std::cout << "msg is: " << event.Message << std::endl;
-            fields.push_back(event.Message);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("Severity", 0) )
-          {
-            fields.push_back(event.Severity);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("LocalTime", 0) )
-          {
-            fields.push_back(event.LocalTime);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("ReceiveTime", 0) )
-          {
-            fields.push_back(event.ReceiveTime);
-          }
-          else if ( sattr.BrowsePath[0] == QualifiedName("Time", 0) )
-          {
-            fields.push_back(event.Time);
-          }
-          else
-          {
-            fields.push_back(event.GetValue(sattr.BrowsePath));
-          }
-        }
-      }
-      return fields;
-    }
-
 
   }
 }
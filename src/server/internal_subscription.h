@@ -2,6 +2,7 @@
 #pragma once
 
 //#include "address_space_internal.h"
+#include "content_filter.h"
 #include "subscription_service_internal.h"
 
 #include <opc/ua/event.h>
@@ -16,6 +17,7 @@
 #include <chrono>
 #include <iostream>
 #include <list>
+#include <mutex>
 #include <vector>
 
 
@@ -25,6 +27,27 @@ namespace OpcUa
   {
 
     class SubscriptionServiceInternal;
+    struct SubscriptionReactor;
+
+    /// @brief Fixed capacity queue of notifications of one monitored item.
+    /// When the queue is full either the oldest or the newest notification is replaced,
+    /// and the Overflow info bit is set in the status of the notification next to the lost one.
+    class MonitoredItemQueue
+    {
+      public:
+        void Reset(uint32_t capacity, bool discardOldest);
+        void Push(const MonitoredItems& item);
+        /// @brief Move at most 'maxCount' oldest notifications to 'result'.
+        void Pop(std::vector<MonitoredItems>& result, std::size_t maxCount);
+        bool Empty() const { return Count == 0; }
+        void Clear() { Count = 0; }
+
+      private:
+        std::vector<MonitoredItems> Items;
+        std::size_t First = 0;
+        std::size_t Count = 0;
+        bool DiscardOldest = true;
+    };
 
     //Structure to store description of a MonitoredItems
     struct MonitoredDataChange
@@ -35,12 +58,14 @@ namespace OpcUa
       MonitoredItemCreateResult Parameters;
       uint32_t ClientHandle;
       uint32_t CallbackHandle;
-    };
-
-    struct TriggeredDataChange
-    {
-      uint32_t MonitoredItemId;
-      MonitoredItems Data;
+      uint32_t SamplingHandle = 0;
+      bool HasFilter = false;
+      DataChangeFilter Filter;
+      double Deadband = 0; // absolute deadband, percent deadband is converted using EURange of the node
+      DataValue LastValue; // last value sent to the client, filter compares new values against it
+      MonitoredItemQueue Queue;
+      ContentFilterEvaluator WhereClause; // of event filter
+      EventSelector SelectClauses; // of event filter
     };
 
     struct TriggeredEvent
@@ -51,7 +76,7 @@ namespace OpcUa
 
     //typedef std::pair<NodeId, AttributeId> MonitoredItemsIndex;
     typedef std::map<uint32_t, MonitoredDataChange> MonitoredDataChangeMap;
-    typedef std::map<NodeId, uint32_t> MonitoredEventsMap;
+    typedef std::map<uint32_t, NodeId> MonitoredEventsMap; // notifier node by monitored item id
 
     class AddressSpaceInMemory; //pre-declaration
 
@@ -59,7 +84,7 @@ namespace OpcUa
     class InternalSubscription : public std::enable_shared_from_this<InternalSubscription>
     {
       public:
-        InternalSubscription(SubscriptionServiceInternal& service, const SubscriptionData& data, const NodeId& SessionAuthenticationToken, std::function<void (PublishResult)> Callback, bool debug=false);
+        InternalSubscription(SubscriptionServiceInternal& service, SubscriptionReactor& reactor, const SubscriptionData& data, uint32_t maxNotificationsPerPublish, const NodeId& SessionAuthenticationToken, std::function<void (PublishResult)> Callback, bool debug=false);
         ~InternalSubscription();
         void Start();
         void Stop();
@@ -70,26 +95,37 @@ namespace OpcUa
         bool EnqueueDataChange(uint32_t monitoreditemid, const DataValue& value);
         MonitoredItemCreateResult CreateMonitoredItem(const MonitoredItemCreateRequest& request);
         void DataChangeCallback(const uint32_t&, const DataValue& value);
+        void SampleCallback(uint32_t monitoreditemid, const DataValue& value);
         bool HasExpired();
-        void TriggerEvent(NodeId node, Event event);
+        const NodeId& GetSession() const;
+        /// @brief Answer a publish request of the session right away if notifications wait for one.
+        void PublishIfLate();
         RepublishResponse Republish(const RepublishParameters& params);
 
       private:
         void DeleteAllMonitoredItems(); 
         bool DeleteMonitoredEvent(uint32_t handle);
         bool DeleteMonitoredDataChange(uint32_t handle);
-        std::vector<PublishResult> PopPublishResult(); 
-        bool HasPublishResult(); 
-        NotificationData GetNotificationData();
-        void PublishResults(const boost::system::error_code& error);
-        std::vector<Variant> GetEventFields(const EventFilter& filter, const Event& event);
-        void TriggerDataChangeEvent(MonitoredDataChange monitoreditems, ReadValueId attrval);
+        PublishResult PopPublishResult();
+        bool HasPublishResult();
+        NotificationData GetNotificationData(std::size_t maxCount);
+        EventNotificationList GetEventNotifications(std::size_t maxCount);
+        uint32_t PublishResults(uint32_t periods);
+        bool SendPublishResults(bool hasResult);
+        void DispatchPublish();
+        void WakeUp();
+        void TriggerDataChangeEvent(MonitoredDataChange& monitoreditems, ReadValueId attrval);
+        void QueueDataChange(MonitoredDataChange& monitoreditems, const DataValue& value);
+        StatusCode SetDataChangeFilter(MonitoredDataChange& monitoreditems, const MonitoredItemCreateRequest& request);
+        bool GetEURange(const NodeId& node, double& low, double& high);
 
       private:
         SubscriptionServiceInternal& Service;
+        SubscriptionReactor& Reactor; // timers of the subscription and its items
         Server::AddressSpace& AddressSpace;
         mutable boost::shared_mutex DbMutex;
         SubscriptionData Data;
+        const uint32_t MaxNotificationsPerPublish; // zero means no limit
         const NodeId CurrentSession;
         std::function<void (PublishResult)> Callback;
 
@@ -100,11 +136,14 @@ namespace OpcUa
         MonitoredDataChangeMap MonitoredDataChanges; 
         MonitoredEventsMap MonitoredEvents;
         std::list<PublishResult> NotAcknowledgedResults; //result that have not be acknowledeged and may have to be resent
-        std::list<TriggeredDataChange> TriggeredDataChangeEvents; 
+        std::vector<uint32_t> TriggeredDataChanges; // ids of monitored items which have queued notifications
         std::list<TriggeredEvent> TriggeredEvents; 
-        boost::asio::io_service& io;
-        boost::asio::deadline_timer Timer;
-        bool TimerStopped = false;
+        uint32_t PublishingHandle = 0;
+        std::mutex PublishMutex; // serializes publishing cycles of timer and immediate dispatch
+        std::chrono::steady_clock::time_point LastPublishTime;
+        bool PublishedSinceCycle = false;
+        bool Late = false; // notifications are ready but the session had no publish request
+        bool DispatchPosted = false;
         uint32_t LifeTimeCount;
         bool Debug = false;
          
@@ -17,7 +17,9 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                *
  ******************************************************************************/
 
+#include "buffer_pool.h"
 #include "opc_tcp_processor.h"
+#include "write_queue.h"
 
 #include <opc/ua/server/opc_tcp_async.h>
 
@@ -27,11 +29,18 @@
 #include <opc/ua/protocol/channel.h>
 #include <opc/ua/protocol/secure_channel.h>
 #include <opc/ua/protocol/input_from_buffer.h>
+#include <opc/ua/protocol/status_codes.h>
+#include <opc/ua/protocol/string_utils.h>
 
+#include <algorithm>
 #include <array>
 #include <boost/asio.hpp>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 #include <set>
+#include <thread>
 
 
 
@@ -45,6 +54,24 @@ namespace
   using namespace boost::asio;  
   using namespace boost::asio::ip;  
 
+  // Sent message buffers kept by a connection for reuse, larger ones are released.
+  const std::size_t MaxFreeBuffers = 16;
+  const std::size_t MaxFreeBufferSize = 65536;
+
+  // Receive buffers of all connections are taken from one pool, the largest
+  // class fits the largest receive buffer size acknowledged to a client.
+  const std::size_t MinReceiveBufferSize = 8192;
+  const std::size_t MaxPooledBufferSize = 65536;
+  const std::size_t MaxFreeReceiveBuffers = 64;
+
+  // Time given to handlers of connections to leave when server shuts down.
+  const unsigned ShutdownTimeoutSeconds = 5;
+
+  // Requests which create, activate or close a session are processed alone.
+  bool IsSessionRequest(OpcUa::MessageId request)
+  {
+    return request == OpcUa::CREATE_SESSION_REQUEST || request == OpcUa::ACTIVATE_SESSION_REQUEST || request == OpcUa::CLOSE_SESSION_REQUEST;
+  }
 
   class OpcTcpConnection;
 
@@ -54,24 +81,47 @@ namespace
     DEFINE_CLASS_POINTERS(OpcTcpServer)
 
   public:
-    OpcTcpServer(const AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& ioService);
+    OpcTcpServer(const AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& ioService, OpcUa::Server::IoServiceSelector connectionIo, OpcUa::Server::IoServiceRelease releaseIo);
+
+    virtual ~OpcTcpServer();
 
     virtual void Listen() override;
     virtual void Shutdown() override;
 
   private:
     void Accept();
+    void AcceptStopped();
+    void StopServiceThreads();
 
   private:// OpcTcpClient interface;
     friend class OpcTcpConnection;
     void RemoveClient(std::shared_ptr<OpcTcpConnection> client);
+    void ConnectionClosed(boost::asio::io_service& io);
 
   private:
     Parameters Params;
     Services::SharedPtr Server;
+    boost::asio::io_service& AcceptorIo;
+    OpcUa::Server::IoServiceSelector ConnectionIo;
+    OpcUa::Server::IoServiceRelease ReleaseIo;
+    // Connections running at other io_services leave from their threads.
+    std::mutex ClientsMutex;
     std::set<std::shared_ptr<OpcTcpConnection>> Clients;
+    // Handlers of the acceptor and connections refer to the server, so
+    // Shutdown waits until they are done while io_services are still run.
+    std::condition_variable ShutdownProgress;
+    bool Stopping = false;
+    bool Accepting = false;
+    bool AcceptorClosed = false;
+    unsigned Connections = 0;
+    std::shared_ptr<Internal::BufferPool> ReceiveBuffers;
+
+    // Executes requests when Params.ServiceThreads is not zero. A connection has at most
+    // Params.MaxPipelinedRequests queued, so the queue is bounded by number of clients.
+    std::unique_ptr<boost::asio::io_service> Executor;
+    std::unique_ptr<boost::asio::io_service::work> ExecutorWork;
+    std::vector<std::thread> ExecutorThreads;
 
-    tcp::socket socket;
     tcp::acceptor acceptor;
   };
 
@@ -82,7 +132,7 @@ namespace
     DEFINE_CLASS_POINTERS(OpcTcpConnection)
 
   public:
-    OpcTcpConnection(tcp::socket socket, OpcTcpServer& tcpServer, Services::SharedPtr uaServer, bool debug);
+    OpcTcpConnection(boost::asio::io_service& io, tcp::socket socket, OpcTcpServer& tcpServer, Services::SharedPtr uaServer, bool debug);
     ~OpcTcpConnection();
 
     void Start();
@@ -92,40 +142,98 @@ namespace
       Socket.close();
     }
 
+    // Closes the socket at io_service of the connection, where its handlers run.
+    void Close()
+    {
+      std::shared_ptr<OpcTcpConnection> self = shared_from_this();
+      Io.post([self]()
+      {
+        self->Stop();
+      });
+    }
+
 
   private:
     void ReadNextData();
-    void ProcessHeader(const boost::system::error_code& error, std::size_t bytes_transferred);
-    void ProcessMessage(OpcUa::Binary::MessageType type, const boost::system::error_code& error, std::size_t bytesTransferred);
+    void ReserveBuffer();
+    void OnDataReceived(const boost::system::error_code& error, std::size_t bytesTransferred);
+    // Methods returning bool tell whether the caller should go on reading.
+    bool ProcessChunk(const OpcUa::Binary::Header& header, const char* data, std::size_t size);
+    bool ExecuteMessage(OpcUa::Binary::MessageType type, const char* data, std::size_t size);
+    bool Execute(OpcUa::Binary::MessageType type, std::shared_ptr<std::vector<char>> data, bool runInline);
+    bool ProcessMessage(OpcUa::Binary::MessageType type, const char* data, std::size_t size);
+    bool RequestProcessed(bool cont, bool inlineDone = false);
+    OpcUa::MessageId GetRequestType(const char* data, std::size_t size) const;
+    bool AppendChunk(OpcUa::Binary::MessageType type, const char* data, std::size_t size);
+    void RejectMessage(StatusCode code, const std::string& reason);
     void GoodBye();
 
     std::size_t GetHeaderSize() const;
 
   private:
     virtual void Send(const char* message, std::size_t size);
+    void WritePending();
+    void OnWritten(const boost::system::error_code& error, std::size_t count);
     void FillResponseHeader(const RequestHeader& requestHeader, ResponseHeader& responseHeader) const;
 
   private:
+    boost::asio::io_service& Io;
     tcp::socket Socket;
     OpcTcpServer& TcpServer;
     Server::OpcTcpMessages MessageProcessor;
     OStreamBinary OStream;
     const bool Debug = false;
+    // Received data, chunks in [BufferBegin, BufferEnd) are not processed yet.
+    // Data is read into the rest of the buffer as much as available.
+    std::shared_ptr<Internal::BufferPool> ReceiveBuffers;
     std::vector<char> Buffer;
+    std::size_t BufferBegin = 0;
+    std::size_t BufferEnd = 0;
+    // Size of the buffer fitted to chunks negotiated by Hello message.
+    std::size_t BufferSize = MinReceiveBufferSize;
+    // Message reassembled from intermediate chunks.
+    std::vector<char> Message;
+
+    // Next messages are read while received requests are executed, until
+    // Params.MaxPipelinedRequests are executed at once. Channel and session
+    // messages wait for all requests before them and stop reading until done.
+    struct BlockedMessage
+    {
+      OpcUa::Binary::MessageType Type;
+      std::shared_ptr<std::vector<char>> Data;
+      bool Inline;
+    };
+    std::mutex PipelineMutex;
+    unsigned Executing = 0;
+    bool ReadPaused = false;
+    // A request is processed right from Buffer, reading must not resume
+    // until it is done even if other requests complete meanwhile.
+    bool InlineExecuting = false;
+    bool Closed = false;
+    std::unique_ptr<BlockedMessage> Blocked;
+
+    // Outgoing messages. Messages sent while a write is in flight are
+    // written together by the next gathered write.
+    Internal::WriteQueue Outgoing;
   };
 
-  OpcTcpConnection::OpcTcpConnection(tcp::socket socket, OpcTcpServer& tcpServer, Services::SharedPtr uaServer, bool debug)
-    : Socket(std::move(socket))
+  OpcTcpConnection::OpcTcpConnection(boost::asio::io_service& io, tcp::socket socket, OpcTcpServer& tcpServer, Services::SharedPtr uaServer, bool debug)
+    : Io(io)
+    , Socket(std::move(socket))
     , TcpServer(tcpServer)
-    , MessageProcessor(uaServer, *this, debug)
+    , MessageProcessor(uaServer, *this, io, debug)
     , OStream(*this)
     , Debug(debug)
-    , Buffer(8192)
+    , ReceiveBuffers(tcpServer.ReceiveBuffers)
+    , Buffer(ReceiveBuffers->Acquire(MinReceiveBufferSize))
+    , Outgoing(MaxFreeBuffers, MaxFreeBufferSize)
   {
   }
 
   OpcTcpConnection::~OpcTcpConnection()
   {
+    ReceiveBuffers->Release(std::move(Buffer));
+    TcpServer.ConnectionClosed(Io);
   }
 
   void OpcTcpConnection::Start()
@@ -135,83 +243,344 @@ namespace
 
   void OpcTcpConnection::ReadNextData()
   {
-    async_read(Socket, buffer(Buffer), transfer_exactly(GetHeaderSize()),
-      [this](const boost::system::error_code& error, std::size_t bytes_transferred)
+    // Every complete chunk already received is processed before reading more.
+    const std::size_t headerSize = GetHeaderSize();
+    while (BufferEnd - BufferBegin >= headerSize)
+    {
+      OpcUa::InputFromBuffer headerChannel(&Buffer[BufferBegin], headerSize);
+      IStreamBinary headerStream(headerChannel);
+      OpcUa::Binary::Header header;
+      headerStream >> header;
+
+      if (header.Size < headerSize)
       {
-        try
-        {
-          ProcessHeader(error, bytes_transferred);
-        }
-        catch (const std::exception& exc)
-        {
-          std::cerr << "opc_tcp_async| Failed to process message header: " << exc.what() << std::endl;
-        }
+        std::cerr << "opc_tcp_async| Invalid size of message: " << header.Size << std::endl;
+        GoodBye();
+        return;
+      }
+      if (MessageProcessor.CheckChunkSize(header.Size) != StatusCode::Good)
+      {
+        RejectMessage(StatusCode::BadTcpMessageTooLarge, "Chunk of " + std::to_string(header.Size) + " bytes exceeds receive buffer size.");
+        return;
+      }
+      if (BufferEnd - BufferBegin < header.Size)
+      {
+        break;
+      }
+
+      if (Debug)
+      {
+        std::cout << "opc_tcp_async| Message type: " << header.Type << std::endl;
+        std::cout << "opc_tcp_async| Chunk type: " << header.Chunk << std::endl;
+        std::cout << "opc_tcp_async| MessageSize: " << header.Size << std::endl;
+      }
+
+      const char* body = &Buffer[BufferBegin + headerSize];
+      BufferBegin += header.Size;
+      if (!ProcessChunk(header, body, header.Size - headerSize))
+      {
+        return;
+      }
+    }
+
+    ReserveBuffer();
+    std::shared_ptr<OpcTcpConnection> self = shared_from_this();
+    Socket.async_read_some(buffer(&Buffer[BufferEnd], Buffer.size() - BufferEnd),
+      [self](const boost::system::error_code& error, std::size_t bytesTransferred)
+      {
+        self->OnDataReceived(error, bytesTransferred);
       }
     );
   }
 
+  void OpcTcpConnection::ReserveBuffer()
+  {
+    // Received part of the next chunk is moved to the front of the buffer.
+    // Chunks larger than the negotiated receive buffer size are rejected
+    // before, so the buffer grows only to that size after Hello.
+    const std::size_t received = BufferEnd - BufferBegin;
+    if (Buffer.size() < BufferSize)
+    {
+      std::vector<char> larger = ReceiveBuffers->Acquire(BufferSize);
+      std::copy(Buffer.begin() + BufferBegin, Buffer.begin() + BufferEnd, larger.begin());
+      ReceiveBuffers->Release(std::move(Buffer));
+      Buffer = std::move(larger);
+    }
+    else if (BufferBegin != 0)
+    {
+      std::copy(Buffer.begin() + BufferBegin, Buffer.begin() + BufferEnd, Buffer.begin());
+    }
+    BufferBegin = 0;
+    BufferEnd = received;
+  }
+
   std::size_t OpcTcpConnection::GetHeaderSize() const
   {
     return OpcUa::Binary::RawSize(OpcUa::Binary::Header());
   }
 
-  void OpcTcpConnection::ProcessHeader(const boost::system::error_code& error, std::size_t bytes_transferred)
+  void OpcTcpConnection::OnDataReceived(const boost::system::error_code& error, std::size_t bytesTransferred)
   {
     if (error)
     {
-      std::cerr << "opc_tcp_async| Error during receiving message header: " << error.message() << std::endl;
+      std::cerr << "opc_tcp_async| Error during receiving data: " << error.message() << std::endl;
       GoodBye();
       return;
     }
 
-    if (Debug) std::cout << "opc_tcp_async| Received message header with size " << bytes_transferred << std::endl;
+    if (Debug) std::cout << "opc_tcp_async| Received " << bytesTransferred << " bytes from client." << std::endl;
+    BufferEnd += bytesTransferred;
 
-    OpcUa::InputFromBuffer messageChannel(&Buffer[0], bytes_transferred);
-    IStreamBinary messageStream(messageChannel);
-    OpcUa::Binary::Header header;
-    messageStream >> header;
-
-    const std::size_t messageSize = header.Size - GetHeaderSize();
+    try
+    {
+      ReadNextData();
+    }
+    catch (const std::exception& exc)
+    {
+      std::cerr << "opc_tcp_async| Failed to process received data: " << exc.what() << std::endl;
+      GoodBye();
+    }
+  }
 
+  bool OpcTcpConnection::ProcessChunk(const OpcUa::Binary::Header& header, const char* data, std::size_t size)
+  {
     if (Debug)
     {
-      std::cout << "opc_tcp_async| Message type: " << header.Type << std::endl;
-      std::cout << "opc_tcp_async| Chunk type: " << header.Chunk << std::endl;
-      std::cout << "opc_tcp_async| MessageSize: " << header.Size << std::endl;
-      std::cout << "opc_tcp_async| Waiting " << messageSize << " bytes from client." << std::endl;
+      std::cout << "opc_tcp_async| Received chunk with " << size << " bytes from client:" << std::endl;
+      PrintBlob(std::vector<char>(data, data + size));
+    }
+
+    switch (header.Chunk)
+    {
+      case CHT_INTERMEDIATE:
+      {
+        return AppendChunk(header.Type, data, size);
+      }
+
+      case CHT_FINAL:
+      {
+        if (Debug) std::cout << "opc_tcp_async| Client aborted message." << std::endl;
+        Message.clear();
+        return true;
+      }
+
+      default:
+        break;
+    }
+
+    bool cont = false;
+    if (Message.empty())
+    {
+      cont = ExecuteMessage(header.Type, data, size);
+    }
+    else
+    {
+      if (!AppendChunk(header.Type, data, size))
+      {
+        return false;
+      }
+      std::vector<char> message;
+      message.swap(Message);
+      cont = ExecuteMessage(header.Type, message.data(), message.size());
+    }
+
+    if (cont && header.Type == MT_HELLO)
+    {
+      // Receive buffer is fitted to chunks the client is going to send.
+      BufferSize = std::min<std::size_t>(std::max<std::size_t>(MessageProcessor.GetReceiveBufferSize(), MinReceiveBufferSize), MaxPooledBufferSize);
+    }
+    return cont;
+  }
+
+  bool OpcTcpConnection::ExecuteMessage(OpcUa::Binary::MessageType type, const char* data, std::size_t size)
+  {
+    // Keep the connection alive if processing says good bye.
+    std::shared_ptr<OpcTcpConnection> self = shared_from_this();
+    const OpcUa::MessageId request = type == MT_SECURE_MESSAGE ? GetRequestType(data, size) : OpcUa::INVALID;
+    const bool exclusive = type != MT_SECURE_MESSAGE || IsSessionRequest(request);
+    const bool runInline = type != MT_SECURE_MESSAGE || TcpServer.Params.InlineRequests.count(request);
+
+    // Once reading is paused a completed request may resume it from another
+    // thread and reuse Buffer, so requests not processed inline are copied first.
+    std::shared_ptr<std::vector<char>> copy;
+    if (!runInline)
+    {
+      copy = std::make_shared<std::vector<char>>(data, data + size);
+    }
+
+    bool readNext = false;
+    {
+      std::unique_lock<std::mutex> lock(PipelineMutex);
+      if (exclusive && Executing)
+      {
+        Blocked.reset(new BlockedMessage{type, copy ? copy : std::make_shared<std::vector<char>>(data, data + size), runInline});
+        ReadPaused = true;
+        return false;
+      }
+      ++Executing;
+      ReadPaused = exclusive || Executing >= std::max(1u, TcpServer.Params.MaxPipelinedRequests);
+      readNext = !ReadPaused;
+      InlineExecuting = runInline;
+    }
+
+    if (runInline)
+    {
+      // Processed before the next read, right from the receive buffer.
+      if (RequestProcessed(ProcessMessage(type, data, size), true))
+      {
+        readNext = true;
+      }
+    }
+    else
+    {
+      Execute(type, copy, false);
     }
 
-    async_read(Socket, buffer(Buffer), transfer_exactly(messageSize),
-        [this, header](const boost::system::error_code& error, std::size_t bytesTransferred)
+    if (!readNext)
+    {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(PipelineMutex);
+    return !Closed;
+  }
+
+  bool OpcTcpConnection::Execute(OpcUa::Binary::MessageType type, std::shared_ptr<std::vector<char>> data, bool runInline)
+  {
+    if (runInline)
+    {
+      return RequestProcessed(ProcessMessage(type, data->data(), data->size()));
+    }
+
+    std::shared_ptr<OpcTcpConnection> self = shared_from_this();
+    if (!TcpServer.Executor)
+    {
+      Io.post([self, type, data]()
+      {
+        if (self->RequestProcessed(self->ProcessMessage(type, data->data(), data->size())))
         {
-          if (error)
-          {
-            if (Debug) std::cerr << "opc_tcp_async| Error during receiving message body." << std::endl;
-            return;
-          }
-          ProcessMessage(header.Type, error, bytesTransferred);
+          self->ReadNextData();
         }
-    );
+      });
+      return false;
+    }
 
+    TcpServer.Executor->post([self, type, data]()
+    {
+      const bool cont = self->ProcessMessage(type, data->data(), data->size());
+      self->Io.post([self, cont]()
+      {
+        if (self->RequestProcessed(cont))
+        {
+          self->ReadNextData();
+        }
+      });
+    });
+    return false;
   }
 
-  void OpcTcpConnection::ProcessMessage(OpcUa::Binary::MessageType type, const boost::system::error_code& error, std::size_t bytesTransferred)
+  bool OpcTcpConnection::RequestProcessed(bool cont, bool inlineDone)
   {
-    if (error)
+    std::unique_ptr<BlockedMessage> next;
+    bool readNext = false;
+    {
+      std::unique_lock<std::mutex> lock(PipelineMutex);
+      --Executing;
+      if (inlineDone)
+      {
+        InlineExecuting = false;
+      }
+      if (Closed)
+      {
+        return false;
+      }
+      if (!cont)
+      {
+        Closed = true;
+      }
+      else if (Blocked)
+      {
+        if (Executing == 0)
+        {
+          next = std::move(Blocked);
+          ++Executing;
+        }
+      }
+      else if (ReadPaused && !InlineExecuting)
+      {
+        // Otherwise the inline request resumes reading when it is done.
+        ReadPaused = false;
+        readNext = true;
+      }
+    }
+
+    if (!cont)
     {
-      std::cerr << "opc_tcp_async| Error during receiving message body: " << error.message() << std::endl;
       GoodBye();
-      return;
+      return false;
+    }
+    if (next)
+    {
+      return Execute(next->Type, next->Data, next->Inline);
     }
+    return readNext;
+  }
 
-    if (Debug)
+  OpcUa::MessageId OpcTcpConnection::GetRequestType(const char* data, std::size_t size) const
+  {
+    try
+    {
+      OpcUa::InputFromBuffer messageChannel(data, size);
+      IStreamBinary messageStream(messageChannel);
+      uint32_t channelId = 0;
+      SymmetricAlgorithmHeader algorithmHeader;
+      SequenceHeader sequence;
+      NodeId typeId;
+      messageStream >> channelId >> algorithmHeader >> sequence >> typeId;
+      return GetMessageId(typeId);
+    }
+    catch (const std::exception&)
+    {
+      // Broken message will be rejected by the message processor.
+      return OpcUa::INVALID;
+    }
+  }
+
+  bool OpcTcpConnection::AppendChunk(OpcUa::Binary::MessageType type, const char* data, std::size_t size)
+  {
+    StatusCode status = StatusCode::Good;
+    try
+    {
+      status = MessageProcessor.AppendChunk(type, data, size, Message);
+    }
+    catch (const std::exception& exc)
+    {
+      std::cerr << "opc_tcp_async| Failed to process message chunk. " << exc.what() << std::endl;
+      Message.clear();
+      GoodBye();
+      return false;
+    }
+
+    if (status != StatusCode::Good)
     {
-      if (Debug) std::cout << "opc_tcp_async| Received " << bytesTransferred << " bytes from client:" << std::endl;
-      PrintBlob(Buffer, bytesTransferred);
+      Message.clear();
+      RejectMessage(status, "Message cannot be assembled from chunks.");
+      return false;
     }
+    return true;
+  }
+
+  void OpcTcpConnection::RejectMessage(StatusCode code, const std::string& reason)
+  {
+    // Error message is written before the connection is released.
+    std::cerr << "opc_tcp_async| " << reason << " " << OpcUa::ToString(code) << std::endl;
+    MessageProcessor.SendError(code, reason);
+    GoodBye();
+  }
 
+  bool OpcTcpConnection::ProcessMessage(OpcUa::Binary::MessageType type, const char* data, std::size_t size)
+  {
     // restrict server size code only with current message.
-    OpcUa::InputFromBuffer messageChannel(&Buffer[0], bytesTransferred);
+    OpcUa::InputFromBuffer messageChannel(data, size);
     IStreamBinary messageStream(messageChannel);
 
     bool cont = true;
@@ -223,8 +592,7 @@ namespace
     catch(const std::exception& exc)
     {
       std::cerr << "opc_tcp_async| Failed to process message. " << exc.what() << std::endl;
-      GoodBye();
-      return;
+      return false;
     }
 
     if (messageChannel.GetRemainSize())
@@ -232,13 +600,7 @@ namespace
       std::cerr << "opc_tcp_async| ERROR!!! Message from client has been processed partially." << std::endl;
     }
 
-    if ( ! cont )
-    {
-      GoodBye();
-      return;
-    }
-
-    ReadNextData();
+    return cont;
   }
 
 
@@ -251,33 +613,68 @@ namespace
 
   void OpcTcpConnection::Send(const char* message, std::size_t size)
   {
-    std::shared_ptr<std::vector<char>> data = std::make_shared<std::vector<char>>(message, message + size);
-
     if (Debug)
     {
       std::cout << "opc_tcp_async| Sending next data to the client:" << std::endl;
-      PrintBlob(*data);
+      PrintBlob(std::vector<char>(message, message + size));
     }
 
-    async_write(Socket, buffer(&(*data)[0], data->size()), [this, data](const boost::system::error_code & err, size_t bytes){
-      if (err)
+    if (Outgoing.Push(message, size))
+    {
+      // Writes are started at io_service of the connection, so publish responses
+      // sent from threads of other io_services do not touch the socket.
+      std::shared_ptr<OpcTcpConnection> self = shared_from_this();
+      Io.post([self]()
       {
-        std::cerr << "opc_tcp_async| Failed to send data to the client. " << err.message() << std::endl;
-        GoodBye();
-        return;
-      }
+        self->WritePending();
+      });
+    }
+  }
 
-      if (Debug)
-      {
-        std::cout << "opc_tcp_async| Response sent to the client." << std::endl;
-      }
+  void OpcTcpConnection::WritePending()
+  {
+    const std::vector<std::vector<char>>& writing = Outgoing.Take();
+    std::vector<const_buffer> buffers;
+    buffers.reserve(writing.size());
+    for (const std::vector<char>& data : writing)
+    {
+      buffers.push_back(buffer(data));
+    }
+
+    std::shared_ptr<OpcTcpConnection> self = shared_from_this();
+    async_write(Socket, buffers, [self, &writing](const boost::system::error_code& error, std::size_t)
+    {
+      self->OnWritten(error, writing.size());
     });
   }
 
-  OpcTcpServer::OpcTcpServer(const AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& ioService)
+  void OpcTcpConnection::OnWritten(const boost::system::error_code& error, std::size_t count)
+  {
+    if (error)
+    {
+      std::cerr << "opc_tcp_async| Failed to send data to the client. " << error.message() << std::endl;
+      GoodBye();
+      return;
+    }
+
+    if (Debug)
+    {
+      std::cout << "opc_tcp_async| Sent " << count << " message(s) to the client." << std::endl;
+    }
+
+    if (Outgoing.Written())
+    {
+      WritePending();
+    }
+  }
+
+  OpcTcpServer::OpcTcpServer(const AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& ioService, OpcUa::Server::IoServiceSelector connectionIo, OpcUa::Server::IoServiceRelease releaseIo)
     : Params(params)
     , Server(server)
-    , socket(ioService)
+    , AcceptorIo(ioService)
+    , ConnectionIo(connectionIo)
+    , ReleaseIo(releaseIo)
+    , ReceiveBuffers(std::make_shared<Internal::BufferPool>(MinReceiveBufferSize, MaxPooledBufferSize, MaxFreeReceiveBuffers))
     , acceptor(ioService)
   {
     tcp::endpoint ep;
@@ -296,38 +693,143 @@ namespace
     acceptor.open(ep.protocol());
     acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
     acceptor.bind(ep);
+
+    if (Params.ServiceThreads)
+    {
+      Executor.reset(new boost::asio::io_service);
+      ExecutorWork.reset(new boost::asio::io_service::work(*Executor));
+      for (unsigned i = 0; i < Params.ServiceThreads; ++i)
+      {
+        ExecutorThreads.emplace_back([this]()
+        {
+          Executor->run();
+        });
+      }
+    }
+  }
+
+  OpcTcpServer::~OpcTcpServer()
+  {
+    StopServiceThreads();
+  }
+
+  void OpcTcpServer::StopServiceThreads()
+  {
+    if (!Executor)
+    {
+      return;
+    }
+    ExecutorWork.reset();
+    Executor->stop();
+    for (std::thread& thread : ExecutorThreads)
+    {
+      thread.join();
+    }
+    ExecutorThreads.clear();
   }
 
   void OpcTcpServer::Listen()
   {
     std::clog << "opc_tcp_async| Running server." << std::endl;
+    {
+      std::unique_lock<std::mutex> lock(ClientsMutex);
+      Accepting = true;
+    }
     Accept();
   }
 
   void OpcTcpServer::Shutdown()
   {
     std::clog << "opc_tcp_async| Shutting down server." << std::endl;
-    Clients.clear();
-    acceptor.close();
+    std::set<std::shared_ptr<OpcTcpConnection>> clients;
+    {
+      std::unique_lock<std::mutex> lock(ClientsMutex);
+      Stopping = true;
+      clients.swap(Clients);
+    }
+    for (const std::shared_ptr<OpcTcpConnection>& client : clients)
+    {
+      client->Close();
+    }
+    clients.clear();
+
+    AcceptorIo.post([this]()
+    {
+      boost::system::error_code ignored;
+      acceptor.close(ignored);
+      std::unique_lock<std::mutex> lock(ClientsMutex);
+      AcceptorClosed = true;
+      ShutdownProgress.notify_all();
+    });
+
+    {
+      std::unique_lock<std::mutex> lock(ClientsMutex);
+      const bool done = ShutdownProgress.wait_for(lock, std::chrono::seconds(ShutdownTimeoutSeconds), [this]()
+      {
+        return AcceptorClosed && !Accepting && Connections == 0;
+      });
+      if (!done)
+      {
+        std::cerr << "opc_tcp_async| Connections were not closed in time, io_service is not run?" << std::endl;
+      }
+    }
+    StopServiceThreads();
   }
 
   void OpcTcpServer::Accept()
   {
+    // Accepting stays set from Listen until the last accept handler leaves.
+    {
+      std::unique_lock<std::mutex> lock(ClientsMutex);
+      if (Stopping)
+      {
+        Accepting = false;
+        ShutdownProgress.notify_all();
+        return;
+      }
+    }
+
     try
     {
       std::cout << "opc_tcp_async| Waiting for client connection at: " << acceptor.local_endpoint().address() << ":" << acceptor.local_endpoint().port() <<  std::endl;
       acceptor.listen();
-      acceptor.async_accept(socket, [this](boost::system::error_code errorCode){
+      // Socket is opened at io_service of the connection, so all its handlers are run there.
+      // The io_service is given back when the connection is closed or nothing is accepted.
+      boost::asio::io_service* io = &ConnectionIo();
+      std::shared_ptr<tcp::socket> socket = std::make_shared<tcp::socket>(*io);
+      acceptor.async_accept(*socket, [this, io, socket](boost::system::error_code errorCode){
+        if (errorCode == boost::asio::error::operation_aborted)
+        {
+          ReleaseIo(*io);
+          AcceptStopped();
+          return;
+        }
         if (!errorCode)
         {
           std::cout << "opc_tcp_async| Accepted new client connection." << std::endl;
-          std::shared_ptr<OpcTcpConnection> connection = std::make_shared<OpcTcpConnection>(std::move(socket), *this, Server, Params.DebugMode);
-          Clients.insert(connection);
-          connection->Start();
+          std::shared_ptr<OpcTcpConnection> connection;
+          {
+            std::unique_lock<std::mutex> lock(ClientsMutex);
+            if (!Stopping)
+            {
+              connection = std::make_shared<OpcTcpConnection>(*io, std::move(*socket), *this, Server, Params.DebugMode);
+              ++Connections;
+              Clients.insert(connection);
+            }
+          }
+          if (connection)
+          {
+            connection->Start();
+          }
+          else
+          {
+            ReleaseIo(*io);
+          }
         }
         else
         {
           std::cout << "opc_tcp_async| Error during client connection: "<< errorCode.message() << std::endl;
+          ReleaseIo(*io);
         }
         Accept();
       });
@@ -335,17 +837,39 @@ namespace
     catch (const std::exception& exc)
     {
       std::cout << "opc_tcp_async| Error accepting client connection: "<< exc.what() << std::endl;
+      AcceptStopped();
     }
   }
 
+  void OpcTcpServer::AcceptStopped()
+  {
+    std::unique_lock<std::mutex> lock(ClientsMutex);
+    Accepting = false;
+    ShutdownProgress.notify_all();
+  }
+
   void OpcTcpServer::RemoveClient(OpcTcpConnection::SharedPtr client)
   {
+    std::unique_lock<std::mutex> lock(ClientsMutex);
     Clients.erase(client);
   }
 
+  void OpcTcpServer::ConnectionClosed(boost::asio::io_service& io)
+  {
+    ReleaseIo(io);
+    std::unique_lock<std::mutex> lock(ClientsMutex);
+    --Connections;
+    ShutdownProgress.notify_all();
+  }
+
 } // namespace
 
 OpcUa::Server::AsyncOpcTcp::UniquePtr OpcUa::Server::CreateAsyncOpcTcp(const OpcUa::Server::AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& io)
 {
-  return AsyncOpcTcp::UniquePtr(new OpcTcpServer(params, server, io));
+  return CreateAsyncOpcTcp(params, server, io, [&io]() -> boost::asio::io_service& { return io; }, [](boost::asio::io_service&) {});
+}
+
+OpcUa::Server::AsyncOpcTcp::UniquePtr OpcUa::Server::CreateAsyncOpcTcp(const OpcUa::Server::AsyncOpcTcp::Parameters& params, Services::SharedPtr server, boost::asio::io_service& io, IoServiceSelector connectionIo, IoServiceRelease releaseIo)
+{
+  return AsyncOpcTcp::UniquePtr(new OpcTcpServer(params, server, io, connectionIo, releaseIo));
 }
@@ -59,6 +59,7 @@ namespace
     {
       std::cout << "opc_tcp_async| Parameters:" << std::endl;
       std::cout << "opc_tcp_async|   Debug mode: " << params.DebugMode << std::endl;
+      std::cout << "opc_tcp_async|   Service threads: " << params.ServiceThreads << std::endl;
     }
     const std::vector<OpcUa::Server::ApplicationData> applications = OpcUa::ParseEndpointsParameters(addonParams.Groups, params.DebugMode);
     if (params.DebugMode)
@@ -93,7 +94,14 @@ namespace
     OpcUa::Server::AsioAddon::SharedPtr asio = addons.GetAddon<OpcUa::Server::AsioAddon>(OpcUa::Server::AsioAddonId);
 
     params.Port = Common::Uri(endpointDescriptions[0].EndpointUrl).Port();
-    Endpoint = CreateAsyncOpcTcp(params, internalServer->GetServer(), asio->GetIoService());
+    Endpoint = CreateAsyncOpcTcp(params, internalServer->GetServer(), asio->GetIoService(), [asio]() -> boost::asio::io_service&
+      {
+        return asio->GetConnectionIoService();
+      },
+      [asio](boost::asio::io_service& io)
+      {
+        asio->ReleaseConnectionIoService(io);
+      });
     Endpoint->Listen();
   }
 
@@ -20,6 +20,27 @@
 
 #include "opc_tcp_async_parameters.h"
 
+#include <sstream>
+
+namespace
+{
+  // Comma separated numeric ids of request types, e.g. "631,826" for Read and Publish.
+  std::set<OpcUa::MessageId> ParseRequests(const std::string& value)
+  {
+    std::set<OpcUa::MessageId> result;
+    std::istringstream stream(value);
+    std::string id;
+    while (std::getline(stream, id, ','))
+    {
+      if (id.find_first_not_of(" ") != std::string::npos)
+      {
+        result.insert(static_cast<OpcUa::MessageId>(std::stoi(id)));
+      }
+    }
+    return result;
+  }
+}
+
 namespace OpcUa
 {
   namespace Server
@@ -32,6 +53,12 @@ namespace OpcUa
       {
         if (param.Name == "debug")
           result.DebugMode = param.Value == "false" || param.Value == "0" ? false : true;
+        else if (param.Name == "service_threads")
+          result.ServiceThreads = std::stoi(param.Value);
+        else if (param.Name == "inline_requests")
+          result.InlineRequests = ParseRequests(param.Value);
+        else if (param.Name == "max_pipelined_requests")
+          result.MaxPipelinedRequests = std::stoi(param.Value);
       }
       return result;
     }
@@ -26,7 +26,9 @@
 #include <opc/ua/server/addons/endpoints_services.h>
 #include <opc/ua/server/addons/opcua_protocol.h>
 #include <opc/ua/server/addons/services_registry.h>
+#include <opc/ua/server/subscription_service.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <list>
@@ -43,14 +45,37 @@ namespace OpcUa
 
     using namespace OpcUa::Binary;
 
+    namespace
+    {
+      // Minimal size of a chunk which any UA TCP peer has to accept.
+      const uint32_t MinBufferSize = 8192;
+
+      // Limits of messages accepted from clients, sent to them in Acknowledge.
+      const uint32_t MaxReceiveBufferSize = 65536;
+      const uint32_t MaxRequestMessageSize = 16 * 1024 * 1024;
+      const uint32_t MaxRequestChunkCount = 4096;
+    }
+
+    OpcTcpMessages::OpcTcpMessages(std::shared_ptr<OpcUa::Services> computer, OpcUa::OutputChannel& outputChannel, boost::asio::io_service& io, bool debug)
+      : OpcTcpMessages(computer, outputChannel, debug)
+    {
+      Io = &io;
+    }
+
     OpcTcpMessages::OpcTcpMessages(std::shared_ptr<OpcUa::Services> computer, OpcUa::OutputChannel& outputChannel, bool debug)
       : Server(computer)
+      , Io(nullptr)
       , OutputStream(outputChannel)
       , Debug(debug)
       , ChannelId(1)
       , TokenId(2)
       , SessionId(GenerateSessionId())
       , SequenceNb(0)
+      , SendBufferSize(0)
+      , ReceiveBufferSize(0)
+      , MaxMessageSize(0)
+      , MaxChunkCount(0)
+      , ReceivedChunks(0)
     {
       std::cout << "opc_tcp_processor| Debug is " << Debug << std::endl;
       std::cout << "opc_tcp_processor| SessionId is " << Debug << std::endl;
@@ -70,10 +95,80 @@ namespace OpcUa
       }
     }
 
-    bool OpcTcpMessages::ProcessMessage(MessageType msgType, IStreamBinary& iStream)
+    template <typename AlgorithmHeader, typename Response>
+    void OpcTcpMessages::SendMessage(OStreamBinary& ostream, MessageType type, const AlgorithmHeader& algorithmHeader, const SequenceHeader& sequence, const Response& response)
+    {
+      std::lock_guard<std::mutex> lock(SendMutex);
+      SequenceHeader messageSequence = sequence;
+      messageSequence.SequenceNumber = ++SequenceNb;
+      WriteMessage(ostream, type, algorithmHeader, messageSequence, response);
+    }
+
+    template <typename AlgorithmHeader, typename Response>
+    void OpcTcpMessages::WriteMessage(OStreamBinary& ostream, MessageType type, const AlgorithmHeader& algorithmHeader, const SequenceHeader& sequence, const Response& response)
     {
-      std::lock_guard<std::mutex> lock(ProcessMutex);
+      // Response is serialized once, size of the message is written to the header afterwards.
+      const std::size_t headerPos = ostream.Position();
+      ostream << SecureHeader(type, CHT_SINGLE, ChannelId) << algorithmHeader << sequence;
+      const std::size_t bodyPos = ostream.Position();
+      ostream << response;
+
+      const std::size_t messageSize = ostream.Position() - headerPos;
+      if (SendBufferSize == 0 || messageSize <= SendBufferSize)
+      {
+        ostream.UpdateMessageSize(headerPos);
+        ostream << flush;
+        return;
+      }
+
+      const std::size_t prefixSize = bodyPos - headerPos;
+      if (SendBufferSize <= prefixSize)
+      {
+        throw std::logic_error("opc_tcp_processor| Send buffer size is too small for a message chunk.");
+      }
+      const std::size_t bodySize = messageSize - prefixSize;
+      const std::size_t maxChunkBodySize = SendBufferSize - prefixSize;
+      const std::size_t chunkCount = (bodySize + maxChunkBodySize - 1) / maxChunkBodySize;
+      if ((MaxMessageSize && bodySize > MaxMessageSize) || (MaxChunkCount && chunkCount > MaxChunkCount))
+      {
+        if (Debug) std::clog << "opc_tcp_processor| Response of " << bodySize << " bytes exceeds client limits." << std::endl;
+        ostream.Truncate(headerPos);
+        ServiceFaultResponse fault;
+        fault.Header = response.Header;
+        fault.Header.ServiceResult = StatusCode::BadResponseTooLarge;
+        WriteMessage(ostream, type, algorithmHeader, sequence, fault);
+        return;
+      }
+
+      SendChunks(ostream, type, algorithmHeader, sequence, headerPos, bodyPos, maxChunkBodySize);
+    }
 
+    template <typename AlgorithmHeader>
+    void OpcTcpMessages::SendChunks(OStreamBinary& ostream, MessageType type, const AlgorithmHeader& algorithmHeader, const SequenceHeader& sequence, std::size_t headerPos, std::size_t bodyPos, std::size_t maxChunkBodySize)
+    {
+      // Every chunk repeats the message prefix with its own sequence number and carries next part of the body.
+      const std::vector<char> body(ostream.Data() + bodyPos, ostream.Data() + ostream.Position());
+      ostream.Truncate(headerPos);
+
+      SequenceHeader chunkSequence = sequence;
+      for (std::size_t offset = 0; offset < body.size(); offset += maxChunkBodySize)
+      {
+        const std::size_t chunkBodySize = std::min(maxChunkBodySize, body.size() - offset);
+        const ChunkType chunk = offset + chunkBodySize < body.size() ? CHT_INTERMEDIATE : CHT_SINGLE;
+        if (offset != 0)
+        {
+          chunkSequence.SequenceNumber = ++SequenceNb;
+        }
+
+        const std::size_t chunkPos = ostream.Position();
+        ostream << SecureHeader(type, chunk, ChannelId) << algorithmHeader << chunkSequence << RawMessage(&body[offset], chunkBodySize);
+        ostream.UpdateMessageSize(chunkPos);
+        ostream << flush;
+      }
+    }
+
+    bool OpcTcpMessages::ProcessMessage(MessageType msgType, IStreamBinary& iStream)
+    {
       switch (msgType)
       {
         case MT_HELLO:
@@ -128,34 +223,97 @@ namespace OpcUa
 
     void OpcTcpMessages::ForwardPublishResponse(const PublishResult result)
     {
-      std::lock_guard<std::mutex> lock(ProcessMutex);
-
       if (Debug) std::clog << "opc_tcp_processor| Sending PublishResult to client!" << std::endl;
-      if ( PublishRequestQueue.empty() )
+      PublishRequestElement requestData;
       {
-        std::cerr << "Error trying to send publish response while we do not have data from a PublishRequest" << std::endl;
-        return;
+        std::lock_guard<std::mutex> lock(PublishRequestQueueMutex);
+        if ( PublishRequestQueue.empty() )
+        {
+          std::cerr << "Error trying to send publish response while we do not have data from a PublishRequest" << std::endl;
+          return;
+        }
+        requestData = PublishRequestQueue.front();
+        PublishRequestQueue.pop();
       }
-      PublishRequestElement requestData = PublishRequestQueue.front();
-      PublishRequestQueue.pop();
 
       PublishResponse response;
 
       FillResponseHeader(requestData.requestHeader, response.Header);
       response.Parameters = result;
-     
-      requestData.sequence.SequenceNumber = ++SequenceNb;
 
-      SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-      secureHeader.AddSize(RawSize(requestData.algorithmHeader));
-      secureHeader.AddSize(RawSize(requestData.sequence));
-      secureHeader.AddSize(RawSize(response));
       if (Debug) {
         std::cout << "opc_tcp_processor| Sedning publishResponse with " << response.Parameters.NotificationMessage.NotificationData.size() << " PublishResults" << std::endl;
       }
-      OutputStream << secureHeader << requestData.algorithmHeader << requestData.sequence << response << flush;
+      SendMessage(OutputStream, MT_SECURE_MESSAGE, requestData.algorithmHeader, requestData.sequence, response);
     }
     
+    uint32_t OpcTcpMessages::GetReceiveBufferSize()
+    {
+      std::lock_guard<std::mutex> lock(SendMutex);
+      return ReceiveBufferSize;
+    }
+
+    StatusCode OpcTcpMessages::CheckChunkSize(std::size_t size)
+    {
+      const uint32_t receiveBufferSize = GetReceiveBufferSize();
+      return size > (receiveBufferSize ? receiveBufferSize : MinBufferSize) ? StatusCode::BadTcpMessageTooLarge : StatusCode::Good;
+    }
+
+    StatusCode OpcTcpMessages::AppendChunk(MessageType type, const char* data, std::size_t size, std::vector<char>& message)
+    {
+      if (type != MT_SECURE_OPEN && type != MT_SECURE_MESSAGE && type != MT_SECURE_CLOSE)
+      {
+        return StatusCode::BadTcpMessageTypeInvalid;
+      }
+
+      std::size_t offset = 0;
+      if (message.empty())
+      {
+        ReceivedChunks = 0;
+      }
+      else
+      {
+        // Secure channel id, security header and sequence header.
+        OpcUa::InputFromBuffer chunkChannel(data, size);
+        IStreamBinary chunkStream(chunkChannel);
+        uint32_t channelId = 0;
+        chunkStream >> channelId;
+        if (type == MT_SECURE_OPEN)
+        {
+          AsymmetricAlgorithmHeader algorithmHeader;
+          chunkStream >> algorithmHeader;
+        }
+        else
+        {
+          SymmetricAlgorithmHeader algorithmHeader;
+          chunkStream >> algorithmHeader;
+        }
+        SequenceHeader sequence;
+        chunkStream >> sequence;
+        offset = size - chunkChannel.GetRemainSize();
+      }
+
+      if (++ReceivedChunks > MaxRequestChunkCount || message.size() + size - offset > MaxRequestMessageSize)
+      {
+        return StatusCode::BadTcpMessageTooLarge;
+      }
+      message.insert(message.end(), data + offset, data + size);
+      return StatusCode::Good;
+    }
+
+    void OpcTcpMessages::SendError(StatusCode code, const std::string& reason)
+    {
+      Error error;
+      error.Code = static_cast<uint32_t>(code);
+      error.Reason = reason;
+
+      Header errorHeader(MT_ERROR, CHT_SINGLE);
+      errorHeader.AddSize(RawSize(error));
+
+      std::lock_guard<std::mutex> lock(SendMutex);
+      OutputStream << errorHeader << error << flush;
+    }
+
     void OpcTcpMessages::HelloClient(IStreamBinary& istream, OStreamBinary& ostream)
     {
       using namespace OpcUa::Binary;
@@ -164,11 +322,18 @@ namespace OpcUa
       Hello hello;
       istream >> hello;
 
+      std::lock_guard<std::mutex> lock(SendMutex);
+      // Responses are split to fit client limits, requests have to fit limits of the server.
+      SendBufferSize = std::max<uint32_t>(hello.ReceiveBufferSize, MinBufferSize);
+      MaxMessageSize = hello.MaxMessageSize;
+      MaxChunkCount = hello.MaxChunkCount;
+      ReceiveBufferSize = std::min(std::max<uint32_t>(hello.SendBufferSize, MinBufferSize), MaxReceiveBufferSize);
+
       Acknowledge ack;
-      ack.ReceiveBufferSize = hello.ReceiveBufferSize;
-      ack.SendBufferSize = hello.SendBufferSize;
-      ack.MaxMessageSize = hello.MaxMessageSize;
-      ack.MaxChunkCount = 1;
+      ack.ReceiveBufferSize = ReceiveBufferSize;
+      ack.SendBufferSize = SendBufferSize;
+      ack.MaxMessageSize = MaxRequestMessageSize;
+      ack.MaxChunkCount = MaxRequestChunkCount;
 
       Header ackHeader(MT_ACKNOWLEDGE, CHT_SINGLE);
       ackHeader.AddSize(RawSize(ack));
@@ -205,8 +370,6 @@ namespace OpcUa
         ++TokenId;
       }
 
-      sequence.SequenceNumber = ++SequenceNb;
-
       OpenSecureChannelResponse response;
       FillResponseHeader(request.Header, response.Header);
       response.ChannelSecurityToken.SecureChannelId = ChannelId;
@@ -214,11 +377,7 @@ namespace OpcUa
       response.ChannelSecurityToken.CreatedAt = OpcUa::DateTime::Current();
       response.ChannelSecurityToken.RevisedLifetime = request.Parameters.RequestLifeTime;
 
-      SecureHeader responseHeader(MT_SECURE_OPEN, CHT_SINGLE, ChannelId);
-      responseHeader.AddSize(RawSize(algorithmHeader));
-      responseHeader.AddSize(RawSize(sequence));
-      responseHeader.AddSize(RawSize(response));
-      ostream << responseHeader << algorithmHeader << sequence << response << flush;
+      SendMessage(ostream, MT_SECURE_OPEN, algorithmHeader, sequence, response);
     }
 
     void OpcTcpMessages::CloseChannel(IStreamBinary& istream)
@@ -253,7 +412,6 @@ namespace OpcUa
       RequestHeader requestHeader;
       istream >> requestHeader;
 
-      sequence.SequenceNumber = ++SequenceNb;
 /*
       const std::size_t receivedSize =
         RawSize(channelId) +
@@ -275,11 +433,7 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.Endpoints = Server->Endpoints()->GetEndpoints(filter);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -293,11 +447,7 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.Data.Descriptions = Server->Endpoints()->FindServers(params);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -312,11 +462,7 @@ namespace OpcUa
 
           FillResponseHeader(requestHeader, response.Header);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -354,11 +500,7 @@ namespace OpcUa
           }
           response.Results = values;
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
 
           return;
         }
@@ -381,11 +523,7 @@ namespace OpcUa
             response.Results = std::vector<StatusCode>(params.NodesToWrite.size(), OpcUa::StatusCode::BadNotImplemented);
           }
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
 
           return;
         }
@@ -427,13 +565,8 @@ namespace OpcUa
           TranslateBrowsePathsToNodeIdsResponse response;
           FillResponseHeader(requestHeader, response.Header);
           response.Result.Paths = result;
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to 'Translate Browse Paths To Node Ids' request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -455,11 +588,7 @@ namespace OpcUa
           response.Parameters.ServerEndpoints = Server->Endpoints()->GetEndpoints(epf);
 
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
 
           return;
         }
@@ -472,11 +601,7 @@ namespace OpcUa
           ActivateSessionResponse response;
           FillResponseHeader(requestHeader, response.Header);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -494,11 +619,7 @@ namespace OpcUa
           CloseSessionResponse response;
           FillResponseHeader(requestHeader, response.Header);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           if (Debug) std::clog << "opc_tcp_processor| Session Closed " << std::endl;
           return;
         }
@@ -513,7 +634,7 @@ namespace OpcUa
           CreateSubscriptionResponse response;
           FillResponseHeader(requestHeader, response.Header);
 
-          response.Data = Server->Subscriptions()->CreateSubscription(request, [this](PublishResult i){ 
+          std::function<void (PublishResult)> callback = [this](PublishResult i){ 
                 try
                 {
                   this->ForwardPublishResponse(i); 
@@ -523,15 +644,18 @@ namespace OpcUa
                   // TODO Disconnect client!
                   std::cerr << "Error forwarding publishResult to client: " << ex.what() << std::endl;
                 }
-              });
+              };
+          // Timers of the subscription run at io_service of the connection when the service supports it.
+          SubscriptionServices::SharedPtr subscriptions = Server->Subscriptions();
+          SubscriptionService* service = Io ? dynamic_cast<SubscriptionService*>(subscriptions.get()) : nullptr;
+          response.Data = service ? service->CreateSubscription(request, callback, *Io) : subscriptions->CreateSubscription(request, callback);
 
-          Subscriptions.push_back(response.Data.SubscriptionId); //Keep a link to eventually delete subcriptions when exiting
+          {
+            std::lock_guard<std::mutex> lock(SubscriptionsMutex);
+            Subscriptions.push_back(response.Data.SubscriptionId); //Keep a link to eventually delete subcriptions when exiting
+          }
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -548,13 +672,8 @@ namespace OpcUa
 
           response.Results = Server->Subscriptions()->DeleteSubscriptions(ids);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to Delete Subscription Request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -569,13 +688,8 @@ namespace OpcUa
           response.Results = Server->Subscriptions()->CreateMonitoredItems(params);
 
           FillResponseHeader(requestHeader, response.Header);
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to Create Monitored Items Request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -590,13 +704,8 @@ namespace OpcUa
           response.Results = Server->Subscriptions()->DeleteMonitoredItems(params);
 
           FillResponseHeader(requestHeader, response.Header);
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to Delete Monitored Items Request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -611,11 +720,23 @@ namespace OpcUa
           data.sequence = sequence;
           data.algorithmHeader = algorithmHeader;
           data.requestHeader = requestHeader;
-          PublishRequestQueue.push(data);
-          Server->Subscriptions()->Publish(request);
-
-          --SequenceNb; //We do not send response, so do not increase sequence
+          {
+            // Both queues keep the same order when publish requests of a connection are processed concurrently.
+            // Subscription service keeps as many requests of a session, so they are never dropped by one queue only.
+            std::lock_guard<std::mutex> lock(PublishRequestQueueMutex);
+            if (PublishRequestQueue.size() < MaxPublishRequests)
+            {
+              PublishRequestQueue.push(data);
+              Server->Subscriptions()->Publish(request);
+              return;
+            }
+          }
 
+          PublishResponse response;
+          FillResponseHeader(requestHeader, response.Header);
+          response.Header.ServiceResult = StatusCode::BadTooManyPublishRequests;
+          if (Debug) std::clog << "opc_tcp_processor| Too many publish requests queued, rejecting request." << std::endl;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -630,13 +751,8 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.Result.Results.resize(params.SubscriptionIds.size(), StatusCode::Good);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to 'Set Publishing Mode' request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -652,13 +768,8 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.results = results;
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to 'Add Nodes' request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -674,13 +785,8 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.Results = results;
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to 'Add References' request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -695,13 +801,8 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.Header.ServiceResult = StatusCode::BadMessageNotAvailable;
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::clog << "opc_tcp_processor| Sending response to 'Republish' request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -728,11 +829,7 @@ namespace OpcUa
             }
           }
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
 
           return;
         }
@@ -749,12 +846,8 @@ namespace OpcUa
 
           FillResponseHeader(requestHeader, response.Header);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
           if (Debug) std::clog << "opc_tcp_processor| Sending response to register nodes request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -770,12 +863,8 @@ namespace OpcUa
 
           FillResponseHeader(requestHeader, response.Header);
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
           if (Debug) std::clog << "opc_tcp_processor| Sending response to unregister nodes request." << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
 
@@ -785,13 +874,8 @@ namespace OpcUa
           FillResponseHeader(requestHeader, response.Header);
           response.Header.ServiceResult = StatusCode::BadNotImplemented;
 
-          SecureHeader secureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, ChannelId);
-          secureHeader.AddSize(RawSize(algorithmHeader));
-          secureHeader.AddSize(RawSize(sequence));
-          secureHeader.AddSize(RawSize(response));
-
           if (Debug) std::cerr << "opc_tcp_processor| Sending ServiceFaultResponse to unsupported request of id: " << message << std::endl;
-          ostream << secureHeader << algorithmHeader << sequence << response << flush;
+          SendMessage(ostream, MT_SECURE_MESSAGE, algorithmHeader, sequence, response);
           return;
         }
       }
@@ -807,16 +891,17 @@ namespace OpcUa
     void OpcTcpMessages::DeleteAllSubscriptions()
     {
       std::vector<uint32_t> subs;
-      for (const uint32_t& subid: Subscriptions)
       {
-        subs.push_back(subid);
+        std::lock_guard<std::mutex> lock(SubscriptionsMutex);
+        subs.assign(Subscriptions.begin(), Subscriptions.end());
+        Subscriptions.clear();
       }
       Server->Subscriptions()->DeleteSubscriptions(subs);
-      Subscriptions.clear();
     }
 
     void OpcTcpMessages::DeleteSubscriptions(const std::vector<uint32_t>& ids)
     {
+      std::lock_guard<std::mutex> lock(SubscriptionsMutex);
       for ( auto id : ids )
       {
         Subscriptions.erase(std::remove_if(Subscriptions.begin(), Subscriptions.end(),
@@ -17,6 +17,14 @@
 #include <mutex>
 #include <queue>
 
+namespace boost
+{
+  namespace asio
+  {
+    class io_service;
+  }
+}
+
 namespace OpcUa
 {
   namespace Server
@@ -26,10 +34,29 @@ namespace OpcUa
     {
     public:
       OpcTcpMessages(std::shared_ptr<OpcUa::Services> computer, OpcUa::OutputChannel& outputChannel, bool debug);
+      /// @brief Processor of a connection run at io_service 'io', subscriptions of the connection run there too.
+      OpcTcpMessages(std::shared_ptr<OpcUa::Services> computer, OpcUa::OutputChannel& outputChannel, boost::asio::io_service& io, bool debug);
       ~OpcTcpMessages();
 
       bool ProcessMessage(Binary::MessageType msgType, Binary::IStreamBinary& iStream);
 
+      /// @brief Size of chunks the client sends, negotiated with Hello message, zero before it.
+      uint32_t GetReceiveBufferSize();
+
+      /// @brief Check size of the next chunk of the client against the negotiated buffer size.
+      /// Before Hello only chunks of the minimal buffer size are accepted.
+      /// @return Good or BadTcpMessageTooLarge.
+      StatusCode CheckChunkSize(std::size_t size);
+
+      /// @brief Append chunk of a secure message to chunks of it received before.
+      /// The first chunk is kept with its headers, next ones contribute only their body.
+      /// @return Good, BadTcpMessageTooLarge if message exceeds limits sent in Acknowledge,
+      /// or BadTcpMessageTypeInvalid if the message cannot be split into chunks.
+      StatusCode AppendChunk(Binary::MessageType type, const char* data, std::size_t size, std::vector<char>& message);
+
+      /// @brief Send Error message to the client, the connection has to be closed after it.
+      void SendError(StatusCode code, const std::string& reason);
+
     private:
       void HelloClient(Binary::IStreamBinary& istream, Binary::OStreamBinary& ostream);
       void OpenChannel(Binary::IStreamBinary& istream, Binary::OStreamBinary& ostream);
@@ -40,9 +67,24 @@ namespace OpcUa
       void DeleteAllSubscriptions();
       void ForwardPublishResponse(const PublishResult response);
 
+      /// @brief Write response with the next sequence number.
+      /// Responses are numbered in order they are sent, not in order of requests.
+      template <typename AlgorithmHeader, typename Response>
+      void SendMessage(Binary::OStreamBinary& ostream, Binary::MessageType type, const AlgorithmHeader& algorithmHeader, const Binary::SequenceHeader& sequence, const Response& response);
+
+      template <typename AlgorithmHeader, typename Response>
+      void WriteMessage(Binary::OStreamBinary& ostream, Binary::MessageType type, const AlgorithmHeader& algorithmHeader, const Binary::SequenceHeader& sequence, const Response& response);
+
+      template <typename AlgorithmHeader>
+      void SendChunks(Binary::OStreamBinary& ostream, Binary::MessageType type, const AlgorithmHeader& algorithmHeader, const Binary::SequenceHeader& sequence, std::size_t headerPos, std::size_t bodyPos, std::size_t maxChunkBodySize);
+
     private:
-      std::mutex ProcessMutex;
+      // Secure messages of a connection may be processed concurrently, except
+      // for channel and session messages. Output stream, sequence numbers and
+      // limits of the client are guarded by SendMutex.
+      std::mutex SendMutex;
       std::shared_ptr<OpcUa::Services> Server;
+      boost::asio::io_service* Io;
       OpcUa::Binary::OStreamBinary OutputStream;
       bool Debug;
       uint32_t ChannelId;
@@ -50,6 +92,13 @@ namespace OpcUa
       ExpandedNodeId SessionId;
       //ExpandedNodeId AuthenticationToken;
       uint32_t SequenceNb;
+      // Limits of the client receive side negotiated with Hello message, zero means no limit.
+      uint32_t SendBufferSize;
+      uint32_t ReceiveBufferSize;
+      uint32_t MaxMessageSize;
+      uint32_t MaxChunkCount;
+      // Chunks of the message being reassembled, touched only by the reading thread.
+      uint32_t ReceivedChunks;
 
       struct PublishRequestElement
       {
@@ -58,6 +107,7 @@ namespace OpcUa
         Binary::SymmetricAlgorithmHeader algorithmHeader;
       };
 
+      std::mutex SubscriptionsMutex;
       std::list<uint32_t> Subscriptions; //Keep a list of subscriptions to query internal server at correct rate
       std::mutex PublishRequestQueueMutex;
       std::queue<PublishRequestElement> PublishRequestQueue; //Keep track of request data to answer them when we have data and
@@ -20,6 +20,8 @@
 #include <opc/common/addons_core/addon_manager.h>
 #include <opc/ua/protocol/endpoints.h>
 #include <opc/ua/protocol/input_from_buffer.h>
+#include <opc/ua/protocol/status_codes.h>
+#include <opc/ua/protocol/string_utils.h>
 #include <opc/ua/server/addons/opcua_protocol.h>
 #include <opc/ua/server/addons/endpoints_services.h>
 #include <opc/ua/server/addons/services_registry.h>
@@ -54,10 +56,12 @@ namespace
       if (Debug) std::clog << "opc_tcp_processor| Hello client!" << std::endl;
 
       std::unique_ptr<OpcTcpMessages> messageProcessor(new OpcTcpMessages(Server, *clientChannel, Debug));
+      // Message reassembled from intermediate chunks.
+      std::vector<char> message;
 
       for(;;)
       {
-        ProcessData(*clientChannel, *messageProcessor);
+        ProcessData(*clientChannel, *messageProcessor, message);
       }
     }
 
@@ -66,25 +70,28 @@ namespace
     }
 
   private:
-    void ProcessData(OpcUa::IOChannel& clientChannel, OpcUa::Server::OpcTcpMessages& messageProcessor)
+    void ProcessData(OpcUa::IOChannel& clientChannel, OpcUa::Server::OpcTcpMessages& messageProcessor, std::vector<char>& message)
     {
       using namespace OpcUa::Binary;
 
       IStreamBinary iStream(clientChannel);
-      ProcessChunk(iStream, messageProcessor);
+      ProcessChunk(iStream, messageProcessor, message);
     }
 
-    // TODO implement collecting full message from chunks before processing.
-    void ProcessChunk(IStreamBinary& iStream, OpcTcpMessages& messageProcessor)
+    void ProcessChunk(IStreamBinary& iStream, OpcTcpMessages& messageProcessor, std::vector<char>& message)
     {
       if (Debug) std::cout << "opc_tcp_processor| Processing new chunk." << std::endl;
       Header hdr;
       // Receive message header.
       iStream >> hdr;
+      if (messageProcessor.CheckChunkSize(hdr.Size) != StatusCode::Good)
+      {
+        Reject(messageProcessor, StatusCode::BadTcpMessageTooLarge, "Chunk exceeds receive buffer size.");
+      }
 
-      // Receive full message.
+      // Receive full chunk.
       std::vector<char> buffer(hdr.MessageSize());
-      OpcUa::Binary::RawBuffer buf(&buffer[0], buffer.size());
+      OpcUa::Binary::RawBuffer buf(buffer.data(), buffer.size());
       iStream >> buf;
       if (Debug)
       {
@@ -92,8 +99,29 @@ namespace
         PrintBlob(buffer);
       }
 
+      if (hdr.Chunk == CHT_FINAL)
+      {
+        if (Debug) std::clog << "opc_tcp_processor| Client aborted message." << std::endl;
+        message.clear();
+        return;
+      }
+      if (hdr.Chunk == CHT_INTERMEDIATE || !message.empty())
+      {
+        const StatusCode status = messageProcessor.AppendChunk(hdr.Type, buffer.data(), buffer.size(), message);
+        if (status != StatusCode::Good)
+        {
+          Reject(messageProcessor, status, "Message cannot be assembled from chunks.");
+        }
+        if (hdr.Chunk == CHT_INTERMEDIATE)
+        {
+          return;
+        }
+        buffer.swap(message);
+        message.clear();
+      }
+
       // restrict server size code only with current message.
-      OpcUa::InputFromBuffer messageChannel(&buffer[0], buffer.size());
+      OpcUa::InputFromBuffer messageChannel(buffer.data(), buffer.size());
       IStreamBinary messageStream(messageChannel);
       messageProcessor.ProcessMessage(hdr.Type, messageStream);
 
@@ -103,6 +131,13 @@ namespace
       }
     }
 
+    // Answer with Error message and stop processing the connection.
+    void Reject(OpcTcpMessages& messageProcessor, StatusCode code, const std::string& reason)
+    {
+      messageProcessor.SendError(code, reason);
+      throw std::runtime_error("opc_tcp_processor| " + reason + " " + OpcUa::ToString(code));
+    }
+
   private:
     OpcUa::Services::SharedPtr Server;
     bool Debug;
@@ -0,0 +1,239 @@
+/// @brief Shared publishing timer of subscriptions.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include "publishing_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  const std::size_t WheelSize = 512;
+  const std::size_t BatchSize = 64;
+}
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    PublishingScheduler::Wheel::Wheel(boost::asio::io_service& io)
+      : Io(io)
+      , Timer(io)
+      , Slots(WheelSize)
+    {
+    }
+
+    void PublishingScheduler::Wheel::Insert(uint32_t handle, Entry& entry, uint64_t due)
+    {
+      entry.Due = due;
+      Slots[due % Slots.size()].push_back(DueEntry{handle, due});
+    }
+
+    uint64_t PublishingScheduler::Wheel::NextDue(const Entry& entry) const
+    {
+      // First publishing interval boundary after current tick.
+      const uint64_t periods = (Current - entry.LastFire) / entry.Interval + 1;
+      return entry.LastFire + periods * entry.Interval;
+    }
+
+    PublishingScheduler::PublishingScheduler(boost::asio::io_service& io)
+      : Timers(std::make_shared<Wheel>(io))
+    {
+    }
+
+    PublishingScheduler::~PublishingScheduler()
+    {
+      std::unique_lock<std::mutex> lock(Timers->Mutex);
+      Timers->Stopped = true;
+      Timers->Entries.clear();
+      Timers->Timer.cancel();
+    }
+
+    uint32_t PublishingScheduler::AddSubscription(double interval, PublishCallback callback)
+    {
+      std::unique_lock<std::mutex> lock(Timers->Mutex);
+      Entry entry;
+      entry.Interval = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(interval / Resolution)));
+      entry.LastFire = Timers->Current;
+      entry.Running = false;
+      entry.Woken = false;
+      entry.Callback = callback;
+
+      const uint32_t handle = ++Timers->LastHandle;
+      Entry& inserted = Timers->Entries[handle] = entry;
+      Timers->Insert(handle, inserted, Timers->Current + inserted.Interval);
+      if (!Timers->Armed)
+      {
+        Timers->Armed = true;
+        Arm(Timers);
+      }
+      return handle;
+    }
+
+    void PublishingScheduler::RemoveSubscription(uint32_t handle)
+    {
+      // Stale references in the slots are skipped when their tick comes.
+      std::unique_lock<std::mutex> lock(Timers->Mutex);
+      Timers->Entries.erase(handle);
+    }
+
+    void PublishingScheduler::Wake(uint32_t handle)
+    {
+      std::unique_lock<std::mutex> lock(Timers->Mutex);
+      auto it = Timers->Entries.find(handle);
+      if (it == Timers->Entries.end())
+      {
+        return;
+      }
+      Entry& entry = it->second;
+      if (entry.Running)
+      {
+        entry.Woken = true;
+        return;
+      }
+      const uint64_t due = Timers->NextDue(entry);
+      if (due < entry.Due)
+      {
+        Timers->Insert(handle, entry, due);
+      }
+    }
+
+    void PublishingScheduler::Arm(std::shared_ptr<Wheel> wheel)
+    {
+      wheel->Timer.expires_from_now(boost::posix_time::milliseconds(Resolution));
+      wheel->Timer.async_wait([wheel](const boost::system::error_code& error)
+        {
+          Tick(wheel, error);
+        });
+    }
+
+    void PublishingScheduler::Tick(std::shared_ptr<Wheel> wheel, const boost::system::error_code& error)
+    {
+      if (error)
+      {
+        return;
+      }
+
+      std::unique_lock<std::mutex> lock(wheel->Mutex);
+      if (wheel->Stopped)
+      {
+        return;
+      }
+
+      const uint64_t tick = ++wheel->Current;
+      std::vector<DueEntry> slot;
+      slot.swap(wheel->Slots[tick % wheel->Slots.size()]);
+
+      std::shared_ptr<std::vector<FiredEntry>> batch;
+      for (const DueEntry& due : slot)
+      {
+        auto it = wheel->Entries.find(due.Handle);
+        if (it == wheel->Entries.end() || it->second.Due != due.Due)
+        {
+          continue; // removed or rescheduled
+        }
+        Entry& entry = it->second;
+        if (due.Due != tick)
+        {
+          wheel->Slots[tick % wheel->Slots.size()].push_back(due); // due in a later round
+          continue;
+        }
+        if (entry.Running)
+        {
+          continue;
+        }
+
+        entry.Running = true;
+        entry.Woken = false;
+        if (!batch)
+        {
+          batch = std::make_shared<std::vector<FiredEntry>>();
+          batch->reserve(BatchSize);
+        }
+        batch->push_back(FiredEntry{due.Handle, static_cast<uint32_t>((tick - entry.LastFire) / entry.Interval), entry.Callback});
+        entry.LastFire = tick;
+        if (batch->size() == BatchSize)
+        {
+          wheel->Io.post([wheel, tick, batch]() { Fire(wheel, tick, batch); });
+          batch.reset();
+        }
+      }
+      if (batch)
+      {
+        wheel->Io.post([wheel, tick, batch]() { Fire(wheel, tick, batch); });
+      }
+
+      if (wheel->Entries.empty())
+      {
+        wheel->Armed = false;
+        return;
+      }
+      wheel->Timer.expires_at(wheel->Timer.expires_at() + boost::posix_time::milliseconds(Resolution));
+      wheel->Timer.async_wait([wheel](const boost::system::error_code& error)
+        {
+          Tick(wheel, error);
+        });
+    }
+
+    void PublishingScheduler::Fire(std::shared_ptr<Wheel> wheel, uint64_t tick, std::shared_ptr<std::vector<FiredEntry>> batch)
+    {
+      std::vector<uint32_t> sleeps;
+      sleeps.reserve(batch->size());
+      for (const FiredEntry& fired : *batch)
+      {
+        uint32_t sleep = 1;
+        try
+        {
+          sleep = fired.Callback(fired.Periods);
+        }
+        catch (const std::exception& exc)
+        {
+          std::cerr << "PublishingScheduler | Publishing failed: " << exc.what() << std::endl;
+        }
+        sleeps.push_back(sleep);
+      }
+
+      std::unique_lock<std::mutex> lock(wheel->Mutex);
+      if (wheel->Stopped)
+      {
+        return;
+      }
+      for (std::size_t i = 0; i < batch->size(); ++i)
+      {
+        const uint32_t handle = (*batch)[i].Handle;
+        auto it = wheel->Entries.find(handle);
+        if (it == wheel->Entries.end())
+        {
+          continue;
+        }
+        Entry& entry = it->second;
+        entry.Running = false;
+        uint32_t sleep = sleeps[i];
+        if (sleep == 0)
+        {
+          wheel->Entries.erase(it);
+          continue;
+        }
+        if (entry.Woken)
+        {
+          sleep = 1;
+        }
+        // Slow publishing may have missed the wanted tick, take the next boundary then.
+        wheel->Insert(handle, entry, std::max(tick + sleep * entry.Interval, wheel->NextDue(entry)));
+      }
+      if (!wheel->Entries.empty() && !wheel->Armed)
+      {
+        wheel->Armed = true;
+        Arm(wheel);
+      }
+    }
+
+  }
+}
@@ -0,0 +1,100 @@
+/// @brief Shared publishing timer of subscriptions.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    /// @brief Fires publishing cycles of all subscriptions from one timer.
+    /// Subscriptions are kept in a hashed timing wheel with a slot per tick.
+    /// A subscription is only visited on ticks it is due, so idle subscriptions
+    /// may sleep several publishing intervals until their keep-alive is due.
+    /// Due subscriptions are handed to the io_service in batches, so all
+    /// threads running it share the work.
+    class PublishingScheduler
+    {
+      public:
+        /// @brief Called with number of publishing intervals passed since previous call.
+        /// @return number of publishing intervals until next call, zero stops publishing.
+        typedef std::function<uint32_t(uint32_t periods)> PublishCallback;
+
+        /// @brief Length of one tick in milliseconds, publishing intervals are rounded up to it.
+        static const uint32_t Resolution = 5;
+
+        explicit PublishingScheduler(boost::asio::io_service& io);
+        ~PublishingScheduler();
+
+        /// @brief Start publishing cycles every 'interval' milliseconds.
+        /// @return handle for Wake and RemoveSubscription.
+        uint32_t AddSubscription(double interval, PublishCallback callback);
+        void RemoveSubscription(uint32_t handle);
+        /// @brief Bring a sleeping subscription back to its next publishing interval.
+        void Wake(uint32_t handle);
+
+      private:
+        struct Entry
+        {
+          uint64_t Interval; // in ticks
+          uint64_t LastFire;
+          uint64_t Due;
+          bool Running;
+          bool Woken;
+          PublishCallback Callback;
+        };
+
+        struct DueEntry
+        {
+          uint32_t Handle;
+          uint64_t Due;
+        };
+
+        struct FiredEntry
+        {
+          uint32_t Handle;
+          uint32_t Periods;
+          PublishCallback Callback;
+        };
+
+        struct Wheel
+        {
+          explicit Wheel(boost::asio::io_service& io);
+
+          void Insert(uint32_t handle, Entry& entry, uint64_t due);
+          uint64_t NextDue(const Entry& entry) const;
+
+          boost::asio::io_service& Io;
+          boost::asio::deadline_timer Timer;
+          std::mutex Mutex;
+          std::vector<std::vector<DueEntry>> Slots;
+          std::map<uint32_t, Entry> Entries;
+          uint64_t Current = 0;
+          uint32_t LastHandle = 0;
+          bool Armed = false;
+          bool Stopped = false;
+        };
+
+        static void Arm(std::shared_ptr<Wheel> wheel);
+        static void Tick(std::shared_ptr<Wheel> wheel, const boost::system::error_code& error);
+        static void Fire(std::shared_ptr<Wheel> wheel, uint64_t tick, std::shared_ptr<std::vector<FiredEntry>> batch);
+
+      private:
+        std::shared_ptr<Wheel> Timers;
+    };
+
+  }
+}
@@ -0,0 +1,145 @@
+/// @brief Periodic sampling of monitored items.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include "sampling_scheduler.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    SamplingScheduler::SamplingScheduler(Server::AddressSpace::SharedPtr addressSpace, boost::asio::io_service& io)
+      : AddressSpace(addressSpace)
+      , Io(io)
+    {
+    }
+
+    SamplingScheduler::~SamplingScheduler()
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      for (auto& group : Groups)
+      {
+        std::unique_lock<std::mutex> groupLock(group.second->Mutex);
+        group.second->Stopped = true;
+        group.second->Timer.cancel();
+      }
+    }
+
+    uint32_t SamplingScheduler::AddItem(const ReadValueId& item, uint32_t interval, SampleCallback callback)
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      const uint32_t handle = ++LastHandle;
+      ItemIntervals[handle] = interval;
+
+      std::shared_ptr<Group>& group = Groups[interval];
+      const bool isNew = !group;
+      if (isNew)
+      {
+        group = std::make_shared<Group>(Io, interval);
+      }
+
+      std::unique_lock<std::mutex> groupLock(group->Mutex);
+      group->Items.push_back(SampledItem{handle, item, callback});
+      if (isNew)
+      {
+        group->Timer.expires_from_now(boost::posix_time::milliseconds(interval));
+        Schedule(group, AddressSpace);
+      }
+      return handle;
+    }
+
+    void SamplingScheduler::RemoveItem(uint32_t handle)
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      auto intervalIt = ItemIntervals.find(handle);
+      if (intervalIt == ItemIntervals.end())
+      {
+        return;
+      }
+      auto groupIt = Groups.find(intervalIt->second);
+      ItemIntervals.erase(intervalIt);
+      if (groupIt == Groups.end())
+      {
+        return;
+      }
+
+      std::shared_ptr<Group> group = groupIt->second;
+      std::unique_lock<std::mutex> groupLock(group->Mutex);
+      group->Items.erase(std::remove_if(group->Items.begin(), group->Items.end(), [handle](const SampledItem& item) { return item.Handle == handle; }), group->Items.end());
+      if (group->Items.empty())
+      {
+        group->Stopped = true;
+        group->Timer.cancel();
+        Groups.erase(groupIt);
+      }
+    }
+
+    void SamplingScheduler::Schedule(std::shared_ptr<Group> group, Server::AddressSpace::SharedPtr addressSpace)
+    {
+      group->Timer.async_wait([group, addressSpace](const boost::system::error_code& error)
+        {
+          Sample(group, addressSpace, error);
+        });
+    }
+
+    void SamplingScheduler::Sample(std::shared_ptr<Group> group, Server::AddressSpace::SharedPtr addressSpace, const boost::system::error_code& error)
+    {
+      if (error)
+      {
+        return;
+      }
+
+      ReadParameters params;
+      std::vector<SampleCallback> callbacks;
+      {
+        std::unique_lock<std::mutex> lock(group->Mutex);
+        if (group->Stopped)
+        {
+          return;
+        }
+        params.AttributesToRead.reserve(group->Items.size());
+        callbacks.reserve(group->Items.size());
+        for (const SampledItem& item : group->Items)
+        {
+          params.AttributesToRead.push_back(item.Item);
+          callbacks.push_back(item.Callback);
+        }
+      }
+
+      // Value callbacks of the nodes and subscriptions are called without holding the group lock.
+      try
+      {
+        const std::vector<DataValue> values = addressSpace->Read(params);
+        for (std::size_t i = 0; i < values.size() && i < callbacks.size(); ++i)
+        {
+          callbacks[i](values[i]);
+        }
+      }
+      catch (const std::exception& exc)
+      {
+        std::cerr << "SamplingScheduler | Failed to sample values: " << exc.what() << std::endl;
+      }
+
+      std::unique_lock<std::mutex> lock(group->Mutex);
+      if (group->Stopped)
+      {
+        return;
+      }
+      // Samples missed while the thread was busy are skipped, not taken in a burst.
+      const boost::posix_time::milliseconds interval(group->Interval);
+      const boost::posix_time::ptime now = boost::asio::deadline_timer::traits_type::now();
+      const boost::posix_time::ptime next = group->Timer.expires_at() + interval;
+      group->Timer.expires_at(next > now ? next : now + interval);
+      Schedule(group, addressSpace);
+    }
+
+  }
+}
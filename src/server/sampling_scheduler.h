@@ -0,0 +1,78 @@
+/// @brief Periodic sampling of monitored items.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#pragma once
+
+#include <opc/ua/server/address_space.h>
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    /// @brief Samples values of monitored items from the address space.
+    /// Items with the same sampling interval share one timer and are read
+    /// from the address space with a single Read call on every tick.
+    class SamplingScheduler
+    {
+      public:
+        typedef std::function<void(const DataValue&)> SampleCallback;
+
+        SamplingScheduler(Server::AddressSpace::SharedPtr addressSpace, boost::asio::io_service& io);
+        ~SamplingScheduler();
+
+        /// @brief Start sampling of the item every 'interval' milliseconds.
+        /// @return handle for RemoveItem.
+        uint32_t AddItem(const ReadValueId& item, uint32_t interval, SampleCallback callback);
+        void RemoveItem(uint32_t handle);
+
+      private:
+        struct SampledItem
+        {
+          uint32_t Handle;
+          ReadValueId Item;
+          SampleCallback Callback;
+        };
+
+        // Items sampled with the same interval.
+        struct Group
+        {
+          Group(boost::asio::io_service& io, uint32_t interval)
+            : Interval(interval)
+            , Timer(io)
+          {
+          }
+
+          const uint32_t Interval;
+          boost::asio::deadline_timer Timer;
+          std::mutex Mutex;
+          std::vector<SampledItem> Items;
+          bool Stopped = false;
+        };
+
+        static void Sample(std::shared_ptr<Group> group, Server::AddressSpace::SharedPtr addressSpace, const boost::system::error_code& error);
+        static void Schedule(std::shared_ptr<Group> group, Server::AddressSpace::SharedPtr addressSpace);
+
+      private:
+        Server::AddressSpace::SharedPtr AddressSpace;
+        boost::asio::io_service& Io;
+        std::mutex Mutex;
+        std::map<uint32_t, std::shared_ptr<Group>> Groups; // by interval
+        std::map<uint32_t, uint32_t> ItemIntervals; // by handle
+        uint32_t LastHandle = 0;
+    };
+
+  }
+}
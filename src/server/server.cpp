@@ -18,6 +18,7 @@
 
 #include <opc/ua/server/server.h>
 
+#include <opc/ua/server/addons/address_space.h>
 #include <opc/ua/server/addons/common_addons.h>
 #include <opc/ua/protocol/string_utils.h>
 
@@ -140,6 +141,13 @@ namespace OpcUa
     return Node(Registry->GetServer(), nodeid);
   }
 
+  Server::ValueSlot::SharedPtr UaServer::GetValueSlot(const NodeId& nodeid) const
+  {
+    CheckStarted();
+    Server::AddressSpace::SharedPtr addressSpace = Addons->GetAddon<Server::AddressSpace>(Server::AddressSpaceRegistryAddonId);
+    return addressSpace->GetValueSlot(nodeid, AttributeId::Value);
+  }
+
   Node UaServer::GetNodeFromPath(const std::vector<QualifiedName>& path) const
   {
     return GetRootNode().GetChild(path);
@@ -55,6 +55,11 @@ namespace
       return Subscriptions->CreateSubscription(request, callback);
     }
 
+    OpcUa::SubscriptionData CreateSubscription(const OpcUa::CreateSubscriptionRequest& request, std::function<void (OpcUa::PublishResult)> callback, boost::asio::io_service& io)
+    {
+      return Subscriptions->CreateSubscription(request, callback, io);
+    }
+
     std::vector<OpcUa::StatusCode> DeleteSubscriptions(const std::vector<uint32_t>& subscriptions)
     {
       return Subscriptions->DeleteSubscriptions(subscriptions);
@@ -10,6 +10,7 @@
 #include "subscription_service_internal.h"
 
 #include <boost/thread/locks.hpp>
+#include <algorithm>
 
 namespace
 {
@@ -47,9 +48,15 @@ namespace OpcUa
       return *AddressSpace;
     }
 
-    boost::asio::io_service& SubscriptionServiceInternal::GetIOService()
+    SubscriptionReactor& SubscriptionServiceInternal::GetReactor(boost::asio::io_service& ioService)
     {
-      return io;
+      std::unique_lock<std::mutex> lock(ReactorsMutex);
+      std::unique_ptr<SubscriptionReactor>& reactor = Reactors[&ioService];
+      if (!reactor)
+      {
+        reactor.reset(new SubscriptionReactor(AddressSpace, ioService));
+      }
+      return *reactor;
     }
 
     void SubscriptionServiceInternal::DeleteAllSubscriptions()
@@ -91,6 +98,12 @@ namespace OpcUa
 
     SubscriptionData SubscriptionServiceInternal::CreateSubscription(const CreateSubscriptionRequest& request, std::function<void (PublishResult)> callback)
     {
+      return CreateSubscription(request, callback, io);
+    }
+
+    SubscriptionData SubscriptionServiceInternal::CreateSubscription(const CreateSubscriptionRequest& request, std::function<void (PublishResult)> callback, boost::asio::io_service& ioService)
+    {
+      SubscriptionReactor& reactor = GetReactor(ioService);
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
 
       SubscriptionData data;
@@ -100,7 +113,7 @@ namespace OpcUa
       data.RevisedMaxKeepAliveCount = request.Parameters.RequestedMaxKeepAliveCount;
       if (Debug) std::cout << "SubscriptionService | Creating Subscription with Id: " << data.SubscriptionId << std::endl;
 
-      std::shared_ptr<InternalSubscription> sub(new InternalSubscription(*this, data, request.Header.SessionAuthenticationToken, callback, Debug));
+      std::shared_ptr<InternalSubscription> sub(new InternalSubscription(*this, reactor, data, request.Parameters.MaxNotificationsPerPublish, request.Header.SessionAuthenticationToken, callback, Debug));
       sub->Start();
       SubscriptionsMap[data.SubscriptionId] = sub;
       return data;
@@ -157,11 +170,19 @@ namespace OpcUa
     {
       boost::unique_lock<boost::shared_mutex> lock(DbMutex);
 
-      if ( PublishRequestQueues[request.Header.SessionAuthenticationToken] < 100 )
       {
-        PublishRequestQueues[request.Header.SessionAuthenticationToken] += 1;
+        std::unique_lock<std::mutex> queueLock(PublishRequestMutex);
+        std::deque<PublishRequest>& queue = PublishRequestQueues[request.Header.SessionAuthenticationToken];
+        if ( queue.size() < Server::MaxPublishRequests )
+        {
+          queue.push_back(request);
+        }
+        else
+        {
+          // Protocol layer answers such requests before they get here.
+          std::cout << "SubscriptionService | Publish request queue is full for session: " << request.Header.SessionAuthenticationToken << std::endl;
+        }
       }
-      //FIXME: else spec says we should return error to warn client
 
       for (SubscriptionAcknowledgement ack:  request.SubscriptionAcknowledgements)
       {
@@ -171,6 +192,15 @@ namespace OpcUa
           sub_it->second->NewAcknowlegment(ack);
         }
       }
+
+      // Subscriptions which waited for a publish request are answered without waiting for their next cycle.
+      for (auto sub : SubscriptionsMap)
+      {
+        if ( sub.second->GetSession() == request.Header.SessionAuthenticationToken )
+        {
+          sub.second->PublishIfLate();
+        }
+      }
     }
 
     RepublishResponse SubscriptionServiceInternal::Republish(const RepublishParameters& params)
@@ -188,9 +218,17 @@ namespace OpcUa
     }
 
 
+    bool SubscriptionServiceInternal::HasPublishRequest(const NodeId& node)
+    {
+      std::unique_lock<std::mutex> lock(PublishRequestMutex);
+      std::map<NodeId, std::deque<PublishRequest>>::iterator queue_it = PublishRequestQueues.find(node);
+      return queue_it != PublishRequestQueues.end() && ! queue_it->second.empty();
+    }
+
     bool SubscriptionServiceInternal::PopPublishRequest(NodeId node)
     {
-      std::map<NodeId, uint32_t>::iterator queue_it = PublishRequestQueues.find(node);
+      std::unique_lock<std::mutex> lock(PublishRequestMutex);
+      std::map<NodeId, std::deque<PublishRequest>>::iterator queue_it = PublishRequestQueues.find(node);
       if ( queue_it == PublishRequestQueues.end() )
       {
         std::cout << "SubscriptionService | Error request for publish queue for unknown session: " << node << " queue are available for: ";
@@ -202,14 +240,14 @@ namespace OpcUa
       }
       else
       {
-        if ( queue_it->second == 0 )
+        if ( queue_it->second.empty() )
         {
           std::cout << "SubscriptionService | Missing publish request, cannot send response for session: " << node << std::endl;
           return false;
         }
         else
         {
-          --queue_it->second;
+          queue_it->second.pop_front();
           return true;
         }
       }
@@ -217,8 +255,6 @@ namespace OpcUa
 
     void SubscriptionServiceInternal::TriggerEvent(NodeId node, Event event)
     {
-      boost::shared_lock<boost::shared_mutex> lock(DbMutex);
-
       //A new id must be generated every time we trigger an event, 
       //if user have not set it manually we force something
       if ( event.EventId.Data.empty() ) 
@@ -226,11 +262,58 @@ namespace OpcUa
         event.EventId = GenerateEventId();
       }
 
-      for (auto sub : SubscriptionsMap)
+      // Only monitored items of the node are visited, subscriptions are locked without holding the index.
+      std::shared_ptr<const std::vector<EventListener>> listeners;
       {
-        sub.second->TriggerEvent(node, event);
+        boost::shared_lock<boost::shared_mutex> lock(EventListenersMutex);
+        EventListenersMap::const_iterator it = EventListeners.find(node);
+        if ( it == EventListeners.end() )
+        {
+          if (Debug) std::cout << "SubscriptionService | No monitored items for events of node " << node << std::endl;
+          return;
+        }
+        listeners = it->second;
       }
 
+      for (const EventListener& listener : *listeners)
+      {
+        if (std::shared_ptr<InternalSubscription> subscription = listener.Subscription.lock())
+        {
+          subscription->EnqueueEvent(listener.MonitoredItemId, event);
+        }
+      }
+    }
+
+    void SubscriptionServiceInternal::AddEventListener(const NodeId& node, std::shared_ptr<InternalSubscription> subscription, uint32_t monitoredItemId)
+    {
+      boost::unique_lock<boost::shared_mutex> lock(EventListenersMutex);
+      std::shared_ptr<const std::vector<EventListener>>& current = EventListeners[node];
+      std::shared_ptr<std::vector<EventListener>> listeners = current ? std::make_shared<std::vector<EventListener>>(*current) : std::make_shared<std::vector<EventListener>>();
+      listeners->push_back(EventListener{subscription, subscription.get(), monitoredItemId});
+      current = listeners;
+    }
+
+    void SubscriptionServiceInternal::RemoveEventListener(const NodeId& node, const InternalSubscription* subscription, uint32_t monitoredItemId)
+    {
+      boost::unique_lock<boost::shared_mutex> lock(EventListenersMutex);
+      EventListenersMap::iterator it = EventListeners.find(node);
+      if ( it == EventListeners.end() )
+      {
+        return;
+      }
+      std::shared_ptr<std::vector<EventListener>> listeners = std::make_shared<std::vector<EventListener>>(*it->second);
+      listeners->erase(std::remove_if(listeners->begin(), listeners->end(), [subscription, monitoredItemId](const EventListener& listener)
+        {
+          return listener.Owner == subscription && listener.MonitoredItemId == monitoredItemId;
+        }), listeners->end());
+      if ( listeners->empty() )
+      {
+        EventListeners.erase(it);
+      }
+      else
+      {
+        it->second = listeners;
+      }
     }
 
   } // namespace Internal
@@ -11,6 +11,8 @@
 
 #include "address_space_addon.h"
 #include "internal_subscription.h"
+#include "publishing_scheduler.h"
+#include "sampling_scheduler.h"
 
 
 #include <opc/ua/server/subscription_service.h>
@@ -26,6 +28,7 @@
 #include <limits>
 #include <list>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <deque>
 #include <set>
@@ -40,6 +43,33 @@ namespace OpcUa
 
     typedef std::map <uint32_t, std::shared_ptr<InternalSubscription>> SubscriptionsIdMap; // Map SubscptioinId, SubscriptionData
 
+    // Event monitored item of a subscription.
+    struct EventListener
+    {
+      std::weak_ptr<InternalSubscription> Subscription;
+      const InternalSubscription* Owner;
+      uint32_t MonitoredItemId;
+    };
+
+    // Lists are replaced on change, so events are fanned out from a snapshot without copying it.
+    typedef std::map<NodeId, std::shared_ptr<const std::vector<EventListener>>> EventListenersMap; // by notifier node
+
+
+    // Publishing and sampling timers of subscriptions created at one io_service.
+    struct SubscriptionReactor
+    {
+      SubscriptionReactor(Server::AddressSpace::SharedPtr addressSpace, boost::asio::io_service& io)
+        : Io(io)
+        , Sampler(addressSpace, io)
+        , Publisher(io)
+      {
+      }
+
+      boost::asio::io_service& Io;
+      SamplingScheduler Sampler;
+      PublishingScheduler Publisher;
+    };
+
 
     class SubscriptionServiceInternal : public Server::SubscriptionService
     {
@@ -50,17 +80,23 @@ namespace OpcUa
 
         virtual std::vector<StatusCode> DeleteSubscriptions(const std::vector<uint32_t>& subscriptions);
         virtual SubscriptionData CreateSubscription(const CreateSubscriptionRequest& request, std::function<void (PublishResult)> callback);
+        virtual SubscriptionData CreateSubscription(const CreateSubscriptionRequest& request, std::function<void (PublishResult)> callback, boost::asio::io_service& io);
         virtual std::vector<MonitoredItemCreateResult> CreateMonitoredItems(const MonitoredItemsParameters& params);
         virtual std::vector<StatusCode> DeleteMonitoredItems(const DeleteMonitoredItemsParameters& params);
         virtual void Publish(const PublishRequest& request);
         virtual RepublishResponse Republish(const RepublishParameters& request);
 
         void DeleteAllSubscriptions();
-        boost::asio::io_service& GetIOService();
         bool PopPublishRequest(NodeId node);
+        bool HasPublishRequest(const NodeId& node);
         void TriggerEvent(NodeId node, Event event);
+        void AddEventListener(const NodeId& node, std::shared_ptr<InternalSubscription> subscription, uint32_t monitoredItemId);
+        void RemoveEventListener(const NodeId& node, const InternalSubscription* subscription, uint32_t monitoredItemId);
         Server::AddressSpace& GetAddressSpace();
 
+      private:
+        SubscriptionReactor& GetReactor(boost::asio::io_service& io);
+
       private:
         boost::asio::io_service& io;
         Server::AddressSpace::SharedPtr AddressSpace;
@@ -68,7 +104,14 @@ namespace OpcUa
         mutable boost::shared_mutex DbMutex;
         SubscriptionsIdMap SubscriptionsMap; // Map SubscptioinId, SubscriptionData
         uint32_t LastSubscriptionId = 2;
-        std::map<NodeId, uint32_t> PublishRequestQueues;
+        std::mutex PublishRequestMutex;
+        std::map<NodeId, std::deque<PublishRequest>> PublishRequestQueues; // by session
+
+        mutable boost::shared_mutex EventListenersMutex;
+        EventListenersMap EventListeners;
+        // Reactors are kept until the service is destroyed, there is one per io_service.
+        std::mutex ReactorsMutex;
+        std::map<boost::asio::io_service*, std::unique_ptr<SubscriptionReactor>> Reactors;
     };
 
 
@@ -0,0 +1,73 @@
+/// @brief Queue of outgoing messages of a connection.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include "write_queue.h"
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    WriteQueue::WriteQueue(std::size_t maxFree, std::size_t maxFreeSize)
+      : MaxFree(maxFree)
+      , MaxFreeSize(maxFreeSize)
+    {
+    }
+
+    bool WriteQueue::Push(const char* message, std::size_t size)
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      if (Free.empty())
+      {
+        Pending.emplace_back(message, message + size);
+      }
+      else
+      {
+        Pending.push_back(std::move(Free.back()));
+        Free.pop_back();
+        Pending.back().assign(message, message + size);
+      }
+
+      if (WriteInProgress)
+      {
+        return false;
+      }
+      WriteInProgress = true;
+      return true;
+    }
+
+    const std::vector<std::vector<char>>& WriteQueue::Take()
+    {
+      // Writing is touched only by the single write in flight.
+      std::unique_lock<std::mutex> lock(Mutex);
+      Writing.swap(Pending);
+      return Writing;
+    }
+
+    bool WriteQueue::Written()
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      for (std::vector<char>& data : Writing)
+      {
+        if (Free.size() == MaxFree)
+        {
+          break;
+        }
+        if (data.capacity() <= MaxFreeSize)
+        {
+          Free.push_back(std::move(data));
+        }
+      }
+      Writing.clear();
+
+      WriteInProgress = !Pending.empty();
+      return WriteInProgress;
+    }
+
+  }
+}
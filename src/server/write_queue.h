@@ -0,0 +1,51 @@
+/// @brief Queue of outgoing messages of a connection.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace OpcUa
+{
+  namespace Internal
+  {
+
+    /// @brief Messages waiting to be written to a socket.
+    /// Only one write is in flight at a time. Messages queued meanwhile are
+    /// taken together by the next write, so they go out as one gathered write
+    /// in order they were queued. Buffers of written messages are reused.
+    class WriteQueue
+    {
+      public:
+        /// @param maxFree number of buffers of written messages kept for reuse.
+        /// @param maxFreeSize larger buffers are released after they are written.
+        WriteQueue(std::size_t maxFree, std::size_t maxFreeSize);
+
+        /// @brief Queue copy of the message.
+        /// @return true if no write is in flight, then caller should start one with Take.
+        bool Push(const char* message, std::size_t size);
+        /// @brief Messages queued since the previous write, in order of Push.
+        /// They stay valid until Written is called.
+        const std::vector<std::vector<char>>& Take();
+        /// @brief Write of taken messages finished.
+        /// @return true if more messages were queued meanwhile, then caller should write them with Take.
+        bool Written();
+
+      private:
+        const std::size_t MaxFree;
+        const std::size_t MaxFreeSize;
+        std::mutex Mutex;
+        std::vector<std::vector<char>> Pending;
+        std::vector<std::vector<char>> Writing;
+        std::vector<std::vector<char>> Free;
+        bool WriteInProgress = false;
+    };
+
+  }
+}
@@ -183,9 +183,9 @@ TEST_F(OpcBinaryHandshake, GetCreateSession)
   OpcUa::Binary::CreateSessionResponse response;
   ASSERT_NO_THROW(stream >> response);
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CREATE_SESSION_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SESSION_RESPONSE);
 }
 
 //----------------------------------------------------------------------
@@ -321,11 +321,9 @@ TEST_F(OpcBinaryHandshake, Browse)
   browse.MaxReferenciesPerNode = 2;
 
   BrowseDescription desc;
-  desc.NodeToBrowse.Encoding = EV_TWO_BYTE;
-  desc.NodeToBrowse.TwoByteData.Identifier = 84; // root node.
+  desc.NodeToBrowse = TwoByteNodeId(84);
   desc.Direction = BrowseDirection::FORWARD;
-  desc.ReferenceTypeId.Encoding = EV_TWO_BYTE;
-  desc.ReferenceTypeId.TwoByteData.Identifier = 33;
+  desc.ReferenceTypeId = TwoByteNodeId(33);
   desc.IncludeSubtypes = true;
   desc.NodeClasses = NodeClass::Unspecified;
   desc.ResultMask = BrowseResultMask::All;
@@ -377,8 +375,7 @@ TEST_F(OpcBinaryHandshake, Read)
 
 
   ReadValueId value;
-  value.Node.Encoding = EV_FOUR_BYTE;
-  value.Node.FourByteData.Identifier = static_cast<uint8_t>(ObjectId::RootFolder);
+  value.Node = FourByteNodeId(static_cast<uint8_t>(ObjectId::RootFolder));
   value.Attribute = AttributeId::DisplayName;
 
 
@@ -423,8 +420,7 @@ TEST_F(OpcBinaryHandshake, Write)
   request.Header.SessionAuthenticationToken = session.AuthenticationToken;
 
   WriteValue value;
-  value.Node.Encoding = EV_FOUR_BYTE;
-  value.Node.FourByteData.Identifier = static_cast<uint8_t>(ObjectId::RootFolder); 
+  value.Node = FourByteNodeId(static_cast<uint8_t>(ObjectId::RootFolder));
   value.Attribute = AttributeId::DisplayName;
   value.Data.Encoding = DATA_VALUE;
   value.Data.Value.Type = VariantType::STRING;
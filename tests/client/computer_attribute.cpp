@@ -69,8 +69,7 @@ TEST_F(Attribute, Read)
 
 
   ReadValueId id;
-  id.Node.Encoding = EV_TWO_BYTE;
-  id.Node.TwoByteData.Identifier = static_cast<uint8_t>(ObjectId::ObjectsFolder);
+  id.Node = TwoByteNodeId(static_cast<uint8_t>(ObjectId::ObjectsFolder));
   id.Attribute = AttributeId::BrowseName;
 
   OpcUa::ReadParameters params;
@@ -87,8 +86,7 @@ TEST_F(Attribute, Write)
   ASSERT_TRUE(static_cast<bool>(Service));
 
   WriteValue value;
-  value.Node.Encoding = EV_TWO_BYTE;
-  value.Node.TwoByteData.Identifier = static_cast<uint8_t>(ObjectId::ObjectsFolder);
+  value.Node = TwoByteNodeId(static_cast<uint8_t>(ObjectId::ObjectsFolder));
   value.Attribute = AttributeId::BrowseName;
 
   const std::vector<StatusCode> codes = Service->Write(std::vector<WriteValue>(1, value));
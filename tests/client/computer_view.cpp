@@ -23,11 +23,10 @@ class View : public ::testing::Test
 protected:
   View()
   {
-    Query.Description.NodeToBrowse.Encoding = EV_TWO_BYTE;
-    Query.Description.NodeToBrowse.TwoByteData.Identifier = static_cast<uint8_t>(ObjectId::RootFolder); // TODO automatic cast
+    Query.Description.NodeToBrowse = TwoByteNodeId(static_cast<uint8_t>(ObjectId::RootFolder));
     Query.Description.Direction = BrowseDirection::Forward;
-    Query.Description.ReferenceTypeId.Encoding = EV_TWO_BYTE;
-//    Params.Description.ReferenceTypeId.TwoByteData.Identifier = 33;
+    Query.Description.ReferenceTypeId = TwoByteNodeId(0);
+//    Params.Description.ReferenceTypeId = TwoByteNodeId(33);
     Query.Description.IncludeSubtypes = true;
     Query.Description.NodeClasses = NodeClass::Unspecified;
     Query.Description.ResultMask = BrowseResultMask::All;
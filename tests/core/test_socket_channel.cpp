@@ -0,0 +1,107 @@
+/// @brief Tests of buffered reading from socket channel.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <opc/ua/socket_channel.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+class SocketChannel : public ::testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    Reader = sockets[0];
+    Writer = sockets[1];
+  }
+
+  virtual void TearDown()
+  {
+    CloseWriter();
+    close(Reader);
+  }
+
+  void Write(const std::string& data)
+  {
+    ASSERT_EQ(send(Writer, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+  }
+
+  void CloseWriter()
+  {
+    if (Writer >= 0)
+    {
+      close(Writer);
+      Writer = -1;
+    }
+  }
+
+  static std::string Receive(OpcUa::SocketChannel& channel, std::size_t size)
+  {
+    std::string data(size, '\0');
+    EXPECT_EQ(channel.Receive(&data[0], size), size);
+    return data;
+  }
+
+protected:
+  int Reader = -1;
+  int Writer = -1;
+};
+
+TEST_F(SocketChannel, WaitsForRestOfShortReads)
+{
+  OpcUa::SocketChannel channel(Reader, 64);
+  std::thread writer([this]()
+  {
+    Write("abc");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Write("defgh");
+  });
+
+  EXPECT_EQ(Receive(channel, 8), "abcdefgh");
+  writer.join();
+}
+
+TEST_F(SocketChannel, ReadsSpanBufferBoundary)
+{
+  OpcUa::SocketChannel channel(Reader, 8);
+  Write("0123456789abcdefghijklmnopqrstuvwxyz");
+
+  EXPECT_EQ(Receive(channel, 5), "01234");
+  // Three bytes are left in the buffer, the rest is read into it again.
+  EXPECT_EQ(Receive(channel, 6), "56789a");
+  // Larger than the buffer, read past it directly.
+  EXPECT_EQ(Receive(channel, 12), "bcdefghijklm");
+  EXPECT_EQ(Receive(channel, 13), "nopqrstuvwxyz");
+}
+
+TEST_F(SocketChannel, ThrowsOnEndOfStreamInsideBufferedRead)
+{
+  OpcUa::SocketChannel channel(Reader, 64);
+  Write("01234");
+  CloseWriter();
+
+  char data[10];
+  EXPECT_ANY_THROW(channel.Receive(data, sizeof(data)));
+}
+
+TEST_F(SocketChannel, ThrowsOnEndOfStreamInsideDirectRead)
+{
+  OpcUa::SocketChannel channel(Reader, 4);
+  Write("01234");
+  CloseWriter();
+
+  char data[10];
+  EXPECT_ANY_THROW(channel.Receive(data, sizeof(data)));
+}
@@ -0,0 +1,138 @@
+/// @brief Benchmark of response serialization: RawSize pre-pass versus single pass with back-patched size.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <opc/ua/protocol/binary/stream.h>
+#include <opc/ua/protocol/protocol.h>
+#include <opc/ua/protocol/secure_channel.h>
+#include <opc/ua/protocol/view.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace OpcUa;
+using namespace OpcUa::Binary;
+
+namespace
+{
+
+  class NullChannel
+  {
+  public:
+    void Send(const char* data, std::size_t size)
+    {
+      Data.assign(data, data + size);
+    }
+
+    std::vector<char> Data;
+  };
+
+  ReadResponse CreateReadResponse(std::size_t count)
+  {
+    ReadResponse response;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      DataValue value(static_cast<double>(i) * 0.5);
+      value.SetSourceTimestamp(DateTime::Current());
+      value.SetServerTimestamp(DateTime::Current());
+      response.Results.push_back(value);
+    }
+    return response;
+  }
+
+  BrowseResponse CreateBrowseResponse(std::size_t count)
+  {
+    BrowseResponse response;
+    BrowseResult result;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      ReferenceDescription ref;
+      ref.ReferenceTypeId = ObjectId::Organizes;
+      ref.IsForward = true;
+      ref.TargetNodeId = NodeId("Variable" + std::to_string(i), 2);
+      ref.BrowseName = QualifiedName("Variable" + std::to_string(i), 2);
+      ref.DisplayName = LocalizedText("Variable" + std::to_string(i));
+      ref.TargetNodeClass = NodeClass::Variable;
+      ref.TargetNodeTypeDefinition = ObjectId::BaseDataVariableType;
+      result.Referencies.push_back(ref);
+    }
+    response.Results.push_back(result);
+    return response;
+  }
+
+  template <typename Response>
+  void SerializeTwoPass(OStream<NullChannel>& stream, const SymmetricAlgorithmHeader& algorithm, const SequenceHeader& sequence, const Response& response)
+  {
+    SecureHeader hdr(MT_SECURE_MESSAGE, CHT_SINGLE, 1);
+    hdr.AddSize(RawSize(algorithm));
+    hdr.AddSize(RawSize(sequence));
+    hdr.AddSize(RawSize(response));
+    stream << hdr << algorithm << sequence << response << flush;
+  }
+
+  template <typename Response>
+  void SerializeOnePass(OStream<NullChannel>& stream, const SymmetricAlgorithmHeader& algorithm, const SequenceHeader& sequence, const Response& response)
+  {
+    const std::size_t headerPos = stream.Position();
+    stream << SecureHeader(MT_SECURE_MESSAGE, CHT_SINGLE, 1) << algorithm << sequence << response;
+    stream.UpdateMessageSize(headerPos);
+    stream << flush;
+  }
+
+  template <typename Function>
+  double Measure(unsigned iterations, Function func)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+      func();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+  }
+
+  template <typename Response>
+  bool Run(const std::string& name, const Response& response, unsigned iterations)
+  {
+    NullChannel twoPassChannel;
+    NullChannel onePassChannel;
+    OStream<NullChannel> twoPassStream(twoPassChannel);
+    OStream<NullChannel> onePassStream(onePassChannel);
+    const SymmetricAlgorithmHeader algorithm;
+    const SequenceHeader sequence;
+
+    const double twoPass = Measure(iterations, [&](){ SerializeTwoPass(twoPassStream, algorithm, sequence, response); });
+    const double onePass = Measure(iterations, [&](){ SerializeOnePass(onePassStream, algorithm, sequence, response); });
+
+    std::cout << name << ": " << onePassChannel.Data.size() << " bytes, "
+              << "RawSize + serialize " << twoPass << " ms, "
+              << "single pass " << onePass << " ms, "
+              << "speedup " << twoPass / onePass << std::endl;
+
+    if (twoPassChannel.Data != onePassChannel.Data)
+    {
+      std::cerr << name << ": serialized data differ!" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+}
+
+int main(int argc, char** argv)
+{
+  const std::size_t count = argc > 1 ? std::atoi(argv[1]) : 10000;
+  const unsigned iterations = argc > 2 ? std::atoi(argv[2]) : 100;
+
+  bool ok = true;
+  ok &= Run("ReadResponse(" + std::to_string(count) + ")", CreateReadResponse(count), iterations);
+  ok &= Run("BrowseResponse(" + std::to_string(count) + ")", CreateBrowseResponse(count), iterations);
+  return ok ? 0 : 1;
+}
@@ -110,6 +110,51 @@ TEST_F(OpcUaBinaryDeserialization, Double)
   ASSERT_EQ(num, 1200000);
 }
 
+TEST_F(OpcUaBinaryDeserialization, DoubleArray)
+{
+  std::vector<char> serializedData = {
+    2, 0, 0, 0,
+    0, 0, 0, 0, (char)0x80, (char)0x4f, (char)0x32, (char)0x41,
+    0, 0, 0, 0, 0, 0, (char)0x1A, (char)0xC0
+  };
+  GetChannel().SetData(serializedData);
+  std::vector<double> nums;
+  GetStream() >> nums;
+  ASSERT_EQ(nums, std::vector<double>({1200000, -6.5}));
+}
+
+TEST_F(OpcUaBinaryDeserialization, LargeInt32Array)
+{
+  const uint32_t count = 100000;
+  std::vector<char> serializedData = {(char)0xA0, (char)0x86, 0x01, 0};
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    serializedData.push_back(i & 0xFF);
+    serializedData.push_back((i >> 8) & 0xFF);
+    serializedData.push_back((i >> 16) & 0xFF);
+    serializedData.push_back(0);
+  }
+  GetChannel().SetData(serializedData);
+  std::vector<int32_t> nums;
+  GetStream() >> nums;
+  ASSERT_EQ(nums.size(), count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    ASSERT_EQ(nums[i], (int32_t)i);
+  }
+}
+
+TEST_F(OpcUaBinaryDeserialization, TruncatedDoubleArray)
+{
+  std::vector<char> serializedData = {
+    2, 0, 0, 0,
+    0, 0, 0, 0, (char)0x80, (char)0x4f, (char)0x32, (char)0x41
+  };
+  GetChannel().SetData(serializedData);
+  std::vector<double> nums;
+  ASSERT_THROW(GetStream() >> nums, std::logic_error);
+}
+
 //-------------------------------------------------------------
 // String
 //-------------------------------------------------------------
@@ -609,11 +654,11 @@ TEST_F(OpcUaBinaryDeserialization, AdditionalHeader)
   AdditionalHeader header;
   GetStream() >> header;
 
-  ASSERT_EQ(header.TypeId.Encoding, uint8_t(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG));
-  ASSERT_EQ(header.TypeId.StringData.NamespaceIndex, 0x1);
-  ASSERT_EQ(header.TypeId.StringData.Identifier, "id");
-  ASSERT_EQ(header.TypeId.NamespaceURI, "uri");
-  ASSERT_EQ(header.TypeId.ServerIndex, 1);
+  ASSERT_EQ(header.TypeId.GetEncoding(), uint8_t(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG));
+  ASSERT_EQ(header.TypeId.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(header.TypeId.GetStringIdentifier(), "id");
+  ASSERT_EQ(header.TypeId.GetNamespaceURI(), "uri");
+  ASSERT_EQ(header.TypeId.GetServerIndex(), 1);
   ASSERT_EQ(header.Encoding, 1);
 
   ASSERT_EQ(expectedData.size(), Binary::RawSize(header));
@@ -645,15 +690,15 @@ TEST_F(OpcUaBinaryDeserialization, RequestHeader)
   RequestHeader header;
   GetStream() >> header;
 
-  ASSERT_EQ(header.SessionAuthenticationToken.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(header.SessionAuthenticationToken.TwoByteData.Identifier, 1);
+  ASSERT_EQ(header.SessionAuthenticationToken.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(header.SessionAuthenticationToken.GetIntegerIdentifier(), 1);
   ASSERT_EQ(header.UtcTime, 2);
   ASSERT_EQ(header.RequestHandle, 3);
   ASSERT_EQ(header.ReturnDiagnostics, 4);
   ASSERT_EQ(header.AuditEntryId, "audit");
   ASSERT_EQ(header.Timeout, 5); // in miliseconds
-  ASSERT_EQ(header.Additional.TypeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(header.Additional.TypeId.TwoByteData.Identifier, 6);
+  ASSERT_EQ(header.Additional.TypeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(header.Additional.TypeId.GetIntegerIdentifier(), 6);
   ASSERT_EQ(header.Additional.Encoding, 8);
 
   ASSERT_EQ(expectedData.size(), Binary::RawSize(header));
@@ -903,9 +948,9 @@ TEST_F(OpcUaBinaryDeserialization, OpenSecureChannelResponse)
   OpenSecureChannelResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::OPEN_SECURE_CHANNEL_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::OPEN_SECURE_CHANNEL_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -981,9 +1026,9 @@ TEST_F(OpcUaBinaryDeserialization, ExtensionObjectHeader)
   ExtensionObjectHeader header(OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS, HAS_BINARY_BODY);
   GetStream() >> header;
   
-  ASSERT_EQ(header.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(header.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(header.TypeId.FourByteData.Identifier, OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
+  ASSERT_EQ(header.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(header.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(header.TypeId.GetIntegerIdentifier(), OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
   ASSERT_EQ(header.Encoding, HAS_BINARY_BODY);
 }
 
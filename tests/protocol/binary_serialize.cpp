@@ -151,6 +151,30 @@ TEST_F(OpcUaBinarySerialization, Double)
   ASSERT_EQ(expectedData, GetChannel().SerializedData);
 }
 
+TEST_F(OpcUaBinarySerialization, DoubleArray)
+{
+  std::vector<double> dataForSerialize = {1200000, -6.5};
+  const std::vector<char> expectedData = {
+    2, 0, 0, 0,
+    0, 0, 0, 0, (char)0x80, (char)0x4f, (char)0x32, (char)0x41,
+    0, 0, 0, 0, 0, 0, (char)0x1A, (char)0xC0
+  };
+  GetStream() << dataForSerialize << flush;
+  ASSERT_EQ(expectedData, GetChannel().SerializedData);
+}
+
+TEST_F(OpcUaBinarySerialization, Int32Array)
+{
+  std::vector<int32_t> dataForSerialize = {1, -2};
+  const std::vector<char> expectedData = {
+    2, 0, 0, 0,
+    1, 0, 0, 0,
+    (char)0xFE, (char)0xFF, (char)0xFF, (char)0xFF
+  };
+  GetStream() << dataForSerialize << flush;
+  ASSERT_EQ(expectedData, GetChannel().SerializedData);
+}
+
 //-------------------------------------------------------------
 // String
 //-------------------------------------------------------------
@@ -372,6 +396,26 @@ TEST_F(OpcUaBinarySerialization, SecureMessageHeader)
   ASSERT_EQ(expectedData.size(), RawSize(hdr));
 }
 
+TEST_F(OpcUaBinarySerialization, UpdateMessageSize)
+{
+  OpcUa::Binary::SecureHeader hdr(OpcUa::Binary::MT_SECURE_MESSAGE, OpcUa::Binary::CHT_SINGLE, 0x1);
+  const uint32_t body = 0x01020304;
+
+  const std::vector<char> expectedData =
+  {
+    'M', 'S', 'G',
+    'F',
+    16, 0, 0, 0,
+    1, 0, 0, 0,
+    4, 3, 2, 1
+  };
+  const std::size_t headerPos = GetStream().Position();
+  GetStream() << hdr << body;
+  GetStream().UpdateMessageSize(headerPos);
+  GetStream() << flush;
+  ASSERT_EQ(expectedData, GetChannel().SerializedData);
+}
+
 
 //---------------------------------------------------------
 // Hello
@@ -521,11 +565,9 @@ TEST_F(OpcUaBinarySerialization, AdditionalHeader)
   using namespace OpcUa;
   using namespace OpcUa::Binary;
   AdditionalHeader header;
-  header.TypeId.Encoding = static_cast<NodeIdEncoding>(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG);
-  header.TypeId.StringData.NamespaceIndex = 0x1;
-  header.TypeId.StringData.Identifier = "id";
-  header.TypeId.NamespaceURI = "uri";
-  header.TypeId.ServerIndex = 1;
+  header.TypeId = StringNodeId("id", 0x1);
+  header.TypeId.SetNamespaceURI("uri");
+  header.TypeId.SetServerIndex(1);
   header.Encoding = 1;
 
   const std::vector<char> expectedData = {
@@ -819,9 +861,9 @@ TEST_F(OpcUaBinarySerialization, OpenSecureChannelResponse)
 
   OpenSecureChannelResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::OPEN_SECURE_CHANNEL_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::OPEN_SECURE_CHANNEL_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -864,9 +906,9 @@ TEST_F(OpcUaBinarySerialization, CloseSequreChannelRequest)
 
   CloseSecureChannelRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CLOSE_SECURE_CHANNEL_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CLOSE_SECURE_CHANNEL_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
   
@@ -110,8 +110,7 @@ TEST_F(OpcUaBinarySerialization, ReadValueId)
 
   ReadValueId attr;
 
-  attr.NodeId.Encoding = EV_TWO_BYTE;
-  attr.NodeId.TwoByteData.Identifier = 1;
+  attr.NodeId = TwoByteNodeId(1);
   attr.AttributeId = AttributeId::Value;
   attr.IndexRange = "1,2";
   attr.DataEncoding.NamespaceIndex = 2;
@@ -150,8 +149,8 @@ TEST_F(OpcUaBinaryDeserialization, ReadValueId)
   ReadValueId attr;
   GetStream() >> attr;
   
-  ASSERT_EQ(attr.NodeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(attr.NodeId.TwoByteData.Identifier, 1);
+  ASSERT_EQ(attr.NodeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(attr.NodeId.GetIntegerIdentifier(), 1);
   ASSERT_EQ(attr.AttributeId, AttributeId::Value);
   ASSERT_EQ(attr.DataEncoding.NamespaceIndex, 2);
   ASSERT_EQ(attr.DataEncoding.Name, "test");
@@ -166,8 +165,7 @@ OpcUa::ReadValueId CreateReadValueId()
   using namespace OpcUa;
   OpcUa::ReadValueId attr;
 
-  attr.NodeId.Encoding = OpcUa::EV_TWO_BYTE;
-  attr.NodeId.TwoByteData.Identifier = 1;
+  attr.NodeId = TwoByteNodeId(1);
   attr.AttributeId = OpcUa::AttributeId::Value;
   attr.IndexRange = "1,2";
   attr.DataEncoding.NamespaceIndex = 2;
@@ -183,9 +181,9 @@ TEST_F(OpcUaBinarySerialization, ReadRequest)
 
   ReadRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::READ_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::READ_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -244,9 +242,9 @@ TEST_F(OpcUaBinaryDeserialization, ReadRequest)
   ReadRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::READ_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::READ_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -257,8 +255,8 @@ TEST_F(OpcUaBinaryDeserialization, ReadRequest)
 
   ReadValueId attr = CreateReadValueId();
 
-  ASSERT_EQ(request.Parameters.AttributesToRead[0].NodeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(request.Parameters.AttributesToRead[0].NodeId.TwoByteData.Identifier, 1);
+  ASSERT_EQ(request.Parameters.AttributesToRead[0].NodeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(request.Parameters.AttributesToRead[0].NodeId.GetIntegerIdentifier(), 1);
   ASSERT_EQ(request.Parameters.AttributesToRead[0].AttributeId, OpcUa::AttributeId::Value);
   ASSERT_EQ(request.Parameters.AttributesToRead[0].DataEncoding.NamespaceIndex, 2);
   ASSERT_EQ(request.Parameters.AttributesToRead[0].DataEncoding.Name, "test");
@@ -277,9 +275,9 @@ TEST_F(OpcUaBinarySerialization, ReadResponse)
 
   ReadResponse resp;
 
-  ASSERT_EQ(resp.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(resp.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(resp.TypeId.FourByteData.Identifier, OpcUa::READ_RESPONSE);
+  ASSERT_EQ(resp.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(resp.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(resp.TypeId.GetIntegerIdentifier(), OpcUa::READ_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(resp.Header);
 
@@ -330,9 +328,9 @@ TEST_F(OpcUaBinaryDeserialization, ReadResponse_with_QualifiedName_as_value)
   ReadResponse resp;
   GetStream() >> resp;
 
-  ASSERT_EQ(resp.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(resp.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(resp.TypeId.FourByteData.Identifier, OpcUa::READ_RESPONSE);
+  ASSERT_EQ(resp.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(resp.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(resp.TypeId.GetIntegerIdentifier(), OpcUa::READ_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(resp.Header);
   ASSERT_EQ(resp.Results.size(), 1);
@@ -377,9 +375,9 @@ TEST_F(OpcUaBinaryDeserialization, ReadResponse)
   ReadResponse resp;
   GetStream() >> resp;
 
-  ASSERT_EQ(resp.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(resp.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(resp.TypeId.FourByteData.Identifier, OpcUa::READ_RESPONSE);
+  ASSERT_EQ(resp.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(resp.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(resp.TypeId.GetIntegerIdentifier(), OpcUa::READ_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(resp.Header);
   ASSERT_EQ(resp.Results.size(), 1);
@@ -395,8 +393,7 @@ TEST_F(OpcUaBinarySerialization, WriteValue)
   using namespace OpcUa::Binary;
 
   WriteValue value;
-  value.NodeId.Encoding = EV_FOUR_BYTE;
-  value.NodeId.FourByteData.Identifier = 1;
+  value.NodeId = FourByteNodeId(1);
   value.AttributeId = AttributeId::DisplayName;
   value.Value.Encoding = DATA_VALUE;
   value.Value.Value = true;
@@ -432,8 +429,8 @@ TEST_F(OpcUaBinaryDeserialization, WriteValue)
   WriteValue value;
   GetStream() >> value;
 
-  ASSERT_EQ(value.NodeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(value.NodeId.FourByteData.Identifier, 1);
+  ASSERT_EQ(value.NodeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(value.NodeId.GetIntegerIdentifier(), 1);
   ASSERT_EQ(value.AttributeId, AttributeId::DisplayName);
   ASSERT_EQ(value.Value.Encoding, DATA_VALUE);
   ASSERT_EQ(value.Value.Value.Type(), VariantType::BOOLEAN);
@@ -453,15 +450,14 @@ TEST_F(OpcUaBinarySerialization, WriteRequest)
 
   WriteRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::WRITE_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::WRITE_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
   WriteValue value;
-  value.NodeId.Encoding = EV_FOUR_BYTE;
-  value.NodeId.FourByteData.Identifier = 1;
+  value.NodeId = FourByteNodeId(1);
   value.AttributeId = AttributeId::DisplayName;
   value.Value.Encoding = DATA_VALUE;
   value.Value.Value = true;
@@ -512,16 +508,16 @@ TEST_F(OpcUaBinaryDeserialization, WriteRequest)
   GetStream() >> request;
 
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::WRITE_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::WRITE_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
 
   ASSERT_EQ(request.Parameters.NodesToWrite.size(), 1);
-  ASSERT_EQ(request.Parameters.NodesToWrite[0].NodeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.Parameters.NodesToWrite[0].NodeId.FourByteData.Identifier, 1);
+  ASSERT_EQ(request.Parameters.NodesToWrite[0].NodeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.Parameters.NodesToWrite[0].NodeId.GetIntegerIdentifier(), 1);
   ASSERT_EQ(request.Parameters.NodesToWrite[0].AttributeId, AttributeId::DisplayName);
   ASSERT_EQ(request.Parameters.NodesToWrite[0].Value.Encoding, DATA_VALUE);
   ASSERT_EQ(request.Parameters.NodesToWrite[0].Value.Value.Type(), VariantType::BOOLEAN);
@@ -539,9 +535,9 @@ TEST_F(OpcUaBinarySerialization, WriteResponse)
 
   WriteResponse resp;
 
-  ASSERT_EQ(resp.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(resp.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(resp.TypeId.FourByteData.Identifier, OpcUa::WRITE_RESPONSE);
+  ASSERT_EQ(resp.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(resp.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(resp.TypeId.GetIntegerIdentifier(), OpcUa::WRITE_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(resp.Header);
 
@@ -586,9 +582,9 @@ TEST_F(OpcUaBinaryDeserialization, WriteResponse)
   GetStream() >> resp;
 
 
-  ASSERT_EQ(resp.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(resp.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(resp.TypeId.FourByteData.Identifier, OpcUa::WRITE_RESPONSE);
+  ASSERT_EQ(resp.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(resp.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(resp.TypeId.GetIntegerIdentifier(), OpcUa::WRITE_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(resp.Header);
 
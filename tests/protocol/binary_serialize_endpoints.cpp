@@ -40,9 +40,9 @@ TEST_F(EndpointsSerialization, GetEndpointsRequest)
 
   GetEndpointsRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::GET_ENDPOINTS_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::GET_ENDPOINTS_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
   request.Parameters.EndpointUrl = "test";
@@ -84,9 +84,9 @@ TEST_F(EndpointsDeserialization, GetEndpointsRequest)
   GetEndpointsRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::GET_ENDPOINTS_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::GET_ENDPOINTS_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -107,9 +107,9 @@ TEST_F(EndpointsSerialization, GetEndpointsResponse)
 
   GetEndpointsResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::GET_ENDPOINTS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::GET_ENDPOINTS_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -151,9 +151,9 @@ TEST_F(EndpointsDeserialization, GetEndpointsResponse)
   GetEndpointsResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::GET_ENDPOINTS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::GET_ENDPOINTS_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -294,9 +294,9 @@ TEST_F(EndpointsDeserialization, GetEndpointsResponseReal)
   GetEndpointsResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::GET_ENDPOINTS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::GET_ENDPOINTS_RESPONSE);
 
   ASSERT_EQ(response.Endpoints.size(), 5);
 
@@ -368,9 +368,9 @@ TEST_F(EndpointsSerialization, FindServersRequest)
 
   FindServersRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::FIND_ServerS_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::FIND_ServerS_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
   request.Parameters.EndpointUrl = "url";
@@ -412,9 +412,9 @@ TEST_F(EndpointsDeserialization, FindServersRequest)
   FindServersRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::FIND_ServerS_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::FIND_ServerS_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -435,9 +435,9 @@ TEST_F(EndpointsSerialization, FindServersResponse)
 
   FindServersResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::FIND_ServerS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::FIND_ServerS_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -479,9 +479,9 @@ TEST_F(EndpointsDeserialization, FindServersResponse)
   FindServersResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::FIND_ServerS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::FIND_ServerS_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -86,9 +86,9 @@ TEST_F(MonitoredItemsSerialization, DISABLED_CreateMonitoredItemsResponse)
   response.Results.push_back(monitoringResult);
 
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CREATE_MONITORED_ITEMS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_MONITORED_ITEMS_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -33,9 +33,9 @@ TEST_F(OpcUaBinarySerialization, CreateSessionRequest)
 
   CreateSessionRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CREATE_SESSION_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SESSION_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -93,9 +93,9 @@ TEST_F(OpcUaBinaryDeserialization, CreateSessionRequest)
   CreateSessionRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CREATE_SESSION_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SESSION_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
   ASSERT_APPLICATION_DESCRIPTION_EQ(request.Parameters.ClientDescription);
@@ -124,19 +124,19 @@ TEST_F(OpcUaBinaryDeserialization, CreateSessionRequest)
 //
 //   CreateSessionResponse response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CREATE_SESSION_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SESSION_RESPONSE);
 //
 //   FILL_TEST_RESPONSE_HEADER(response.Header);
 //
 //   response.Parameters.SessionId.Encoding = EV_FOUR_BYTE;
-//   response.Parameters.SessionId.FourByteData.NamespaceIndex = 1;
-//   response.Parameters.SessionId.FourByteData.Identifier = 2;
+//   response.Parameters.SessionId.GetNamespaceIndex() = 1;
+//   response.Parameters.SessionId.GetIntegerIdentifier() = 2;
 //
 //   response.Parameters.AuthenticationToken.Encoding = EV_FOUR_BYTE;
-//   response.Parameters.AuthenticationToken.FourByteData.NamespaceIndex = 1;
-//   response.Parameters.AuthenticationToken.FourByteData.Identifier = 2;
+//   response.Parameters.AuthenticationToken.GetNamespaceIndex() = 1;
+//   response.Parameters.AuthenticationToken.GetIntegerIdentifier() = 2;
 //
 //   response.Parameters.RevisedSessionTimeout = 1200000;
 //   response.Parameters.ServerNonce = ByteString(std::vector<uint8_t>{1,2,3,4});
@@ -204,19 +204,19 @@ TEST_F(OpcUaBinaryDeserialization, CreateSessionRequest)
 //   CreateSessionResponse response;
 //   GetStream() >> response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CREATE_SESSION_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SESSION_RESPONSE);
 //
 //   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 //
-//   ASSERT_EQ(response.Parameters.SessionId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.Parameters.SessionId.FourByteData.NamespaceIndex, 1);
-//   ASSERT_EQ(response.Parameters.SessionId.FourByteData.Identifier, 2);
+//   ASSERT_EQ(response.Parameters.SessionId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.Parameters.SessionId.GetNamespaceIndex(), 1);
+//   ASSERT_EQ(response.Parameters.SessionId.GetIntegerIdentifier(), 2);
 //
-//   ASSERT_EQ(response.Parameters.AuthenticationToken.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.Parameters.AuthenticationToken.FourByteData.NamespaceIndex, 1);
-//   ASSERT_EQ(response.Parameters.AuthenticationToken.FourByteData.Identifier, 2);
+//   ASSERT_EQ(response.Parameters.AuthenticationToken.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.Parameters.AuthenticationToken.GetNamespaceIndex(), 1);
+//   ASSERT_EQ(response.Parameters.AuthenticationToken.GetIntegerIdentifier(), 2);
 //
 //   ASSERT_EQ(response.Parameters.RevisedSessionTimeout, 1200000);
 //
@@ -254,9 +254,9 @@ TEST_F(OpcUaBinarySerialization, UserIdentifyToken_Anonymous)
   UserIdentifyToken token;
   token.setPolicyId("0");
 /*
-  ASSERT_EQ(token.Header.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(token.Header.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(token.Hader.TypeId.FourByteData.Identifier, USER_IdENTIFY_TOKEN_ANONYMOUS);
+  ASSERT_EQ(token.Header.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(token.Header.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(token.Hader.TypeId.GetIntegerIdentifier(), USER_IdENTIFY_TOKEN_ANONYMOUS);
   ASSERT_EQ(token.Header.Encoding, HAS_BINARY_BODY);
   ASSERT_EQ(token.Anonymous.Data, std::vector{});
 */
@@ -287,9 +287,9 @@ TEST_F(OpcUaBinaryDeserialization, UserIdentifyToken_Anonymous)
   UserIdentifyToken token;
   GetStream() >> token;
 
-  ASSERT_EQ(token.Header.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(token.Header.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(token.Header.TypeId.FourByteData.Identifier, OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
+  ASSERT_EQ(token.Header.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(token.Header.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(token.Header.TypeId.GetIntegerIdentifier(), OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
   ASSERT_EQ(token.Header.Encoding, HAS_BINARY_BODY);
   std::vector<uint8_t> policy_id = {'0'};
   ASSERT_EQ(token.PolicyId, policy_id);
@@ -309,15 +309,15 @@ TEST_F(OpcUaBinaryDeserialization, UserIdentifyToken_Anonymous)
 //   ActivateSessionRequest request;
 //   request.Parameters.UserIdentityToken.setPolicyId("0");
 //
-//   ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::ACTIVATE_SESSION_REQUEST);
+//   ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::ACTIVATE_SESSION_REQUEST);
 //
 //   FILL_TEST_REQUEST_HEADER(request.Header);
 //
-//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.FourByteData.Identifier, OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
+//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.GetIntegerIdentifier(), OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
 //   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.Encoding, HAS_BINARY_BODY);
 //   std::vector<uint8_t> policy_id = {1,0,0,0,'0'};
 //   ASSERT_EQ(request.Parameters.UserIdentityToken.PolicyId, policy_id);
@@ -373,18 +373,18 @@ TEST_F(OpcUaBinaryDeserialization, UserIdentifyToken_Anonymous)
 //   ActivateSessionRequest request;
 //   GetStream() >> request;
 //
-//   ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::ACTIVATE_SESSION_REQUEST);
+//   ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::ACTIVATE_SESSION_REQUEST);
 //
 //   ASSERT_REQUEST_HEADER_EQ(request.Header);
 //
 //   ASSERT_EQ(request.Parameters.ClientSoftwareCertificates.size(), 1);
 //   ASSERT_EQ(request.Parameters.ClientSoftwareCertificates[0].CertificateData, ByteString(std::vector<uint8_t>{1}));
 //
-//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.FourByteData.Identifier, OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
+//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.TypeId.GetIntegerIdentifier(), OpcUa::USER_IdENTIFY_TOKEN_ANONYMOUS);
 //   ASSERT_EQ(request.Parameters.UserIdentityToken.Header.Encoding, HAS_BINARY_BODY);
 //   std::vector<uint8_t> policy_id = {1,0,0,0,'0'};
 //   ASSERT_EQ(request.Parameters.UserIdentityToken.PolicyId, policy_id);
@@ -402,9 +402,9 @@ TEST_F(OpcUaBinaryDeserialization, UserIdentifyToken_Anonymous)
 //
 //   ActivateSessionResponse response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::ACTIVATE_SESSION_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::ACTIVATE_SESSION_RESPONSE);
 //
 //   FILL_TEST_RESPONSE_HEADER(response.Header);
 //   response.Parameters.ServerNonce = ByteString(std::vector<uint8_t>{1,1});
@@ -447,9 +447,9 @@ TEST_F(OpcUaBinaryDeserialization, UserIdentifyToken_Anonymous)
 //   ActivateSessionResponse response;
 //   GetStream() >> response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::ACTIVATE_SESSION_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::ACTIVATE_SESSION_RESPONSE);
 //
 //   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 //
@@ -473,9 +473,9 @@ TEST_F(OpcUaBinarySerialization, CloseSessionRequest)
 
   CloseSessionRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CLOSE_SESSION_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CLOSE_SESSION_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -510,9 +510,9 @@ TEST_F(OpcUaBinaryDeserialization, CloseSessionRequest)
   CloseSessionRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CLOSE_SESSION_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CLOSE_SESSION_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -531,9 +531,9 @@ TEST_F(OpcUaBinarySerialization, CloseSessionResponse)
 
   CloseSessionResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CLOSE_SESSION_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CLOSE_SESSION_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -567,9 +567,9 @@ TEST_F(OpcUaBinaryDeserialization, CloseSessionResponse)
   CloseSessionResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CLOSE_SESSION_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CLOSE_SESSION_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 }
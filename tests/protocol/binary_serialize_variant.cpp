@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <typeinfo>
 
 //-------------------------------------------------------
 // Serialization
@@ -1770,3 +1771,78 @@ TEST(Variant, Comparable)
   ASSERT_NE(OpcUa::Variant(true), OpcUa::Variant(false));
   ASSERT_NE(OpcUa::Variant(true), false);
 }
+
+TEST(Variant, InitializeWithCharArray)
+{
+  const OpcUa::Variant var("string");
+  ASSERT_EQ(var.Type(), OpcUa::VariantType::STRING);
+  ASSERT_EQ(var.As<std::string>(), "string");
+  ASSERT_EQ(var, "string");
+}
+
+TEST(Variant, InitializeWithLongLong)
+{
+  const OpcUa::Variant var(1LL);
+  ASSERT_EQ(var.Type(), OpcUa::VariantType::INT64);
+  ASSERT_EQ(var.As<int64_t>(), 1);
+}
+
+TEST(Variant, InitializeWithDateTime)
+{
+  const OpcUa::DateTime time(12345);
+  const OpcUa::Variant var(time);
+  ASSERT_EQ(var.Type(), OpcUa::VariantType::DATE_TIME);
+  ASSERT_EQ(var.As<OpcUa::DateTime>(), time);
+}
+
+TEST(Variant, ThrowsIfRequestedOtherType)
+{
+  const OpcUa::Variant var(1);
+  ASSERT_THROW(var.As<double>(), std::bad_cast);
+  ASSERT_THROW(OpcUa::Variant().As<int32_t>(), std::bad_cast);
+  ASSERT_NE(var, 1.0);
+}
+
+TEST(Variant, CopyKeepsValueAndDimensions)
+{
+  OpcUa::Variant var(std::vector<int32_t>{1, 2, 3, 4});
+  var.Dimensions = {2, 2};
+
+  const OpcUa::Variant copy(var);
+  ASSERT_EQ(copy, var);
+  ASSERT_EQ(copy.Dimensions, var.Dimensions);
+
+  OpcUa::Variant assigned;
+  assigned = var;
+  ASSERT_EQ(assigned, var);
+  ASSERT_EQ(assigned.Dimensions, var.Dimensions);
+}
+
+TEST(Variant, MoveLeavesSourceEmpty)
+{
+  OpcUa::Variant var(std::string("string"));
+  var.Dimensions = {1};
+
+  OpcUa::Variant moved(std::move(var));
+  ASSERT_EQ(moved.As<std::string>(), "string");
+  ASSERT_EQ(moved.Dimensions, std::vector<uint32_t>{1});
+  ASSERT_TRUE(var.IsNul());
+
+  OpcUa::Variant assigned(1.5);
+  assigned = std::move(moved);
+  ASSERT_EQ(assigned.As<std::string>(), "string");
+  ASSERT_TRUE(moved.IsNul());
+}
+
+TEST(Variant, ChangeValueType)
+{
+  OpcUa::Variant var(std::string("string"));
+  var = std::string("other");
+  ASSERT_EQ(var.As<std::string>(), "other");
+  var = 2.5;
+  ASSERT_EQ(var.Type(), OpcUa::VariantType::DOUBLE);
+  ASSERT_EQ(var.As<double>(), 2.5);
+  var = std::vector<OpcUa::NodeId>{OpcUa::ObjectId::RootFolder};
+  ASSERT_EQ(var.Type(), OpcUa::VariantType::NODE_Id);
+  ASSERT_TRUE(var.IsArray());
+}
@@ -77,8 +77,7 @@ TEST_F(ViewSerialization, ViewDescription)
 
   ViewDescription desc;
 
-  desc.Id.Encoding = EV_TWO_BYTE;
-  desc.Id.TwoByteData.Identifier = 1;
+  desc.Id = TwoByteNodeId(1);
   desc.Timestamp.Value = 2;
   desc.Version = 3;
 
@@ -111,8 +110,8 @@ TEST_F(ViewDeserialization, ViewDescription)
   ViewDescription desc;
   GetStream() >> desc;
 
-  ASSERT_EQ(desc.Id.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.Id.TwoByteData.Identifier, 1);
+  ASSERT_EQ(desc.Id.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.Id.GetIntegerIdentifier(), 1);
   ASSERT_EQ(desc.Timestamp, 2);
   ASSERT_EQ(desc.Version, 3);
 }
@@ -129,11 +128,9 @@ TEST_F(ViewSerialization, BrowseDescription)
 
   BrowseDescription desc;
 
-  desc.NodeToBrowse.Encoding = EV_TWO_BYTE;
-  desc.NodeToBrowse.TwoByteData.Identifier = 1;
+  desc.NodeToBrowse = TwoByteNodeId(1);
   desc.Direction = BrowseDirection::Inverse;
-  desc.ReferenceTypeId.Encoding = EV_TWO_BYTE;
-  desc.ReferenceTypeId.TwoByteData.Identifier = 2;
+  desc.ReferenceTypeId = TwoByteNodeId(2);
   desc.IncludeSubtypes = true;
   desc.NodeClasses = NodeClass::Variable;
   desc.ResultMask = BrowseResultMask::NodeClass;
@@ -173,11 +170,11 @@ TEST_F(ViewDeserialization, BrowseDescription)
   BrowseDescription desc;
   GetStream() >> desc;
 
-  ASSERT_EQ(desc.NodeToBrowse.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.NodeToBrowse.TwoByteData.Identifier, 1);
+  ASSERT_EQ(desc.NodeToBrowse.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.NodeToBrowse.GetIntegerIdentifier(), 1);
   ASSERT_EQ(desc.Direction, BrowseDirection::Inverse);
-  ASSERT_EQ(desc.ReferenceTypeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.ReferenceTypeId.TwoByteData.Identifier, 2);
+  ASSERT_EQ(desc.ReferenceTypeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.ReferenceTypeId.GetIntegerIdentifier(), 2);
   ASSERT_EQ(desc.IncludeSubtypes, true);
   ASSERT_EQ(desc.NodeClasses, NodeClass::Variable);
   ASSERT_EQ(desc.ResultMask, BrowseResultMask::NodeClass);
@@ -192,11 +189,9 @@ OpcUa::BrowseDescription CreateBrowseDescription()
   using namespace OpcUa;
   using namespace OpcUa::Binary;
   BrowseDescription desc;
-  desc.NodeToBrowse.Encoding = EV_TWO_BYTE;
-  desc.NodeToBrowse.TwoByteData.Identifier = 1;
+  desc.NodeToBrowse = TwoByteNodeId(1);
   desc.Direction = BrowseDirection::Inverse;
-  desc.ReferenceTypeId.Encoding = EV_TWO_BYTE;
-  desc.ReferenceTypeId.TwoByteData.Identifier = 2;
+  desc.ReferenceTypeId = TwoByteNodeId(2);
   desc.IncludeSubtypes = true;
   desc.NodeClasses = NodeClass::Variable;
   desc.ResultMask = BrowseResultMask::NodeClass;
@@ -206,11 +201,11 @@ OpcUa::BrowseDescription CreateBrowseDescription()
 bool operator==(const OpcUa::BrowseDescription& lhs, const OpcUa::BrowseDescription& rhs)
 {
   return
-    rhs.NodeToBrowse.Encoding == lhs.NodeToBrowse.Encoding &&
-    rhs.NodeToBrowse.TwoByteData.Identifier == lhs.NodeToBrowse.TwoByteData.Identifier &&
+    rhs.NodeToBrowse.GetEncoding() == lhs.NodeToBrowse.GetEncoding() &&
+    rhs.NodeToBrowse.GetIntegerIdentifier() == lhs.NodeToBrowse.GetIntegerIdentifier() &&
     rhs.Direction == lhs.Direction &&
-    rhs.ReferenceTypeId.Encoding == lhs.ReferenceTypeId.Encoding &&
-    rhs.ReferenceTypeId.TwoByteData.Identifier == lhs.ReferenceTypeId.TwoByteData.Identifier &&
+    rhs.ReferenceTypeId.GetEncoding() == lhs.ReferenceTypeId.GetEncoding() &&
+    rhs.ReferenceTypeId.GetIntegerIdentifier() == lhs.ReferenceTypeId.GetIntegerIdentifier() &&
     rhs.IncludeSubtypes == lhs.IncludeSubtypes &&
     rhs.NodeClasses == lhs.NodeClasses &&
     rhs.ResultMask == lhs.ResultMask;
@@ -224,14 +219,13 @@ TEST_F(ViewSerialization, BrowseRequest)
 
   BrowseRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::BROWSE_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
-  request.Query.View.Id.Encoding = EV_TWO_BYTE;
-  request.Query.View.Id.TwoByteData.Identifier = 1;
+  request.Query.View.Id = TwoByteNodeId(1);
   request.Query.View.Timestamp.Value = 2;
   request.Query.View.Version = 3;
 
@@ -291,14 +285,14 @@ TEST_F(ViewDeserialization, BrowseRequest)
   BrowseRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::BROWSE_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
-  ASSERT_EQ(request.Query.View.Id.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(request.Query.View.Id.TwoByteData.Identifier, 1);
+  ASSERT_EQ(request.Query.View.Id.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(request.Query.View.Id.GetIntegerIdentifier(), 1);
   ASSERT_EQ(request.Query.View.Timestamp, 2);
   ASSERT_EQ(request.Query.View.Version, 3);
 
@@ -325,13 +319,11 @@ TEST_F(ViewSerialization, ReferenceDescription)
 
   ReferenceDescription desc;
 
-  desc.ReferenceTypeId.Encoding = EV_TWO_BYTE;
-  desc.ReferenceTypeId.TwoByteData.Identifier = 1;
+  desc.ReferenceTypeId = TwoByteNodeId(1);
 
   desc.IsForward = true;
 
-  desc.TargetNodeId.Encoding = EV_TWO_BYTE;
-  desc.TargetNodeId.TwoByteData.Identifier = 2;
+  desc.TargetNodeId = TwoByteNodeId(2);
 
   desc.BrowseName.NamespaceIndex = 3;
   desc.BrowseName.Name = "name";
@@ -342,8 +334,7 @@ TEST_F(ViewSerialization, ReferenceDescription)
 
   desc.TargetNodeClass = NodeClass::Method;
 
-  desc.TargetNodeTypeDefinition.Encoding = EV_TWO_BYTE;
-  desc.TargetNodeTypeDefinition.TwoByteData.Identifier = 5;
+  desc.TargetNodeTypeDefinition = TwoByteNodeId(5);
 
 
   GetStream() << desc << flush;
@@ -388,13 +379,13 @@ TEST_F(ViewDeserialization, ReferenceDescription)
 
   GetStream() >> desc;
 
-  ASSERT_EQ(desc.ReferenceTypeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.ReferenceTypeId.TwoByteData.Identifier, 1);
+  ASSERT_EQ(desc.ReferenceTypeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.ReferenceTypeId.GetIntegerIdentifier(), 1);
 
   ASSERT_EQ(desc.IsForward, true);
 
-  ASSERT_EQ(desc.TargetNodeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.TargetNodeId.TwoByteData.Identifier, 2);
+  ASSERT_EQ(desc.TargetNodeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.TargetNodeId.GetIntegerIdentifier(), 2);
 
   ASSERT_EQ(desc.BrowseName.NamespaceIndex, 3);
   ASSERT_EQ(desc.BrowseName.Name, "name");
@@ -405,8 +396,8 @@ TEST_F(ViewDeserialization, ReferenceDescription)
 
   ASSERT_EQ(desc.TargetNodeClass, NodeClass::Method);
 
-  ASSERT_EQ(desc.TargetNodeTypeDefinition.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.TargetNodeTypeDefinition.TwoByteData.Identifier, 5);
+  ASSERT_EQ(desc.TargetNodeTypeDefinition.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.TargetNodeTypeDefinition.GetIntegerIdentifier(), 5);
 }
 
 //-------------------------------------------------------
@@ -419,13 +410,11 @@ OpcUa::ReferenceDescription CreateReferenceDescription()
   using namespace OpcUa::Binary;
   ReferenceDescription desc;
 
-  desc.ReferenceTypeId.Encoding = EV_TWO_BYTE;
-  desc.ReferenceTypeId.TwoByteData.Identifier = 1;
+  desc.ReferenceTypeId = TwoByteNodeId(1);
 
   desc.IsForward = true;
 
-  desc.TargetNodeId.Encoding = EV_TWO_BYTE;
-  desc.TargetNodeId.TwoByteData.Identifier = 2;
+  desc.TargetNodeId = TwoByteNodeId(2);
 
   desc.BrowseName.NamespaceIndex = 3;
   desc.BrowseName.Name = "name";
@@ -436,8 +425,7 @@ OpcUa::ReferenceDescription CreateReferenceDescription()
 
   desc.TargetNodeClass = NodeClass::Method;
 
-  desc.TargetNodeTypeDefinition.Encoding = EV_TWO_BYTE;
-  desc.TargetNodeTypeDefinition.TwoByteData.Identifier = 5;
+  desc.TargetNodeTypeDefinition = TwoByteNodeId(5);
   return desc;
 }
 
@@ -506,19 +494,19 @@ TEST_F(ViewDeserialization, BrowseResult)
   ASSERT_FALSE(result.Referencies.empty());
 
   const ReferenceDescription& desc = result.Referencies[0];
-  ASSERT_EQ(desc.ReferenceTypeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.ReferenceTypeId.TwoByteData.Identifier, 1);
+  ASSERT_EQ(desc.ReferenceTypeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.ReferenceTypeId.GetIntegerIdentifier(), 1);
   ASSERT_EQ(desc.IsForward, true);
-  ASSERT_EQ(desc.TargetNodeId.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.TargetNodeId.TwoByteData.Identifier, 2);
+  ASSERT_EQ(desc.TargetNodeId.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.TargetNodeId.GetIntegerIdentifier(), 2);
   ASSERT_EQ(desc.BrowseName.NamespaceIndex, 3);
   ASSERT_EQ(desc.BrowseName.Name, "name");
   ASSERT_EQ(desc.DisplayName.Encoding, HAS_LOCALE | HAS_TEXT);
   ASSERT_EQ(desc.DisplayName.Locale, "loc");
   ASSERT_EQ(desc.DisplayName.Text, "text");
   ASSERT_EQ(desc.TargetNodeClass, NodeClass::Method);
-  ASSERT_EQ(desc.TargetNodeTypeDefinition.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(desc.TargetNodeTypeDefinition.TwoByteData.Identifier, 5);
+  ASSERT_EQ(desc.TargetNodeTypeDefinition.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(desc.TargetNodeTypeDefinition.GetIntegerIdentifier(), 5);
 }
 
 //-------------------------------------------------------
@@ -541,9 +529,9 @@ TEST_F(ViewSerialization, BrowseResponse)
 
   BrowseResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::BROWSE_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -629,9 +617,9 @@ TEST_F(ViewDeserialization, BrowseResponse)
   BrowseResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::BROWSE_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -651,9 +639,9 @@ TEST_F(ViewSerialization, BrowseNextRequest)
 
   BrowseNextRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::BROWSE_NEXT_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_NEXT_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -694,9 +682,9 @@ TEST_F(ViewDeserialization, BrowseNextRequest)
   BrowseNextRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::BROWSE_NEXT_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_NEXT_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -716,9 +704,9 @@ TEST_F(ViewSerialization, BrowseNextResponse)
 
   BrowseNextResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::BROWSE_NEXT_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_NEXT_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -802,9 +790,9 @@ TEST_F(ViewDeserialization, BrowseNextResponse)
   BrowseNextResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::BROWSE_NEXT_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::BROWSE_NEXT_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -823,8 +811,7 @@ TEST_F(ViewSerialization, BrowsePathTarget)
 
   BrowsePathTarget target;
 
-  target.Node.Encoding = EV_TWO_BYTE;
-  target.Node.TwoByteData.Identifier = 1;
+  target.Node = TwoByteNodeId(1);
   target.RemainingPathIndex = 2;
 
   GetStream() << target << flush;
@@ -855,8 +842,8 @@ TEST_F(ViewDeserialization, BrowsePathTarget)
 
   GetStream() >> target;
 
-  ASSERT_EQ(target.Node.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(target.Node.TwoByteData.Identifier, 1);
+  ASSERT_EQ(target.Node.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(target.Node.GetIntegerIdentifier(), 1);
   ASSERT_EQ(target.RemainingPathIndex, 2);
 }
 
@@ -871,8 +858,7 @@ TEST_F(ViewSerialization, BrowsePathResult)
 
 
   BrowsePathTarget target;
-  target.Node.Encoding = EV_TWO_BYTE;
-  target.Node.TwoByteData.Identifier = 1;
+  target.Node = TwoByteNodeId(1);
   target.RemainingPathIndex = 2;
 
   BrowsePathResult result;
@@ -913,8 +899,8 @@ TEST_F(ViewDeserialization, BrowsePathResult)
 
   ASSERT_EQ(result.Status, static_cast<StatusCode>(3));
   ASSERT_EQ(result.Targets.size(), 1);
-  ASSERT_EQ(result.Targets[0].Node.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(result.Targets[0].Node.TwoByteData.Identifier, 1);
+  ASSERT_EQ(result.Targets[0].Node.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(result.Targets[0].Node.GetIntegerIdentifier(), 1);
   ASSERT_EQ(result.Targets[0].RemainingPathIndex, 2);
 }
 
@@ -929,8 +915,7 @@ TEST_F(ViewSerialization, TranslateBrowsePathsResult)
 
 
   BrowsePathTarget target;
-  target.Node.Encoding = EV_TWO_BYTE;
-  target.Node.TwoByteData.Identifier = 1;
+  target.Node = TwoByteNodeId(1);
   target.RemainingPathIndex = 2;
 
   BrowsePathResult result;
@@ -991,8 +976,7 @@ TEST_F(ViewSerialization, TranslateBrowsePathsToNodeIdsResponse)
   using namespace OpcUa::Binary;
 
   BrowsePathTarget target;
-  target.Node.Encoding = EV_TWO_BYTE;
-  target.Node.TwoByteData.Identifier = 1;
+  target.Node = TwoByteNodeId(1);
   target.RemainingPathIndex = 2;
 
   BrowsePathResult result;
@@ -1002,9 +986,9 @@ TEST_F(ViewSerialization, TranslateBrowsePathsToNodeIdsResponse)
   TranslateBrowsePathsToNodeIdsResponse response;
   response.Result.Paths.push_back(result);
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -1068,9 +1052,9 @@ TEST_F(ViewDeserialization, TranslateBrowsePathsToNodeIdsResponse)
   TranslateBrowsePathsToNodeIdsResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -1101,9 +1085,9 @@ TEST_F(ViewSerialization, TranslateBrowsePathsToNodeIdsRequest)
   TranslateBrowsePathsToNodeIdsRequest request;
   request.Parameters.BrowsePaths.push_back(browse);
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -1153,9 +1137,9 @@ TEST_F(ViewDeserialization, TranslateBrowsePathsToNodeIdsRequest)
   TranslateBrowsePathsToNodeIdsRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::TRANSLATE_BROWSE_PATHS_TO_NODE_IdS_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
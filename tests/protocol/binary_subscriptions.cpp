@@ -98,9 +98,9 @@ TEST_F(SubscriptionSerialization, CreateSubscriptionRequest)
 
   CreateSubscriptionRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CREATE_SUBSCRIPTION_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SUBSCRIPTION_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -155,9 +155,9 @@ TEST_F(SubscriptionDeserialization, CreateSubscriptionRequest)
   CreateSubscriptionRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::CREATE_SUBSCRIPTION_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SUBSCRIPTION_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -231,9 +231,9 @@ TEST_F(SubscriptionSerialization, CreateSubscriptionResponse)
 
   CreateSubscriptionResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CREATE_SUBSCRIPTION_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SUBSCRIPTION_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -282,9 +282,9 @@ TEST_F(SubscriptionDeserialization, CreateSubscriptionResponse)
   CreateSubscriptionResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::CREATE_SUBSCRIPTION_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::CREATE_SUBSCRIPTION_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -396,9 +396,9 @@ TEST_F(SubscriptionSerialization, PublishRequest)
 
   PublishRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::PUBLISH_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::PUBLISH_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -448,9 +448,9 @@ TEST_F(SubscriptionDeserialization, PublishRequest)
   PublishRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::PUBLISH_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::PUBLISH_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -623,9 +623,9 @@ TEST_F(SubscriptionSerialization, PublishResponse)
 
   PublishResponse response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::PUBLISH_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::PUBLISH_RESPONSE);
 
   FILL_TEST_RESPONSE_HEADER(response.Header);
 
@@ -689,9 +689,9 @@ TEST_F(SubscriptionSerialization, PublishResponse)
 //
 //   PublishResponse response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::PUBLISH_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::PUBLISH_RESPONSE);
 //
 //   FILL_TEST_RESPONSE_HEADER(response.Header);
 //
@@ -768,9 +768,9 @@ TEST_F(SubscriptionDeserialization, PublishResponse)
   PublishResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::PUBLISH_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::PUBLISH_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
@@ -853,9 +853,9 @@ TEST_F(SubscriptionSerialization, SetPublishingModeRequest)
 
   SetPublishingModeRequest request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::SET_PUBLISHING_MODE_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::SET_PUBLISHING_MODE_REQUEST);
 
   FILL_TEST_REQUEST_HEADER(request.Header);
 
@@ -902,9 +902,9 @@ TEST_F(SubscriptionDeserialization, SetPublishingModeRequest)
   SetPublishingModeRequest request;
   GetStream() >> request;
 
-  ASSERT_EQ(request.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(request.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(request.TypeId.FourByteData.Identifier, OpcUa::SET_PUBLISHING_MODE_REQUEST);
+  ASSERT_EQ(request.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(request.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(request.TypeId.GetIntegerIdentifier(), OpcUa::SET_PUBLISHING_MODE_REQUEST);
 
   ASSERT_REQUEST_HEADER_EQ(request.Header);
 
@@ -988,9 +988,9 @@ TEST_F(SubscriptionDeserialization, PublishingModeResult)
 //
 //   SetPublishingModeResponse response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::SET_PUBLISHING_MODE_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::SET_PUBLISHING_MODE_RESPONSE);
 //
 //   FILL_TEST_RESPONSE_HEADER(response.Header);
 //
@@ -1020,9 +1020,9 @@ TEST_F(SubscriptionDeserialization, PublishingModeResult)
 //
 //   SetPublishingModeResponse response;
 //
-//   ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-//   ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-//   ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::SET_PUBLISHING_MODE_RESPONSE);
+//   ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+//   ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+//   ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::SET_PUBLISHING_MODE_RESPONSE);
 //
 //   FILL_TEST_RESPONSE_HEADER(response.Header);
 //
@@ -1063,9 +1063,9 @@ TEST_F(SubscriptionDeserialization, SetPublishingModeResponse)
   SetPublishingModeResponse response;
   GetStream() >> response;
 
-  ASSERT_EQ(response.TypeId.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(response.TypeId.FourByteData.NamespaceIndex, 0);
-  ASSERT_EQ(response.TypeId.FourByteData.Identifier, OpcUa::SET_PUBLISHING_MODE_RESPONSE);
+  ASSERT_EQ(response.TypeId.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(response.TypeId.GetNamespaceIndex(), 0);
+  ASSERT_EQ(response.TypeId.GetIntegerIdentifier(), OpcUa::SET_PUBLISHING_MODE_RESPONSE);
 
   ASSERT_RESPONSE_HEADER_EQ(response.Header);
 
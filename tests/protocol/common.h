@@ -222,8 +222,7 @@ protected:
   header.InnerDiagnostics.InnerDiagnostics->EncodingMask = DIM_ADDITIONAL_INFO; \
   header.InnerDiagnostics.InnerDiagnostics->AdditionalInfo = "add"; \
   header.StringTable = std::vector<std::string>(2, std::string("str")); \
-  header.Additional.TypeId.Encoding = EV_TWO_BYTE; \
-  header.Additional.TypeId.TwoByteData.Identifier = 7; \
+  header.Additional.TypeId = TwoByteNodeId(7); \
   header.Additional.Encoding = 8;
 
 #define ASSERT_RESPONSE_HEADER_EQ(header) \
@@ -236,8 +235,8 @@ protected:
   ASSERT_EQ(header.InnerDiagnostics.InnerDiagnostics->EncodingMask, DIM_ADDITIONAL_INFO); \
   ASSERT_EQ(header.InnerDiagnostics.InnerDiagnostics->AdditionalInfo, "add"); \
   ASSERT_EQ(header.StringTable, std::vector<std::string>(2, std::string("str"))); \
-  ASSERT_EQ(header.Additional.TypeId.Encoding, EV_TWO_BYTE); \
-  ASSERT_EQ(header.Additional.TypeId.TwoByteData.Identifier, 7); \
+  ASSERT_EQ(header.Additional.TypeId.GetEncoding(), EV_TWO_BYTE); \
+  ASSERT_EQ(header.Additional.TypeId.GetIntegerIdentifier(), 7); \
   ASSERT_EQ(header.Additional.Encoding, 8);
 
 
@@ -254,27 +253,25 @@ protected:
   8
 
 #define FILL_TEST_REQUEST_HEADER(header) \
-  header.SessionAuthenticationToken.Encoding = EV_TWO_BYTE; \
-  header.SessionAuthenticationToken.TwoByteData.Identifier = 1; \
+  header.SessionAuthenticationToken = TwoByteNodeId(1); \
   header.UtcTime.Value = 2; \
   header.RequestHandle = 3; \
   header.ReturnDiagnostics = 4; \
   header.AuditEntryId = "audit"; \
   header.Timeout = 5; \
-  header.Additional.TypeId.Encoding = EV_TWO_BYTE; \
-  header.Additional.TypeId.TwoByteData.Identifier = 6; \
+  header.Additional.TypeId = TwoByteNodeId(6); \
   header.Additional.Encoding = 8;
 
 #define ASSERT_REQUEST_HEADER_EQ(header) \
-  ASSERT_EQ(header.SessionAuthenticationToken.Encoding, EV_TWO_BYTE); \
-  ASSERT_EQ(header.SessionAuthenticationToken.TwoByteData.Identifier, 1); \
+  ASSERT_EQ(header.SessionAuthenticationToken.GetEncoding(), EV_TWO_BYTE); \
+  ASSERT_EQ(header.SessionAuthenticationToken.GetIntegerIdentifier(), 1); \
   ASSERT_EQ(header.UtcTime.Value, 2); \
   ASSERT_EQ(header.RequestHandle, 3); \
   ASSERT_EQ(header.ReturnDiagnostics, 4); \
   ASSERT_EQ(header.AuditEntryId, "audit"); \
   ASSERT_EQ(header.Timeout, 5); \
-  ASSERT_EQ(header.Additional.TypeId.Encoding, EV_TWO_BYTE); \
-  ASSERT_EQ(header.Additional.TypeId.TwoByteData.Identifier, 6); \
+  ASSERT_EQ(header.Additional.TypeId.GetEncoding(), EV_TWO_BYTE); \
+  ASSERT_EQ(header.Additional.TypeId.GetIntegerIdentifier(), 6); \
   ASSERT_EQ(header.Additional.Encoding, 8);
 
 
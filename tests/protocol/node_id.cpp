@@ -10,6 +10,8 @@
 
 #include "common.h"
 
+#include <unordered_map>
+
 using namespace testing;
 using namespace OpcUa;
 
@@ -29,24 +31,24 @@ class NodeComparing : public OpcUaBinarySerialization
 TEST(NodeId, DefaultConstructor)
 {
   NodeId id;
-  ASSERT_EQ(id.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(id.TwoByteData.Identifier, 0);
-  ASSERT_EQ(id.ServerIndex, 0);
-  ASSERT_EQ(id.NamespaceURI, std::string());
+  ASSERT_EQ(id.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(id.GetIntegerIdentifier(), 0);
+  ASSERT_EQ(id.GetServerIndex(), 0);
+  ASSERT_EQ(id.GetNamespaceURI(), std::string());
 }
 
 TEST(NodeId, NumericConstructor)
 {
   NodeId id(99, 1);
-  ASSERT_EQ(id.Encoding, EV_NUMERIC);
-  ASSERT_EQ(id.NumericData.Identifier, 99);
+  ASSERT_EQ(id.GetEncoding(), EV_NUMERIC);
+  ASSERT_EQ(id.GetIntegerIdentifier(), 99);
   ASSERT_EQ(id.GetNamespaceIndex(), 1);
 }
 
 TEST(Node, StringConstructor)
 {
   NodeId id("StrId", 10);
-  ASSERT_EQ(id.Encoding, EV_STRING);
+  ASSERT_EQ(id.GetEncoding(), EV_STRING);
   ASSERT_EQ(id.GetStringIdentifier(), "StrId");
   ASSERT_EQ(id.GetNamespaceIndex(), 10);
 }
@@ -54,19 +56,19 @@ TEST(Node, StringConstructor)
 TEST(Node, ConstructFromMessageId)
 {
   NodeId id(ACTIVATE_SESSION_REQUEST);
-  ASSERT_EQ(id.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(id.FourByteData.Identifier, ACTIVATE_SESSION_REQUEST);
-  ASSERT_EQ(id.ServerIndex, 0);
-  ASSERT_EQ(id.NamespaceURI, std::string());
+  ASSERT_EQ(id.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(id.GetIntegerIdentifier(), ACTIVATE_SESSION_REQUEST);
+  ASSERT_EQ(id.GetServerIndex(), 0);
+  ASSERT_EQ(id.GetNamespaceURI(), std::string());
 }
 
 TEST(Node, ConstructFromReferenceId)
 {
   NodeId id(ReferenceId::HasChild);
-  ASSERT_EQ(id.Encoding, EV_NUMERIC);
-  ASSERT_EQ(id.NumericData.Identifier, static_cast<uint16_t>(ReferenceId::HasChild));
-  ASSERT_EQ(id.ServerIndex, 0);
-  ASSERT_EQ(id.NamespaceURI, std::string());
+  ASSERT_EQ(id.GetEncoding(), EV_NUMERIC);
+  ASSERT_EQ(id.GetIntegerIdentifier(), static_cast<uint16_t>(ReferenceId::HasChild));
+  ASSERT_EQ(id.GetServerIndex(), 0);
+  ASSERT_EQ(id.GetNamespaceURI(), std::string());
 }
 
 TEST(Node, EqualIfSameType)
@@ -91,27 +93,17 @@ TEST(Node, NotEqualByObjectId)
 
 TEST(Node, EqualIfDifferentTypeButEqualIdentifier)
 {
-  NodeId id1;
-  id1.Encoding = EV_TWO_BYTE;
-  id1.TwoByteData.Identifier = 1;
+  NodeId id1 = TwoByteNodeId(1);
 
-  NodeId id2;
-  id2.Encoding = EV_FOUR_BYTE;
-  id2.FourByteData.Identifier = 1;
+  NodeId id2 = FourByteNodeId(1);
   ASSERT_EQ(id1, id2);
 }
 
 TEST(Node, DefferentIfDifferentNameSpace)
 {
-  NodeId id1;
-  id1.Encoding = EV_FOUR_BYTE;
-  id1.FourByteData.NamespaceIndex = 1;
-  id1.FourByteData.Identifier = 1;
+  NodeId id1 = FourByteNodeId(1, 1);
 
-  NodeId id2;
-  id2.Encoding = EV_FOUR_BYTE;
-  id2.FourByteData.NamespaceIndex = 2;
-  id2.FourByteData.Identifier = 1;
+  NodeId id2 = FourByteNodeId(1, 2);
 
   ASSERT_NE(id1, id2);
 }
@@ -134,8 +126,8 @@ TEST_F(NodeDeserialization, TwoByte)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, EV_TWO_BYTE);
-  ASSERT_EQ(id.TwoByteData.Identifier, 0x1);
+  ASSERT_EQ(id.GetEncoding(), EV_TWO_BYTE);
+  ASSERT_EQ(id.GetIntegerIdentifier(), 0x1);
 }
 
 TEST_F(NodeDeserialization, FourByte)
@@ -153,9 +145,9 @@ TEST_F(NodeDeserialization, FourByte)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, EV_FOUR_BYTE);
-  ASSERT_EQ(id.FourByteData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.FourByteData.Identifier, 0x2);
+  ASSERT_EQ(id.GetEncoding(), EV_FOUR_BYTE);
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetIntegerIdentifier(), 0x2);
 }
 
 TEST_F(NodeDeserialization, Numeric)
@@ -173,9 +165,9 @@ TEST_F(NodeDeserialization, Numeric)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, EV_NUMERIC);
-  ASSERT_EQ(id.NumericData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.NumericData.Identifier, 0x2);
+  ASSERT_EQ(id.GetEncoding(), EV_NUMERIC);
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetIntegerIdentifier(), 0x2);
 }
 
 TEST_F(NodeDeserialization, String)
@@ -194,9 +186,9 @@ TEST_F(NodeDeserialization, String)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, EV_STRING);
-  ASSERT_EQ(id.StringData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.StringData.Identifier, "id");
+  ASSERT_EQ(id.GetEncoding(), EV_STRING);
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetStringIdentifier(), "id");
 }
 
 TEST_F(NodeDeserialization, Guid)
@@ -215,10 +207,10 @@ TEST_F(NodeDeserialization, Guid)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, EV_BYTE_STRING);
-  ASSERT_EQ(id.BinaryData.NamespaceIndex, 0x1);
+  ASSERT_EQ(id.GetEncoding(), EV_BYTE_STRING);
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
   std::vector<uint8_t> expectedBytes = {1, 2, 3, 4};
-  ASSERT_EQ(id.BinaryData.Identifier, expectedBytes);
+  ASSERT_EQ(id.GetBinaryIdentifier(), expectedBytes);
 }
 
 TEST_F(NodeDeserialization, ByteString)
@@ -239,19 +231,19 @@ TEST_F(NodeDeserialization, ByteString)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, EV_GUId);
-  ASSERT_EQ(id.GuidData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.GuidData.Identifier.Data1, 0x01020304);
-  ASSERT_EQ(id.GuidData.Identifier.Data2, 0x0506);
-  ASSERT_EQ(id.GuidData.Identifier.Data3, 0x0708);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[0], 0x01);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[1], 0x02);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[2], 0x03);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[3], 0x04);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[4], 0x05);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[5], 0x06);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[6], 0x07);
-  ASSERT_EQ(id.GuidData.Identifier.Data4[7], 0x08);
+  ASSERT_EQ(id.GetEncoding(), EV_GUId);
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetGuidIdentifier().Data1, 0x01020304);
+  ASSERT_EQ(id.GetGuidIdentifier().Data2, 0x0506);
+  ASSERT_EQ(id.GetGuidIdentifier().Data3, 0x0708);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[0], 0x01);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[1], 0x02);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[2], 0x03);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[3], 0x04);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[4], 0x05);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[5], 0x06);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[6], 0x07);
+  ASSERT_EQ(id.GetGuidIdentifier().Data4[7], 0x08);
 }
 
 TEST_F(NodeDeserialization, NamespaceUri)
@@ -272,10 +264,10 @@ TEST_F(NodeDeserialization, NamespaceUri)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, uint8_t(EV_STRING | EV_NAMESPACE_URI_FLAG));
-  ASSERT_EQ(id.StringData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.StringData.Identifier, "id");
-  ASSERT_EQ(id.NamespaceURI, "uri");
+  ASSERT_EQ(id.GetEncoding(), uint8_t(EV_STRING | EV_NAMESPACE_URI_FLAG));
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetStringIdentifier(), "id");
+  ASSERT_EQ(id.GetNamespaceURI(), "uri");
 }
 
 TEST_F(NodeDeserialization, ServerIndexFlag)
@@ -295,10 +287,10 @@ TEST_F(NodeDeserialization, ServerIndexFlag)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, uint8_t(EV_STRING | EV_Server_INDEX_FLAG));
-  ASSERT_EQ(id.StringData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.StringData.Identifier, "id");
-  ASSERT_EQ(id.ServerIndex, 1);
+  ASSERT_EQ(id.GetEncoding(), uint8_t(EV_STRING | EV_Server_INDEX_FLAG));
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetStringIdentifier(), "id");
+  ASSERT_EQ(id.GetServerIndex(), 1);
 }
 
 TEST_F(NodeDeserialization, NamespaceUriAndServerIndex)
@@ -320,11 +312,11 @@ TEST_F(NodeDeserialization, NamespaceUriAndServerIndex)
   NodeId id;
   GetStream() >> id;
 
-  ASSERT_EQ(id.Encoding, uint8_t(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG));
-  ASSERT_EQ(id.StringData.NamespaceIndex, 0x1);
-  ASSERT_EQ(id.StringData.Identifier, "id");
-  ASSERT_EQ(id.NamespaceURI, "uri");
-  ASSERT_EQ(id.ServerIndex, 1);
+  ASSERT_EQ(id.GetEncoding(), uint8_t(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG));
+  ASSERT_EQ(id.GetNamespaceIndex(), 0x1);
+  ASSERT_EQ(id.GetStringIdentifier(), "id");
+  ASSERT_EQ(id.GetNamespaceURI(), "uri");
+  ASSERT_EQ(id.GetServerIndex(), 1);
 }
 
 //---------------------------------------------------------
@@ -335,9 +327,7 @@ TEST_F(NodeSerialization, ToByte)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  NodeId id;
-  id.Encoding = EV_TWO_BYTE;
-  id.TwoByteData.Identifier = 0x1;
+  NodeId id = TwoByteNodeId(0x1);
 
   const std::vector<char> expectedData = {
   EV_TWO_BYTE,
@@ -354,10 +344,7 @@ TEST_F(NodeSerialization, FourByte)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  NodeId id;
-  id.Encoding = EV_FOUR_BYTE;
-  id.FourByteData.NamespaceIndex = 0x1;
-  id.FourByteData.Identifier = 0x2;
+  NodeId id = FourByteNodeId(0x2, 0x1);
 
   const std::vector<char> expectedData = {
   EV_FOUR_BYTE,
@@ -375,10 +362,7 @@ TEST_F(NodeSerialization, Numeric)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  NodeId id;
-  id.Encoding = EV_NUMERIC;
-  id.NumericData.NamespaceIndex = 0x1;
-  id.NumericData.Identifier = 0x2;
+  NodeId id = NumericNodeId(0x2, 0x1);
 
   const std::vector<char> expectedData = {
   EV_NUMERIC,
@@ -396,10 +380,7 @@ TEST_F(NodeSerialization, String)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  NodeId id;
-  id.Encoding = EV_STRING;
-  id.StringData.NamespaceIndex = 0x1;
-  id.StringData.Identifier = "id";
+  NodeId id = StringNodeId("id", 0x1);
 
   const std::vector<char> expectedData = {
   EV_STRING,
@@ -418,10 +399,7 @@ TEST_F(NodeSerialization, ByteString)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  NodeId id;
-  id.Encoding = EV_BYTE_STRING;
-  id.BinaryData.NamespaceIndex = 0x1;
-  id.BinaryData.Identifier = {1, 2, 3, 4};
+  NodeId id = BinaryNodeId({1, 2, 3, 4}, 0x1);
 
   const std::vector<char> expectedData = {
   EV_BYTE_STRING,
@@ -440,20 +418,19 @@ TEST_F(NodeSerialization, Guid)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  NodeId id;
-  id.Encoding = EV_GUId;
-  id.GuidData.NamespaceIndex = 0x1;
-  id.GuidData.Identifier.Data1 = 0x01020304;
-  id.GuidData.Identifier.Data2 = 0x0506;
-  id.GuidData.Identifier.Data3 = 0x0708;
-  id.GuidData.Identifier.Data4[0] = 0x01;
-  id.GuidData.Identifier.Data4[1] = 0x02;
-  id.GuidData.Identifier.Data4[2] = 0x03;
-  id.GuidData.Identifier.Data4[3] = 0x04;
-  id.GuidData.Identifier.Data4[4] = 0x05;
-  id.GuidData.Identifier.Data4[5] = 0x06;
-  id.GuidData.Identifier.Data4[6] = 0x07;
-  id.GuidData.Identifier.Data4[7] = 0x08;
+  Guid guid;
+  guid.Data1 = 0x01020304;
+  guid.Data2 = 0x0506;
+  guid.Data3 = 0x0708;
+  guid.Data4[0] = 0x01;
+  guid.Data4[1] = 0x02;
+  guid.Data4[2] = 0x03;
+  guid.Data4[3] = 0x04;
+  guid.Data4[4] = 0x05;
+  guid.Data4[5] = 0x06;
+  guid.Data4[6] = 0x07;
+  guid.Data4[7] = 0x08;
+  NodeId id = GuidNodeId(guid, 0x1);
 
   const std::vector<char> expectedData = {
     EV_GUId,
@@ -474,11 +451,8 @@ TEST_F(NodeSerialization, NamespaceUri)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  ExpandedNodeId id;
-  id.Encoding = static_cast<NodeIdEncoding>(EV_STRING | EV_NAMESPACE_URI_FLAG);
-  id.StringData.NamespaceIndex = 0x1;
-  id.StringData.Identifier = "id";
-  id.NamespaceURI = "uri";
+  ExpandedNodeId id = StringNodeId("id", 0x1);
+  id.SetNamespaceURI("uri");
 
   const std::vector<char> expectedData = {
   int8_t(EV_STRING | EV_NAMESPACE_URI_FLAG),
@@ -499,11 +473,8 @@ TEST_F(NodeSerialization, ServerIndexFlag)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  ExpandedNodeId id;
-  id.Encoding = static_cast<NodeIdEncoding>(EV_STRING | EV_Server_INDEX_FLAG);
-  id.StringData.NamespaceIndex = 0x1;
-  id.StringData.Identifier = "id";
-  id.ServerIndex = 1;
+  ExpandedNodeId id = StringNodeId("id", 0x1);
+  id.SetServerIndex(1);
 
   const std::vector<char> expectedData = {
   int8_t(EV_STRING | EV_Server_INDEX_FLAG),
@@ -523,12 +494,9 @@ TEST_F(NodeSerialization, NamespaceUriAndServerIndex)
 {
   using namespace OpcUa;
   using namespace OpcUa::Binary;
-  ExpandedNodeId id;
-  id.Encoding = static_cast<NodeIdEncoding>(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG);
-  id.StringData.NamespaceIndex = 0x1;
-  id.StringData.Identifier = "id";
-  id.NamespaceURI = "uri";
-  id.ServerIndex = 1;
+  ExpandedNodeId id = StringNodeId("id", 0x1);
+  id.SetNamespaceURI("uri");
+  id.SetServerIndex(1);
 
   const std::vector<char> expectedData = {
   int8_t(EV_STRING | EV_NAMESPACE_URI_FLAG | EV_Server_INDEX_FLAG),
@@ -675,3 +643,43 @@ TEST(NodeId, SettingNamespaceUri_And_Index)
   ASSERT_TRUE(node.HasNamespaceURI());
   ASSERT_TRUE(node.HasServerIndex());
 }
+
+TEST(NodeId, IsCompact)
+{
+  ASSERT_LE(sizeof(NodeId), 2 * sizeof(void*) + 8);
+}
+
+TEST(NodeId, EqualNodesHaveEqualHash)
+{
+  ASSERT_EQ(TwoByteNodeId(1).GetHash(), FourByteNodeId(1).GetHash());
+  ASSERT_EQ(FourByteNodeId(1, 2).GetHash(), NumericNodeId(1, 2).GetHash());
+  ASSERT_EQ(StringNodeId("node", 2).GetHash(), StringNodeId("node", 2).GetHash());
+  ASSERT_NE(NumericNodeId(1, 2).GetHash(), NumericNodeId(1, 3).GetHash());
+  ASSERT_EQ(std::hash<NodeId>()(NumericNodeId(5)), NumericNodeId(5).GetHash());
+}
+
+TEST(NodeId, CopyDoesNotShareModifications)
+{
+  NodeId node = StringNodeId("node", 2);
+  NodeId copy = node;
+  copy.SetNamespaceURI("uri");
+  copy.SetServerIndex(3);
+
+  ASSERT_FALSE(node.HasNamespaceURI());
+  ASSERT_FALSE(node.HasServerIndex());
+  ASSERT_EQ(node.GetStringIdentifier(), "node");
+  ASSERT_EQ(copy.GetStringIdentifier(), "node");
+  ASSERT_EQ(copy.GetNamespaceURI(), "uri");
+  ASSERT_EQ(copy.GetServerIndex(), 3u);
+}
+
+TEST(NodeId, UsableAsUnorderedMapKey)
+{
+  std::unordered_map<NodeId, int> nodes;
+  nodes[NumericNodeId(1, 1)] = 1;
+  nodes[StringNodeId("node", 1)] = 2;
+
+  ASSERT_EQ(nodes.size(), 2u);
+  ASSERT_EQ(nodes[FourByteNodeId(1, 1)], 1);
+  ASSERT_EQ(nodes[StringNodeId("node", 1)], 2);
+}
@@ -16,8 +16,8 @@ using namespace OpcUa;
 TEST(ReferenceIdFromNodeId, CanBeConvertedFromValidNodeId)
 {
   NodeId id(ReferenceId::HasChild);
-  ASSERT_EQ(id.Encoding, EV_NUMERIC);
-  ASSERT_EQ(id.NumericData.NamespaceIndex, 0);
-  ASSERT_EQ(static_cast<ReferenceId>(id.NumericData.Identifier), ReferenceId::HasChild);
+  ASSERT_EQ(id.GetEncoding(), EV_NUMERIC);
+  ASSERT_EQ(id.GetNamespaceIndex(), 0);
+  ASSERT_EQ(static_cast<ReferenceId>(id.GetIntegerIdentifier()), ReferenceId::HasChild);
 }
 
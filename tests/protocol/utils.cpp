@@ -177,7 +177,7 @@ TEST(NodeId, GuidFromString)
 
   OpcUa::NodeId expected = OpcUa::GuidNodeId(guid,2);
   OpcUa::NodeId converted = OpcUa::ToNodeId("ns=1;g=01020304-0506-0708-090A0B0C0D0E0F10;");
-  ASSERT_EQ(expected.Encoding, converted.Encoding);
+  ASSERT_EQ(expected.GetEncoding(), converted.GetEncoding());
 
   OpcUa::Guid expectedGuid = converted.GetGuidIdentifier();
   ASSERT_EQ(guid.Data1, expectedGuid.Data1);
@@ -27,6 +27,10 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 using namespace testing;
 
 class AddressSpace : public Test
@@ -147,3 +151,261 @@ TEST_F(AddressSpace, ValueCallbackIsCalled)
   EXPECT_TRUE(result[0].Encoding & OpcUa::DATA_VALUE);
   EXPECT_EQ(result[0].Value, 10);
 }
+
+TEST_F(AddressSpace, ReportsAttributesWithValueCallback)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  EXPECT_FALSE(NameSpace->HasValueCallback(valueId, OpcUa::AttributeId::Value));
+  NameSpace->SetValueCallback(valueId, OpcUa::AttributeId::Value, [](){
+    return OpcUa::DataValue(10);
+  });
+  EXPECT_TRUE(NameSpace->HasValueCallback(valueId, OpcUa::AttributeId::Value));
+  EXPECT_FALSE(NameSpace->HasValueCallback(valueId, OpcUa::AttributeId::BrowseName));
+  EXPECT_FALSE(NameSpace->HasValueCallback(OpcUa::NumericNodeId(99999, 7), OpcUa::AttributeId::Value));
+}
+
+TEST_F(AddressSpace, ReadsManyNodes)
+{
+  const uint32_t count = 5000;
+  std::vector<OpcUa::AddNodesItem> items;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    OpcUa::AddNodesItem item;
+    item.RequestedNewNodeId = OpcUa::NumericNodeId(100000 + i, 3);
+    item.Attributes = OpcUa::VariableAttributes();
+    item.BrowseName = OpcUa::QualifiedName("value");
+    item.Class = OpcUa::NodeClass::Variable;
+    items.push_back(item);
+  }
+  std::vector<OpcUa::AddNodesResult> added = NameSpace->AddNodes(items);
+  ASSERT_EQ(added.size(), count);
+
+  OpcUa::ReadParameters readParams;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    ASSERT_EQ(added[i].Status, OpcUa::StatusCode::Good);
+    readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::NumericNodeId(100000 + i, 3), OpcUa::AttributeId::NodeId));
+  }
+  std::vector<OpcUa::DataValue> results = NameSpace->Read(readParams);
+  ASSERT_EQ(results.size(), count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    ASSERT_EQ(results[i].Value, OpcUa::NumericNodeId(100000 + i, 3));
+  }
+}
+
+TEST_F(AddressSpace, ReadMissingAttributeIsNotReadable)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  OpcUa::ReadParameters readParams;
+  readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(valueId, OpcUa::AttributeId::Executable));
+  readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::NumericNodeId(99999, 7), OpcUa::AttributeId::Value));
+  std::vector<OpcUa::DataValue> results = NameSpace->Read(readParams);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_EQ(results[0].Status, OpcUa::StatusCode::BadNotReadable);
+  EXPECT_EQ(results[1].Status, OpcUa::StatusCode::BadNotReadable);
+}
+
+TEST_F(AddressSpace, DataChangeCallbackCanAccessAddressSpace)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  OpcUa::Variant readValue;
+  NameSpace->AddDataChangeCallback(valueId, OpcUa::AttributeId::Value, [&](const OpcUa::NodeId& id, OpcUa::AttributeId attr, const OpcUa::DataValue& value){
+    OpcUa::ReadParameters readParams;
+    readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(id, attr));
+    readValue = NameSpace->Read(readParams)[0].Value;
+  });
+
+  OpcUa::WriteValue value;
+  value.AttributeId = OpcUa::AttributeId::Value;
+  value.NodeId = valueId;
+  value.Value = 10;
+  std::vector<OpcUa::StatusCode> result = NameSpace->Write({value});
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result[0], OpcUa::StatusCode::Good);
+  EXPECT_EQ(readValue, 10);
+}
+
+TEST_F(AddressSpace, ConcurrentWritesToDifferentNodes)
+{
+  const int threadsCount = 4;
+  const int writesCount = 1000;
+  std::vector<OpcUa::NodeId> nodes;
+  for (int i = 0; i < threadsCount; ++i)
+  {
+    nodes.push_back(CreateValue());
+  }
+
+  std::atomic<int> callbacksCount(0);
+  for (const OpcUa::NodeId& node : nodes)
+  {
+    NameSpace->AddDataChangeCallback(node, OpcUa::AttributeId::Value, [&](const OpcUa::NodeId&, OpcUa::AttributeId, const OpcUa::DataValue&){
+      ++callbacksCount;
+    });
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threadsCount; ++i)
+  {
+    threads.emplace_back([this, i, &nodes, writesCount](){
+      OpcUa::WriteValue value;
+      value.AttributeId = OpcUa::AttributeId::Value;
+      value.NodeId = nodes[i];
+      for (int n = 1; n <= writesCount; ++n)
+      {
+        value.Value = n;
+        NameSpace->Write({value});
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(callbacksCount, threadsCount * writesCount);
+  OpcUa::ReadParameters readParams;
+  for (const OpcUa::NodeId& node : nodes)
+  {
+    readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(node, OpcUa::AttributeId::Value));
+  }
+  for (const OpcUa::DataValue& result : NameSpace->Read(readParams))
+  {
+    EXPECT_EQ(result.Value, writesCount);
+  }
+}
+
+TEST_F(AddressSpace, DeliversConcurrentWritesToOneNodeInOrder)
+{
+  const int threadsCount = 4;
+  const int writesCount = 1000;
+  OpcUa::NodeId node = CreateValue();
+
+  std::mutex valuesMutex;
+  std::vector<int> values;
+  NameSpace->AddDataChangeCallback(node, OpcUa::AttributeId::Value, [&](const OpcUa::NodeId&, OpcUa::AttributeId, const OpcUa::DataValue& value){
+    std::lock_guard<std::mutex> lock(valuesMutex);
+    values.push_back(value.Value.As<int>());
+  });
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threadsCount; ++i)
+  {
+    threads.emplace_back([this, i, &node, writesCount](){
+      OpcUa::WriteValue value;
+      value.AttributeId = OpcUa::AttributeId::Value;
+      value.NodeId = node;
+      for (int n = 1; n <= writesCount; ++n)
+      {
+        value.Value = i * writesCount + n;
+        NameSpace->Write({value});
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  // Values overtaken by a newer write may be skipped, but never delivered after it.
+  std::vector<int> lastOfThread(threadsCount, 0);
+  for (int value : values)
+  {
+    const int thread = (value - 1) / writesCount;
+    EXPECT_GT(value, lastOfThread[thread]);
+    lastOfThread[thread] = value;
+  }
+  OpcUa::ReadParameters readParams;
+  readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(node, OpcUa::AttributeId::Value));
+  ASSERT_FALSE(values.empty());
+  EXPECT_EQ(NameSpace->Read(readParams)[0].Value, values.back());
+}
+
+TEST_F(AddressSpace, DataChangeCallbackCanWriteSameAttribute)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  std::vector<int> values;
+  NameSpace->AddDataChangeCallback(valueId, OpcUa::AttributeId::Value, [&](const OpcUa::NodeId& id, OpcUa::AttributeId attr, const OpcUa::DataValue& value){
+    values.push_back(value.Value.As<int>());
+    if (value.Value.As<int>() == 1)
+    {
+      OpcUa::WriteValue next;
+      next.AttributeId = attr;
+      next.NodeId = id;
+      next.Value = 2;
+      NameSpace->Write({next});
+    }
+  });
+
+  OpcUa::WriteValue value;
+  value.AttributeId = OpcUa::AttributeId::Value;
+  value.NodeId = valueId;
+  value.Value = 1;
+  NameSpace->Write({value});
+  EXPECT_EQ(values, std::vector<int>({1, 2}));
+}
+
+TEST_F(AddressSpace, ValueSlotUpdatesReadValue)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(valueId, OpcUa::AttributeId::Value);
+  ASSERT_TRUE(static_cast<bool>(slot));
+
+  slot->SetValue(OpcUa::DataValue(10));
+  EXPECT_EQ(slot->GetValue().Value, 10);
+
+  OpcUa::ReadParameters readParams;
+  readParams.AttributesToRead.push_back(OpcUa::ToReadValueId(valueId, OpcUa::AttributeId::Value));
+  std::vector<OpcUa::DataValue> result = NameSpace->Read(readParams);
+  ASSERT_EQ(result.size(), 1);
+  EXPECT_EQ(result[0].Value, 10);
+  EXPECT_TRUE(result[0].Encoding & OpcUa::DATA_VALUE_Server_TIMESTAMP);
+
+  OpcUa::WriteValue value;
+  value.AttributeId = OpcUa::AttributeId::Value;
+  value.NodeId = valueId;
+  value.Value = 20;
+  NameSpace->Write({value});
+  EXPECT_EQ(slot->GetValue().Value, 20);
+}
+
+TEST_F(AddressSpace, ValueSlotCallsDataChangeCallbacks)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(valueId, OpcUa::AttributeId::Value);
+
+  slot->SetValue(OpcUa::DataValue(5));
+
+  OpcUa::DataValue callbackValue;
+  unsigned callbackHandle = NameSpace->AddDataChangeCallback(valueId, OpcUa::AttributeId::Value, [&](const OpcUa::NodeId&, OpcUa::AttributeId, const OpcUa::DataValue& value){
+    callbackValue = value;
+  });
+  slot->SetValue(OpcUa::DataValue(10));
+  EXPECT_EQ(callbackValue.Value, 10);
+
+  NameSpace->DeleteDataChangeCallback(callbackHandle);
+  slot->SetValue(OpcUa::DataValue(20));
+  EXPECT_EQ(callbackValue.Value, 10);
+}
+
+TEST_F(AddressSpace, ValueSlotOutlivesAddressSpace)
+{
+  OpcUa::NodeId valueId = CreateValue();
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(valueId, OpcUa::AttributeId::Value);
+  unsigned callbacksCount = 0;
+  NameSpace->AddDataChangeCallback(valueId, OpcUa::AttributeId::Value, [&](const OpcUa::NodeId&, OpcUa::AttributeId, const OpcUa::DataValue&){
+    ++callbacksCount;
+  });
+  slot->SetValue(OpcUa::DataValue(10));
+  EXPECT_EQ(callbacksCount, 1);
+
+  NameSpace.reset();
+  slot->SetValue(OpcUa::DataValue(20));
+  EXPECT_EQ(slot->GetValue().Value, 20);
+  EXPECT_EQ(callbacksCount, 1);
+}
+
+TEST_F(AddressSpace, ValueSlotOfUnknownNodeThrows)
+{
+  EXPECT_THROW(NameSpace->GetValueSlot(OpcUa::NumericNodeId(99999, 7), OpcUa::AttributeId::Value), std::runtime_error);
+}
@@ -0,0 +1,95 @@
+/// @brief Tests of io_service addon.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <opc/common/addons_core/addon_manager.h>
+#include <opc/ua/server/addons/asio_addon.h>
+
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+
+#include <future>
+#include <map>
+
+using namespace testing;
+
+class AsioAddon : public Test
+{
+protected:
+  void Start(unsigned threads, bool perThread)
+  {
+    Common::AddonParameters params;
+    params.Parameters.push_back(Common::Parameter("threads", std::to_string(threads)));
+    params.Parameters.push_back(Common::Parameter("io_service_per_thread", std::to_string(perThread)));
+    Asio = std::dynamic_pointer_cast<OpcUa::Server::AsioAddon>(Common::Addon::SharedPtr(OpcUa::Server::AsioAddonFactory().CreateAddon()));
+    Asio->Initialize(*Addons, params);
+  }
+
+  virtual void TearDown()
+  {
+    if (Asio)
+    {
+      Asio->Stop();
+    }
+  }
+
+protected:
+  std::unique_ptr<Common::AddonsManager> Addons = Common::CreateAddonsManager();
+  OpcUa::Server::AsioAddon::SharedPtr Asio;
+};
+
+TEST_F(AsioAddon, ConnectionsShareIoServiceByDefault)
+{
+  Start(3, false);
+  boost::asio::io_service* io = &Asio->GetIoService();
+  EXPECT_EQ(&Asio->GetConnectionIoService(), io);
+  EXPECT_EQ(&Asio->GetConnectionIoService(), io);
+}
+
+TEST_F(AsioAddon, ConnectionsAreDistributedBetweenIoServicesOfThreads)
+{
+  Start(3, true);
+  std::map<boost::asio::io_service*, unsigned> connections;
+  for (unsigned i = 0; i < 6; ++i)
+  {
+    ++connections[&Asio->GetConnectionIoService()];
+  }
+  ASSERT_EQ(connections.size(), 3);
+  for (const auto& service : connections)
+  {
+    EXPECT_EQ(service.second, 2);
+  }
+  EXPECT_EQ(connections.count(&Asio->GetIoService()), 1);
+}
+
+TEST_F(AsioAddon, NewConnectionGetsLeastLoadedIoService)
+{
+  Start(3, true);
+  boost::asio::io_service& first = Asio->GetConnectionIoService();
+  boost::asio::io_service& second = Asio->GetConnectionIoService();
+  boost::asio::io_service& third = Asio->GetConnectionIoService();
+  EXPECT_NE(&first, &second);
+  EXPECT_NE(&second, &third);
+  EXPECT_NE(&first, &third);
+
+  Asio->ReleaseConnectionIoService(second);
+  EXPECT_EQ(&Asio->GetConnectionIoService(), &second);
+}
+
+TEST_F(AsioAddon, EveryIoServiceIsRun)
+{
+  Start(2, true);
+  std::promise<void> first;
+  std::promise<void> second;
+  std::promise<void> timers;
+  Asio->GetConnectionIoService().post([&first]() { first.set_value(); });
+  Asio->GetConnectionIoService().post([&second]() { second.set_value(); });
+  Asio->GetIoService().post([&timers]() { timers.set_value(); });
+  EXPECT_EQ(first.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  EXPECT_EQ(second.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+  EXPECT_EQ(timers.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
@@ -0,0 +1,300 @@
+/// @brief Tests of binary client against fake servers which answer requests by hand.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <opc/ua/client/binary_client.h>
+#include <opc/ua/protocol/binary/stream.h>
+#include <opc/ua/protocol/object_ids.h>
+#include <opc/ua/protocol/protocol.h>
+#include <opc/ua/protocol/secure_channel.h>
+#include <opc/ua/protocol/status_codes.h>
+#include <opc/ua/protocol/string_utils.h>
+#include <opc/ua/socket_channel.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <sys/socket.h>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+  class BufferOutput : public OpcUa::OutputChannel
+  {
+  public:
+    virtual void Send(const char* message, std::size_t size)
+    {
+      Data.insert(Data.end(), message, message + size);
+    }
+
+    virtual void Stop()
+    {
+    }
+
+  public:
+    std::vector<char> Data;
+  };
+
+  template <typename T>
+  std::vector<char> Serialize(const T& value)
+  {
+    BufferOutput output;
+    OpcUa::Binary::OStreamBinary stream(output);
+    stream << value << OpcUa::Binary::flush;
+    return output.Data;
+  }
+
+  void AcknowledgeHello(OpcUa::Binary::IOStreamBinary& stream)
+  {
+    OpcUa::Binary::Header header;
+    OpcUa::Binary::Hello hello;
+    stream >> header >> hello;
+
+    OpcUa::Binary::Acknowledge ack;
+    ack.ReceiveBufferSize = hello.SendBufferSize;
+    ack.SendBufferSize = hello.ReceiveBufferSize;
+    OpcUa::Binary::Header ackHeader(OpcUa::Binary::MT_ACKNOWLEDGE, OpcUa::Binary::CHT_SINGLE);
+    ackHeader.AddSize(OpcUa::Binary::RawSize(ack));
+    stream << ackHeader << ack << OpcUa::Binary::flush;
+  }
+}
+
+class BinaryClientTimeout : public Test
+{
+protected:
+  virtual void SetUp()
+  {
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    ServerChannel = std::make_shared<OpcUa::SocketChannel>(sockets[1]);
+    ClientChannel = std::make_shared<OpcUa::SocketChannel>(sockets[0]);
+
+    // Server acknowledges Hello and then reads requests without answering them.
+    Server = std::thread([this]()
+    {
+      OpcUa::Binary::IOStreamBinary stream(ServerChannel);
+      AcknowledgeHello(stream);
+
+      char data[1024];
+      try
+      {
+        while (ServerChannel->Receive(data, sizeof(data)))
+        {
+        }
+      }
+      catch (const std::exception&)
+      {
+      }
+    });
+  }
+
+  virtual void TearDown()
+  {
+    ServerChannel->Stop();
+    Server.join();
+  }
+
+protected:
+  std::shared_ptr<OpcUa::SocketChannel> ServerChannel;
+  std::shared_ptr<OpcUa::SocketChannel> ClientChannel;
+  std::thread Server;
+};
+
+TEST_F(BinaryClientTimeout, AsyncRequestFailsWithBadTimeout)
+{
+  OpcUa::SecureConnectionParams params;
+  params.RequestTimeout = 100;
+  OpcUa::Services::SharedPtr client = OpcUa::CreateBinaryClient(ClientChannel, params);
+
+  OpcUa::ReadParameters read;
+  read.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+  std::future<std::vector<OpcUa::DataValue>> first = client->Attributes()->ReadAsync(read);
+  std::future<std::vector<OpcUa::DataValue>> second = client->Attributes()->ReadAsync(read);
+
+  ASSERT_EQ(first.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  ASSERT_EQ(second.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  try
+  {
+    first.get();
+    FAIL() << "Request without response should fail.";
+  }
+  catch (const std::runtime_error& error)
+  {
+    EXPECT_NE(std::string(error.what()).find(OpcUa::ToString(OpcUa::StatusCode::BadTimeout)), std::string::npos) << error.what();
+  }
+  EXPECT_THROW(second.get(), std::runtime_error);
+}
+
+TEST(BinaryClientDisconnect, SyncRequestThrowsWhenConnectionCloses)
+{
+  int sockets[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+  std::shared_ptr<OpcUa::SocketChannel> serverChannel = std::make_shared<OpcUa::SocketChannel>(sockets[1]);
+  std::shared_ptr<OpcUa::SocketChannel> clientChannel = std::make_shared<OpcUa::SocketChannel>(sockets[0]);
+
+  // Server closes the connection as soon as the request is received.
+  std::thread server([serverChannel]()
+  {
+    try
+    {
+      OpcUa::Binary::IOStreamBinary stream(serverChannel);
+      AcknowledgeHello(stream);
+
+      OpcUa::Binary::SecureHeader requestHeader;
+      OpcUa::Binary::SymmetricAlgorithmHeader algorithmHeader;
+      OpcUa::Binary::SequenceHeader sequence;
+      OpcUa::ReadRequest request;
+      stream >> requestHeader >> algorithmHeader >> sequence >> request;
+    }
+    catch (const std::exception&)
+    {
+    }
+    serverChannel->Stop();
+  });
+
+  OpcUa::SecureConnectionParams params;
+  params.RequestTimeout = 10000;
+  OpcUa::Services::SharedPtr client = OpcUa::CreateBinaryClient(clientChannel, params);
+
+  OpcUa::ReadParameters read;
+  read.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  try
+  {
+    client->Attributes()->Read(read);
+    FAIL() << "Request pending when connection closes should fail.";
+  }
+  catch (const std::runtime_error& error)
+  {
+    EXPECT_NE(std::string(error.what()).find(OpcUa::ToString(OpcUa::StatusCode::BadConnectionClosed)), std::string::npos) << error.what();
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  server.join();
+}
+
+class BinaryClientChunks : public Test
+{
+protected:
+  virtual void SetUp()
+  {
+    int sockets[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets), 0);
+    ServerChannel = std::make_shared<OpcUa::SocketChannel>(sockets[1]);
+    ClientChannel = std::make_shared<OpcUa::SocketChannel>(sockets[0]);
+  }
+
+  virtual void TearDown()
+  {
+    ServerChannel->Stop();
+    if (Server.joinable())
+    {
+      Server.join();
+    }
+  }
+
+  // Answers the first Read request with a response cut into chunks of chunkSize bytes.
+  // Every chunk type is taken from chunkTypes, the last one gets the rest of the response.
+  void StartServer(const OpcUa::ReadResponse& prototype, const std::vector<OpcUa::Binary::ChunkType>& chunkTypes, std::size_t chunkSize)
+  {
+    Server = std::thread([this, prototype, chunkTypes, chunkSize]()
+    {
+      try
+      {
+        OpcUa::Binary::IOStreamBinary stream(ServerChannel);
+        AcknowledgeHello(stream);
+
+        OpcUa::Binary::SecureHeader requestHeader;
+        OpcUa::Binary::SymmetricAlgorithmHeader algorithmHeader;
+        OpcUa::Binary::SequenceHeader sequence;
+        OpcUa::ReadRequest request;
+        stream >> requestHeader >> algorithmHeader >> sequence >> request;
+
+        OpcUa::ReadResponse response = prototype;
+        response.Header.RequestHandle = request.Header.RequestHandle;
+        const std::vector<char> prefix = Serialize(algorithmHeader);
+        const std::vector<char> sequenceData = Serialize(sequence);
+        const std::vector<char> body = Serialize(response);
+
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < chunkTypes.size(); ++i)
+        {
+          const std::size_t size = i + 1 == chunkTypes.size() ? body.size() - offset : std::min(chunkSize, body.size() - offset);
+          OpcUa::Binary::SecureHeader header(OpcUa::Binary::MT_SECURE_MESSAGE, chunkTypes[i], requestHeader.ChannelId);
+          header.AddSize(prefix.size() + sequenceData.size() + size);
+          std::vector<char> chunk = Serialize(header);
+          chunk.insert(chunk.end(), prefix.begin(), prefix.end());
+          chunk.insert(chunk.end(), sequenceData.begin(), sequenceData.end());
+          chunk.insert(chunk.end(), body.begin() + offset, body.begin() + offset + size);
+          ServerChannel->Send(chunk.data(), chunk.size());
+          // Chunks after an abort chunk start the message from the beginning.
+          offset = chunkTypes[i] == OpcUa::Binary::CHT_FINAL ? 0 : offset + size;
+        }
+
+        char data[1024];
+        while (ServerChannel->Receive(data, sizeof(data)))
+        {
+        }
+      }
+      catch (const std::exception&)
+      {
+      }
+    });
+  }
+
+  static OpcUa::ReadResponse CreateResponse(std::size_t count)
+  {
+    OpcUa::ReadResponse response;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      response.Results.push_back(OpcUa::DataValue(OpcUa::Variant("value " + std::to_string(i))));
+    }
+    return response;
+  }
+
+  std::vector<OpcUa::DataValue> Read()
+  {
+    OpcUa::Services::SharedPtr client = OpcUa::CreateBinaryClient(ClientChannel, OpcUa::SecureConnectionParams());
+    OpcUa::ReadParameters read;
+    read.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+    return client->Attributes()->Read(read);
+  }
+
+protected:
+  std::shared_ptr<OpcUa::SocketChannel> ServerChannel;
+  std::shared_ptr<OpcUa::SocketChannel> ClientChannel;
+  std::thread Server;
+};
+
+TEST_F(BinaryClientChunks, ReassemblesIntermediateChunks)
+{
+  const OpcUa::ReadResponse response = CreateResponse(100);
+  StartServer(response, {OpcUa::Binary::CHT_INTERMEDIATE, OpcUa::Binary::CHT_INTERMEDIATE, OpcUa::Binary::CHT_SINGLE}, 300);
+
+  const std::vector<OpcUa::DataValue> results = Read();
+  ASSERT_EQ(results.size(), response.Results.size());
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    EXPECT_EQ(results[i].Value, response.Results[i].Value);
+  }
+}
+
+TEST_F(BinaryClientChunks, DropsAbortedMessage)
+{
+  const OpcUa::ReadResponse response = CreateResponse(10);
+  StartServer(response, {OpcUa::Binary::CHT_INTERMEDIATE, OpcUa::Binary::CHT_FINAL, OpcUa::Binary::CHT_SINGLE}, 50);
+
+  const std::vector<OpcUa::DataValue> results = Read();
+  ASSERT_EQ(results.size(), response.Results.size());
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    EXPECT_EQ(results[i].Value, response.Results[i].Value);
+  }
+}
@@ -0,0 +1,46 @@
+/// @brief Tests of buffer pool.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <src/server/buffer_pool.h>
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+TEST(BufferPool, BuffersHaveSizeOfTheirClass)
+{
+  OpcUa::Internal::BufferPool pool(8192, 65536, 4);
+  EXPECT_EQ(pool.Acquire(1).size(), 8192);
+  EXPECT_EQ(pool.Acquire(8192).size(), 8192);
+  EXPECT_EQ(pool.Acquire(8193).size(), 16384);
+  EXPECT_EQ(pool.Acquire(65536).size(), 65536);
+  // larger than all classes
+  EXPECT_EQ(pool.Acquire(100000).size(), 100000);
+}
+
+TEST(BufferPool, ReleasedBufferIsReused)
+{
+  OpcUa::Internal::BufferPool pool(8192, 65536, 4);
+  std::vector<char> buffer = pool.Acquire(10000);
+  const char* data = buffer.data();
+  pool.Release(std::move(buffer));
+  EXPECT_NE(pool.Acquire(8192).data(), data);
+  EXPECT_EQ(pool.Acquire(10000).data(), data);
+}
+
+TEST(BufferPool, KeepsLimitedNumberOfFreeBuffers)
+{
+  OpcUa::Internal::BufferPool pool(8192, 65536, 1);
+  std::vector<char> first = pool.Acquire(8192);
+  std::vector<char> second = pool.Acquire(8192);
+  const char* data = first.data();
+  pool.Release(std::move(first));
+  pool.Release(std::move(second));
+  EXPECT_EQ(pool.Acquire(8192).data(), data);
+  EXPECT_EQ(pool.Acquire(8192).size(), 8192);
+}
@@ -0,0 +1,188 @@
+/// @brief Tests of event content filter evaluation.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <src/server/content_filter.h>
+
+#include <opc/ua/protocol/object_ids.h>
+#include <opc/ua/protocol/status_codes.h>
+#include <opc/ua/server/standard_address_space.h>
+
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+class ContentFilter : public Test
+{
+protected:
+  virtual void SetUp()
+  {
+    const bool debug = false;
+    NameSpace = OpcUa::Server::CreateAddressSpace(debug);
+    OpcUa::Server::FillStandardNamespace(*NameSpace, debug);
+  }
+
+  static OpcUa::FilterOperand Element(uint32_t index)
+  {
+    OpcUa::FilterOperand operand;
+    operand.Header.TypeId = OpcUa::ExpandedObjectId::ElementOperand;
+    operand.Element.Index = index;
+    return operand;
+  }
+
+  static OpcUa::FilterOperand Literal(const OpcUa::Variant& value)
+  {
+    OpcUa::FilterOperand operand;
+    operand.Header.TypeId = OpcUa::ExpandedObjectId::LiteralOperand;
+    operand.Literal.Value = value;
+    return operand;
+  }
+
+  static OpcUa::FilterOperand Field(const std::string& name)
+  {
+    OpcUa::FilterOperand operand;
+    operand.Header.TypeId = OpcUa::ExpandedObjectId::SimpleAttributeOperand;
+    operand.SimpleAttribute.TypeId = OpcUa::ObjectId::BaseEventType;
+    operand.SimpleAttribute.BrowsePath.push_back(OpcUa::QualifiedName(name, 0));
+    operand.SimpleAttribute.Attribute = OpcUa::AttributeId::Value;
+    return operand;
+  }
+
+  static OpcUa::ContentFilterElement Make(OpcUa::FilterOperator op, const std::vector<OpcUa::FilterOperand>& operands)
+  {
+    OpcUa::ContentFilterElement element;
+    element.Operator = op;
+    element.FilterOperands = operands;
+    return element;
+  }
+
+  static OpcUa::Event CreateEvent(uint16_t severity, const std::string& sourceName)
+  {
+    OpcUa::Event event;
+    event.Severity = severity;
+    event.SourceName = sourceName;
+    event.SetValue("Area", OpcUa::Variant(std::string("Boiler")));
+    return event;
+  }
+
+protected:
+  OpcUa::Server::AddressSpace::SharedPtr NameSpace;
+  OpcUa::Internal::ContentFilterEvaluator Filter;
+};
+
+TEST_F(ContentFilter, EmptyFilterMatchesEverything)
+{
+  ASSERT_EQ(Filter.Compile({}, *NameSpace), OpcUa::StatusCode::Good);
+  EXPECT_TRUE(Filter.Match(CreateEvent(1, "pump")));
+}
+
+TEST_F(ContentFilter, ComparesStandardFieldsWithLiterals)
+{
+  ASSERT_EQ(Filter.Compile({Make(OpcUa::FilterOperator::GreaterThanOrEqual, {Field("Severity"), Literal(int32_t(500))})}, *NameSpace), OpcUa::StatusCode::Good);
+  EXPECT_TRUE(Filter.Match(CreateEvent(500, "pump")));
+  EXPECT_TRUE(Filter.Match(CreateEvent(900, "pump")));
+  EXPECT_FALSE(Filter.Match(CreateEvent(499, "pump")));
+}
+
+TEST_F(ContentFilter, CombinesElementsWithAndOr)
+{
+  // Severity > 100 and (SourceName == "pump" or Area == "Tank")
+  std::vector<OpcUa::ContentFilterElement> elements;
+  elements.push_back(Make(OpcUa::FilterOperator::And, {Element(1), Element(2)}));
+  elements.push_back(Make(OpcUa::FilterOperator::GreaterThan, {Field("Severity"), Literal(uint16_t(100))}));
+  elements.push_back(Make(OpcUa::FilterOperator::Or, {Element(3), Element(4)}));
+  elements.push_back(Make(OpcUa::FilterOperator::Equals, {Field("SourceName"), Literal(std::string("pump"))}));
+  elements.push_back(Make(OpcUa::FilterOperator::Equals, {Field("Area"), Literal(std::string("Tank"))}));
+  ASSERT_EQ(Filter.Compile(elements, *NameSpace), OpcUa::StatusCode::Good);
+
+  EXPECT_TRUE(Filter.Match(CreateEvent(200, "pump")));
+  EXPECT_FALSE(Filter.Match(CreateEvent(50, "pump")));
+  EXPECT_FALSE(Filter.Match(CreateEvent(200, "valve")));
+}
+
+TEST_F(ContentFilter, InListAndBetween)
+{
+  std::vector<OpcUa::ContentFilterElement> elements;
+  elements.push_back(Make(OpcUa::FilterOperator::And, {Element(1), Element(2)}));
+  elements.push_back(Make(OpcUa::FilterOperator::InList, {Field("SourceName"), Literal(std::string("pump")), Literal(std::string("valve"))}));
+  elements.push_back(Make(OpcUa::FilterOperator::Between, {Field("Severity"), Literal(100.0), Literal(200.0)}));
+  ASSERT_EQ(Filter.Compile(elements, *NameSpace), OpcUa::StatusCode::Good);
+
+  EXPECT_TRUE(Filter.Match(CreateEvent(100, "valve")));
+  EXPECT_FALSE(Filter.Match(CreateEvent(201, "valve")));
+  EXPECT_FALSE(Filter.Match(CreateEvent(150, "motor")));
+}
+
+TEST_F(ContentFilter, OfTypeMatchesSubtypes)
+{
+  ASSERT_EQ(Filter.Compile({Make(OpcUa::FilterOperator::OfType, {Literal(OpcUa::NodeId(OpcUa::ObjectId::SystemEventType))})}, *NameSpace), OpcUa::StatusCode::Good);
+
+  EXPECT_TRUE(Filter.Match(OpcUa::Event(OpcUa::NodeId(OpcUa::ObjectId::SystemEventType))));
+  EXPECT_TRUE(Filter.Match(OpcUa::Event(OpcUa::NodeId(OpcUa::ObjectId::DeviceFailureEventType))));
+  EXPECT_FALSE(Filter.Match(OpcUa::Event(OpcUa::NodeId(OpcUa::ObjectId::BaseEventType))));
+}
+
+TEST_F(ContentFilter, RejectsInvalidElements)
+{
+  EXPECT_EQ(Filter.Compile({Make(OpcUa::FilterOperator::Equals, {Field("Severity")})}, *NameSpace), OpcUa::StatusCode::BadFilterOperandCountMismatch);
+  EXPECT_EQ(Filter.Compile({Make(OpcUa::FilterOperator::Not, {Element(0)})}, *NameSpace), OpcUa::StatusCode::BadFilterOperandInvalid);
+  EXPECT_EQ(Filter.Compile({Make(OpcUa::FilterOperator::Like, {Field("SourceName"), Literal(std::string("p%"))})}, *NameSpace), OpcUa::StatusCode::BadFilterOperatorUnsupported);
+  EXPECT_EQ(Filter.Compile({Make(OpcUa::FilterOperator::OfType, {Literal(1)})}, *NameSpace), OpcUa::StatusCode::BadFilterOperandInvalid);
+}
+
+TEST_F(ContentFilter, EvaluatesDeepChains)
+{
+  // Chain of Not elements, each refers to the next one.
+  std::vector<OpcUa::ContentFilterElement> elements;
+  for (uint32_t i = 1; i < 1000; ++i)
+  {
+    elements.push_back(Make(OpcUa::FilterOperator::Not, {Element(i)}));
+  }
+  elements.push_back(Make(OpcUa::FilterOperator::GreaterThan, {Field("Severity"), Literal(uint16_t(100))}));
+  ASSERT_EQ(Filter.Compile(elements, *NameSpace), OpcUa::StatusCode::Good);
+  EXPECT_FALSE(Filter.Match(CreateEvent(200, "pump")));
+  EXPECT_TRUE(Filter.Match(CreateEvent(50, "pump")));
+}
+
+TEST_F(ContentFilter, EvaluatesSharedElementsOnce)
+{
+  // Every element refers twice to the next one, recursive evaluation would take 2^100 steps.
+  std::vector<OpcUa::ContentFilterElement> elements;
+  for (uint32_t i = 1; i <= 100; ++i)
+  {
+    elements.push_back(Make(OpcUa::FilterOperator::And, {Element(i), Element(i)}));
+  }
+  elements.push_back(Make(OpcUa::FilterOperator::GreaterThan, {Field("Severity"), Literal(uint16_t(100))}));
+  ASSERT_EQ(Filter.Compile(elements, *NameSpace), OpcUa::StatusCode::Good);
+  EXPECT_TRUE(Filter.Match(CreateEvent(200, "pump")));
+  EXPECT_FALSE(Filter.Match(CreateEvent(50, "pump")));
+}
+
+TEST_F(ContentFilter, RejectsTooLargeFilters)
+{
+  std::vector<OpcUa::ContentFilterElement> many(1025, Make(OpcUa::FilterOperator::GreaterThan, {Field("Severity"), Literal(uint16_t(100))}));
+  EXPECT_EQ(Filter.Compile(many, *NameSpace), OpcUa::StatusCode::BadContentFilterInvalid);
+  EXPECT_TRUE(Filter.Match(CreateEvent(1, "pump")));
+}
+
+TEST_F(ContentFilter, SelectsFieldsInOrderOfClauses)
+{
+  std::vector<OpcUa::SimpleAttributeOperand> clauses;
+  clauses.push_back(Field("SourceName").SimpleAttribute);
+  clauses.push_back(Field("Area").SimpleAttribute);
+  clauses.push_back(Field("Missing").SimpleAttribute);
+  clauses.push_back(Field("Severity").SimpleAttribute);
+  OpcUa::Internal::EventSelector selector;
+  selector.Compile(clauses);
+
+  const std::vector<OpcUa::Variant> fields = selector.Select(CreateEvent(300, "pump"));
+  ASSERT_EQ(fields.size(), 4);
+  EXPECT_EQ(fields[0], std::string("pump"));
+  EXPECT_EQ(fields[1], std::string("Boiler"));
+  EXPECT_TRUE(fields[2].IsNul());
+  EXPECT_EQ(fields[3], uint16_t(300));
+}
@@ -0,0 +1,610 @@
+/// @brief Tests of asynchronous opc tcp server.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <opc/common/addons_core/addon_manager.h>
+#include <opc/ua/client/client.h>
+#include <opc/ua/client/remote_connection.h>
+#include <opc/ua/node.h>
+#include <opc/ua/protocol/binary/stream.h>
+#include <opc/ua/protocol/object_ids.h>
+#include <opc/ua/protocol/secure_channel.h>
+#include <opc/ua/protocol/status_codes.h>
+#include <opc/ua/protocol/string_utils.h>
+#include <opc/ua/protocol/protocol.h>
+#include <opc/ua/server/address_space.h>
+#include <opc/ua/server/addons/address_space.h>
+#include <opc/ua/server/addons/asio_addon.h>
+#include <opc/ua/server/addons/common_addons.h>
+#include <opc/ua/server/addons/services_registry.h>
+#include <opc/ua/server/opc_tcp_async.h>
+#include <opc/ua/server/subscription_service.h>
+#include <opc/ua/subscription.h>
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+  const std::string Endpoint = "opc.tcp://localhost:4856";
+
+  class TestClient : public OpcUa::UaClient
+  {
+  public:
+    using OpcUa::UaClient::Server;
+  };
+
+  class DataChangeHandler : public OpcUa::SubscriptionHandler
+  {
+  public:
+    virtual void DataChange(uint32_t, const OpcUa::Node&, const OpcUa::Variant& value, OpcUa::AttributeId)
+    {
+      std::lock_guard<std::mutex> lock(Mutex);
+      Values.push_back(value);
+      Changed.notify_all();
+    }
+
+    bool WaitFor(const OpcUa::Variant& value)
+    {
+      std::unique_lock<std::mutex> lock(Mutex);
+      return Changed.wait_for(lock, std::chrono::seconds(5), [this, &value]()
+      {
+        return !Values.empty() && Values.back() == value;
+      });
+    }
+
+  private:
+    std::mutex Mutex;
+    std::condition_variable Changed;
+    std::vector<OpcUa::Variant> Values;
+  };
+
+  class BufferOutput : public OpcUa::OutputChannel
+  {
+  public:
+    virtual void Send(const char* message, std::size_t size)
+    {
+      Data.insert(Data.end(), message, message + size);
+    }
+
+    virtual void Stop()
+    {
+    }
+
+  public:
+    std::vector<char> Data;
+  };
+
+  template <typename T>
+  std::vector<char> Serialize(const T& value)
+  {
+    BufferOutput output;
+    OpcUa::Binary::OStreamBinary stream(output);
+    stream << value << OpcUa::Binary::flush;
+    return output.Data;
+  }
+
+  // Security and sequence headers which start every chunk of OpenSecureChannel.
+  std::vector<char> OpenChunkPrefix(uint32_t sequenceNumber)
+  {
+    OpcUa::Binary::AsymmetricAlgorithmHeader algorithmHeader;
+    algorithmHeader.SecurityPolicyUri = "http://opcfoundation.org/UA/SecurityPolicy#None";
+    OpcUa::Binary::SequenceHeader sequence;
+    sequence.SequenceNumber = sequenceNumber;
+    sequence.RequestId = 1;
+
+    std::vector<char> prefix = Serialize(algorithmHeader);
+    const std::vector<char> sequenceData = Serialize(sequence);
+    prefix.insert(prefix.end(), sequenceData.begin(), sequenceData.end());
+    return prefix;
+  }
+
+  std::vector<char> OpenSecureChannelBody()
+  {
+    OpcUa::OpenSecureChannelRequest request;
+    request.Parameters.ClientProtocolVersion = 0;
+    request.Parameters.RequestType = OpcUa::SecurityTokenRequestType::Issue;
+    request.Parameters.SecurityMode = OpcUa::MessageSecurityMode::None;
+    request.Parameters.ClientNonce = std::vector<uint8_t>(1, 0);
+    request.Parameters.RequestLifeTime = 300000;
+    return Serialize(request);
+  }
+
+  // Read of root node name, processed inline by default.
+  OpcUa::ReadParameters ReadRootName()
+  {
+    OpcUa::ReadParameters read;
+    read.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+    return read;
+  }
+
+  // Translation of path to Objects folder, executed by service threads if there are any.
+  OpcUa::TranslateBrowsePathsParameters TranslateObjectsPath()
+  {
+    OpcUa::RelativePathElement element;
+    element.ReferenceTypeId = OpcUa::ObjectId::HierarchicalReferences;
+    element.IncludeSubtypes = true;
+    element.TargetName = OpcUa::QualifiedName(OpcUa::Names::Objects);
+    OpcUa::BrowsePath path;
+    path.StartingNode = OpcUa::ObjectId::RootFolder;
+    path.Path.Elements.push_back(element);
+    OpcUa::TranslateBrowsePathsParameters translate;
+    translate.BrowsePaths.push_back(path);
+    return translate;
+  }
+}
+
+class OpcTcpAsync : public Test
+{
+protected:
+  void StartServer(unsigned threads, bool perThread, unsigned serviceThreads, bool connectClient = true)
+  {
+    OpcUa::Server::Parameters params;
+    params.Endpoint.Server.ApplicationUri = "urn:freeopcua:test";
+    params.Endpoint.Server.ApplicationType = OpcUa::ApplicationType::Server;
+    params.Endpoint.EndpointUrl = Endpoint;
+    params.Endpoint.SecurityMode = OpcUa::MessageSecurityMode::None;
+    params.Endpoint.SecurityPolicyUri = "http://opcfoundation.org/UA/SecurityPolicy#None";
+    params.Endpoint.TransportProfileUri = "http://opcfoundation.org/UA-Profile/Transport/uatcp-uasc-uabinary";
+    OpcUa::UserTokenPolicy policy;
+    policy.TokenType = OpcUa::UserTokenType::Anonymous;
+    params.Endpoint.UserIdentityTokens.push_back(policy);
+    params.ThreadsCount = threads;
+    params.IoServicePerThread = perThread;
+    params.ServiceThreadsCount = serviceThreads;
+
+    Addons = Common::CreateAddonsManager();
+    OpcUa::Server::RegisterCommonAddons(params, *Addons);
+    Addons->Start();
+    if (connectClient)
+    {
+      Client.Connect(Endpoint);
+      ClientConnected = true;
+    }
+  }
+
+  virtual void TearDown()
+  {
+    Stream.reset();
+    Channel.reset();
+    if (SecondServer)
+    {
+      SecondServer->Shutdown();
+    }
+    if (ClientConnected)
+    {
+      Client.Disconnect();
+    }
+    if (Addons)
+    {
+      Addons->Stop();
+    }
+  }
+
+  // Opens raw connection and keeps limits the server sent in Acknowledge.
+  void SayHello(unsigned port = 4856)
+  {
+    Channel = OpcUa::Connect("localhost", port);
+    Stream.reset(new OpcUa::Binary::IOStreamBinary(Channel));
+
+    OpcUa::Binary::Hello hello;
+    hello.ProtocolVersion = 0;
+    hello.ReceiveBufferSize = 65536;
+    hello.SendBufferSize = 1024 * 1024;
+    hello.MaxMessageSize = 0;
+    hello.MaxChunkCount = 0;
+    hello.EndpointUrl = Endpoint;
+    OpcUa::Binary::Header header(OpcUa::Binary::MT_HELLO, OpcUa::Binary::CHT_SINGLE);
+    header.AddSize(OpcUa::Binary::RawSize(hello));
+    *Stream << header << hello << OpcUa::Binary::flush;
+
+    OpcUa::Binary::Header ackHeader;
+    *Stream >> ackHeader >> Ack;
+    ASSERT_EQ(ackHeader.Type, OpcUa::Binary::MT_ACKNOWLEDGE);
+  }
+
+  // Sends chunk with data following secure channel id.
+  void SendChunk(OpcUa::Binary::MessageType type, OpcUa::Binary::ChunkType chunk, const std::vector<char>& data)
+  {
+    OpcUa::Binary::SecureHeader header(type, chunk, 0);
+    header.AddSize(data.size());
+    *Stream << header << OpcUa::Binary::RawMessage(data.data(), data.size()) << OpcUa::Binary::flush;
+  }
+
+  // Sends OpenSecureChannel request split into chunks of given body size.
+  void SendOpenSecureChannel(std::size_t bodySize)
+  {
+    const std::vector<char> body = OpenSecureChannelBody();
+    uint32_t sequenceNumber = 1;
+    for (std::size_t offset = 0; offset < body.size(); offset += bodySize)
+    {
+      const std::size_t end = std::min(body.size(), offset + bodySize);
+      std::vector<char> data = OpenChunkPrefix(sequenceNumber++);
+      data.insert(data.end(), body.begin() + offset, body.begin() + end);
+      SendChunk(OpcUa::Binary::MT_SECURE_OPEN, end == body.size() ? OpcUa::Binary::CHT_SINGLE : OpcUa::Binary::CHT_INTERMEDIATE, data);
+    }
+  }
+
+  void ExpectChannelOpened()
+  {
+    OpcUa::Binary::SecureHeader header;
+    OpcUa::Binary::AsymmetricAlgorithmHeader algorithmHeader;
+    OpcUa::Binary::SequenceHeader sequence;
+    OpcUa::OpenSecureChannelResponse response;
+    *Stream >> header;
+    ASSERT_EQ(header.Type, OpcUa::Binary::MT_SECURE_OPEN);
+    *Stream >> algorithmHeader >> sequence >> response;
+    EXPECT_EQ(response.Header.ServiceResult, OpcUa::StatusCode::Good);
+    EXPECT_NE(response.ChannelSecurityToken.SecureChannelId, 0);
+    Token = response.ChannelSecurityToken;
+  }
+
+  template <typename Request>
+  void SendRequest(const Request& request, uint32_t requestId)
+  {
+    OpcUa::Binary::SymmetricAlgorithmHeader algorithmHeader;
+    algorithmHeader.TokenId = Token.TokenId;
+    OpcUa::Binary::SequenceHeader sequence;
+    sequence.SequenceNumber = requestId + 1;
+    sequence.RequestId = requestId;
+
+    std::vector<char> data = Serialize(algorithmHeader);
+    for (const std::vector<char>& part : {Serialize(sequence), Serialize(request)})
+    {
+      data.insert(data.end(), part.begin(), part.end());
+    }
+    OpcUa::Binary::SecureHeader header(OpcUa::Binary::MT_SECURE_MESSAGE, OpcUa::Binary::CHT_SINGLE, Token.SecureChannelId);
+    header.AddSize(data.size());
+    *Stream << header << OpcUa::Binary::RawMessage(data.data(), data.size()) << OpcUa::Binary::flush;
+  }
+
+  void ExpectRejected(OpcUa::StatusCode code)
+  {
+    OpcUa::Binary::Header header;
+    OpcUa::Binary::Error error;
+    *Stream >> header;
+    ASSERT_EQ(header.Type, OpcUa::Binary::MT_ERROR);
+    *Stream >> error;
+    EXPECT_EQ(error.Code, static_cast<uint32_t>(code));
+
+    char data = 0;
+    EXPECT_ANY_THROW(Channel->Receive(&data, 1));
+  }
+
+  // Sends more reads, processed inline, and path translations, executed
+  // by other threads, than the server executes at once for a connection.
+  void SendMixedRequests(unsigned count)
+  {
+    const OpcUa::ReadParameters read = ReadRootName();
+    const OpcUa::TranslateBrowsePathsParameters translate = TranslateObjectsPath();
+
+    std::vector<std::future<std::vector<OpcUa::DataValue>>> values;
+    std::vector<std::future<std::vector<OpcUa::BrowsePathResult>>> paths;
+    for (unsigned i = 0; i < count; ++i)
+    {
+      values.push_back(Client.Server->Attributes()->ReadAsync(read));
+      paths.push_back(Client.Server->Views()->TranslateBrowsePathsToNodeIdsAsync(translate));
+    }
+
+    for (std::future<std::vector<OpcUa::DataValue>>& value : values)
+    {
+      ASSERT_EQ(value.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+      std::vector<OpcUa::DataValue> result = value.get();
+      ASSERT_EQ(result.size(), 1);
+      EXPECT_EQ(result[0].Value, OpcUa::QualifiedName(OpcUa::Names::Root));
+    }
+    for (std::future<std::vector<OpcUa::BrowsePathResult>>& path : paths)
+    {
+      ASSERT_EQ(path.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+      std::vector<OpcUa::BrowsePathResult> result = path.get();
+      ASSERT_EQ(result.size(), 1);
+      ASSERT_EQ(result[0].Targets.size(), 1);
+      EXPECT_EQ(result[0].Targets[0].Node, OpcUa::NodeId(OpcUa::ObjectId::ObjectsFolder));
+    }
+  }
+
+  // Reads a value provided by a callback, which runs where Read is executed,
+  // and calls a method, which runs where Call is executed.
+  void ProbeThreads(std::set<std::thread::id>& readThreads, std::set<std::thread::id>& callThreads)
+  {
+    OpcUa::Server::ServicesRegistry::SharedPtr registry = Addons->GetAddon<OpcUa::Server::ServicesRegistry>(OpcUa::Server::ServicesRegistryAddonId);
+    OpcUa::Server::AddressSpace::SharedPtr addressSpace = Addons->GetAddon<OpcUa::Server::AddressSpace>(OpcUa::Server::AddressSpaceRegistryAddonId);
+    OpcUa::Node objects(registry->GetServer(), OpcUa::ObjectId::ObjectsFolder);
+
+    OpcUa::Node variable = objects.AddVariable(1, "ThreadProbe", OpcUa::Variant(0));
+    addressSpace->SetValueCallback(variable.GetId(), OpcUa::AttributeId::Value, [this, &readThreads]()
+    {
+      std::lock_guard<std::mutex> lock(ProbeMutex);
+      readThreads.insert(std::this_thread::get_id());
+      return OpcUa::DataValue(1);
+    });
+    OpcUa::Node method = objects.AddMethod(1, "ThreadProbe", [this, &callThreads](OpcUa::NodeId, std::vector<OpcUa::Variant>)
+    {
+      std::lock_guard<std::mutex> lock(ProbeMutex);
+      callThreads.insert(std::this_thread::get_id());
+      return std::vector<OpcUa::Variant>();
+    });
+
+    OpcUa::ReadParameters read;
+    read.AttributesToRead.push_back(OpcUa::ToReadValueId(variable.GetId(), OpcUa::AttributeId::Value));
+    OpcUa::CallMethodRequest call;
+    call.ObjectId = objects.GetId();
+    call.MethodId = method.GetId();
+    for (unsigned i = 0; i < 10; ++i)
+    {
+      const std::vector<OpcUa::DataValue> values = Client.Server->Attributes()->Read(read);
+      ASSERT_EQ(values.size(), 1);
+      EXPECT_EQ(values[0].Value, 1);
+      const std::vector<OpcUa::CallMethodResult> results = Client.Server->Method()->Call({call});
+      ASSERT_EQ(results.size(), 1);
+      EXPECT_EQ(results[0].Status, OpcUa::StatusCode::Good);
+    }
+    std::lock_guard<std::mutex> lock(ProbeMutex);
+    ASSERT_EQ(readThreads.size(), 1);
+    ASSERT_EQ(callThreads.size(), 1);
+  }
+
+protected:
+  Common::AddonsManager::UniquePtr Addons;
+  TestClient Client;
+  bool ClientConnected = false;
+  std::shared_ptr<OpcUa::RemoteConnection> Channel;
+  std::unique_ptr<OpcUa::Binary::IOStreamBinary> Stream;
+  OpcUa::Binary::Acknowledge Ack;
+  OpcUa::SecurityToken Token;
+  OpcUa::Server::AsyncOpcTcp::UniquePtr SecondServer;
+  std::mutex ProbeMutex;
+};
+
+TEST_F(OpcTcpAsync, PipelinesMixedRequestsAtSharedIoService)
+{
+  StartServer(4, false, 0);
+  SendMixedRequests(200);
+}
+
+TEST_F(OpcTcpAsync, PipelinesMixedRequestsAtServiceThreads)
+{
+  StartServer(4, false, 4);
+  SendMixedRequests(200);
+}
+
+TEST_F(OpcTcpAsync, ExecutesRequestsAtIoServiceWithoutServiceThreads)
+{
+  StartServer(1, false, 0);
+  std::set<std::thread::id> readThreads;
+  std::set<std::thread::id> callThreads;
+  ProbeThreads(readThreads, callThreads);
+  EXPECT_EQ(*readThreads.begin(), *callThreads.begin());
+}
+
+TEST_F(OpcTcpAsync, ExecutesOnlyInlineRequestsAtIoService)
+{
+  StartServer(1, false, 1);
+  std::set<std::thread::id> readThreads;
+  std::set<std::thread::id> callThreads;
+  ProbeThreads(readThreads, callThreads);
+  // Read stays at the single io_service thread, Call goes to the single service thread.
+  EXPECT_NE(*readThreads.begin(), *callThreads.begin());
+  EXPECT_NE(*readThreads.begin(), std::this_thread::get_id());
+  EXPECT_NE(*callThreads.begin(), std::this_thread::get_id());
+}
+
+TEST_F(OpcTcpAsync, AnswersInOrderWhenRequestsAreNotPipelined)
+{
+  StartServer(1, false, 0, false);
+  OpcUa::Server::ServicesRegistry::SharedPtr registry = Addons->GetAddon<OpcUa::Server::ServicesRegistry>(OpcUa::Server::ServicesRegistryAddonId);
+  OpcUa::Server::AsioAddon::SharedPtr asio = Addons->GetAddon<OpcUa::Server::AsioAddon>(OpcUa::Server::AsioAddonId);
+  OpcUa::Server::AsyncOpcTcp::Parameters params;
+  params.Port = 4857;
+  params.ServiceThreads = 4;
+  params.MaxPipelinedRequests = 1;
+  SecondServer = OpcUa::Server::CreateAsyncOpcTcp(params, registry->GetServer(), asio->GetIoService());
+  SecondServer->Listen();
+
+  SayHello(params.Port);
+  SendOpenSecureChannel(1024);
+  ExpectChannelOpened();
+
+  // Reads run inline, translations at service threads, answers still follow requests.
+  const uint32_t count = 40;
+  for (uint32_t requestId = 1; requestId <= count; ++requestId)
+  {
+    if (requestId % 2)
+    {
+      OpcUa::ReadRequest request;
+      request.Header.RequestHandle = requestId;
+      request.Parameters = ReadRootName();
+      SendRequest(request, requestId);
+    }
+    else
+    {
+      OpcUa::TranslateBrowsePathsToNodeIdsRequest request;
+      request.Header.RequestHandle = requestId;
+      request.Parameters = TranslateObjectsPath();
+      SendRequest(request, requestId);
+    }
+  }
+
+  for (uint32_t requestId = 1; requestId <= count; ++requestId)
+  {
+    OpcUa::Binary::SecureHeader header;
+    OpcUa::Binary::SymmetricAlgorithmHeader algorithmHeader;
+    OpcUa::Binary::SequenceHeader sequence;
+    *Stream >> header;
+    ASSERT_EQ(header.Type, OpcUa::Binary::MT_SECURE_MESSAGE);
+    ASSERT_EQ(header.Chunk, OpcUa::Binary::CHT_SINGLE);
+    *Stream >> algorithmHeader >> sequence;
+    EXPECT_EQ(sequence.RequestId, requestId);
+
+    std::vector<char> body(header.Size - OpcUa::Binary::RawSize(header) - OpcUa::Binary::RawSize(algorithmHeader) - OpcUa::Binary::RawSize(sequence));
+    OpcUa::Binary::RawBuffer raw(body.data(), body.size());
+    *Stream >> raw;
+  }
+}
+
+TEST_F(OpcTcpAsync, AcknowledgesFiniteLimits)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+  EXPECT_LE(Ack.ReceiveBufferSize, 65536);
+  EXPECT_GE(Ack.ReceiveBufferSize, 8192);
+  EXPECT_NE(Ack.MaxMessageSize, 0);
+  EXPECT_NE(Ack.MaxChunkCount, 0);
+}
+
+TEST_F(OpcTcpAsync, ProcessesRequestSplitIntoChunks)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+  SendOpenSecureChannel(7);
+  ExpectChannelOpened();
+}
+
+TEST_F(OpcTcpAsync, DiscardsAbortedRequest)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+
+  // First chunk of a request which the client gives up.
+  std::vector<char> data = OpenChunkPrefix(1);
+  const std::vector<char> body = OpenSecureChannelBody();
+  data.insert(data.end(), body.begin(), body.begin() + body.size() / 2);
+  SendChunk(OpcUa::Binary::MT_SECURE_OPEN, OpcUa::Binary::CHT_INTERMEDIATE, data);
+  std::vector<char> abort = OpenChunkPrefix(2);
+  const std::vector<char> error = Serialize(OpcUa::Binary::Error());
+  abort.insert(abort.end(), error.begin(), error.end());
+  SendChunk(OpcUa::Binary::MT_SECURE_OPEN, OpcUa::Binary::CHT_FINAL, abort);
+
+  SendOpenSecureChannel(body.size());
+  ExpectChannelOpened();
+}
+
+TEST_F(OpcTcpAsync, RejectsChunkLargerThanReceiveBuffer)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+
+  // Only header is sent, server has to answer without waiting for the chunk body.
+  OpcUa::Binary::SecureHeader header(OpcUa::Binary::MT_SECURE_MESSAGE, OpcUa::Binary::CHT_SINGLE, 0);
+  header.Size = Ack.ReceiveBufferSize + 1;
+  *Stream << header << OpcUa::Binary::flush;
+  ExpectRejected(OpcUa::StatusCode::BadTcpMessageTooLarge);
+}
+
+TEST_F(OpcTcpAsync, RejectsHugeChunkBeforeHello)
+{
+  StartServer(1, false, 0, false);
+  Channel = OpcUa::Connect("localhost", 4856);
+  Stream.reset(new OpcUa::Binary::IOStreamBinary(Channel));
+
+  // Size is not trusted before the chunk is received, nothing is allocated for it.
+  OpcUa::Binary::Header header(OpcUa::Binary::MT_HELLO, OpcUa::Binary::CHT_SINGLE);
+  header.Size = 0xFFFFFFF0;
+  *Stream << header << OpcUa::Binary::flush;
+  ExpectRejected(OpcUa::StatusCode::BadTcpMessageTooLarge);
+}
+
+TEST_F(OpcTcpAsync, RejectsRequestWithTooManyChunks)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+
+  std::vector<char> data = OpenChunkPrefix(1);
+  data.push_back(0);
+  for (uint32_t chunk = 0; chunk <= Ack.MaxChunkCount; ++chunk)
+  {
+    SendChunk(OpcUa::Binary::MT_SECURE_OPEN, OpcUa::Binary::CHT_INTERMEDIATE, data);
+  }
+  ExpectRejected(OpcUa::StatusCode::BadTcpMessageTooLarge);
+}
+
+TEST_F(OpcTcpAsync, RejectsRequestLargerThanMaxMessageSize)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+
+  const std::vector<char> prefix = OpenChunkPrefix(1);
+  const std::size_t dataSize = Ack.ReceiveBufferSize - OpcUa::Binary::RawSize(OpcUa::Binary::SecureHeader());
+  std::vector<char> data(prefix);
+  data.resize(dataSize);
+  // Size of the first chunk counts with its prefix, next ones add only body.
+  std::size_t messageSize = 0;
+  while (messageSize <= Ack.MaxMessageSize)
+  {
+    SendChunk(OpcUa::Binary::MT_SECURE_OPEN, OpcUa::Binary::CHT_INTERMEDIATE, data);
+    messageSize += messageSize ? dataSize - prefix.size() : dataSize + sizeof(uint32_t);
+  }
+  ExpectRejected(OpcUa::StatusCode::BadTcpMessageTooLarge);
+}
+
+TEST_F(OpcTcpAsync, RejectsPublishRequestsOverQueueLimit)
+{
+  StartServer(1, false, 0, false);
+  SayHello();
+  SendOpenSecureChannel(1024);
+  ExpectChannelOpened();
+
+  // Without subscriptions queued requests are never answered, only the one over limit is.
+  const uint32_t count = OpcUa::Server::MaxPublishRequests + 1;
+  for (uint32_t requestId = 1; requestId <= count; ++requestId)
+  {
+    OpcUa::PublishRequest request;
+    request.Header.RequestHandle = requestId;
+    SendRequest(request, requestId);
+  }
+
+  OpcUa::Binary::SecureHeader header;
+  OpcUa::Binary::SymmetricAlgorithmHeader algorithmHeader;
+  OpcUa::Binary::SequenceHeader sequence;
+  OpcUa::PublishResponse response;
+  *Stream >> header;
+  ASSERT_EQ(header.Type, OpcUa::Binary::MT_SECURE_MESSAGE);
+  *Stream >> algorithmHeader >> sequence >> response;
+  EXPECT_EQ(sequence.RequestId, count);
+  EXPECT_EQ(response.Header.RequestHandle, count);
+  EXPECT_EQ(response.Header.ServiceResult, OpcUa::StatusCode::BadTooManyPublishRequests);
+}
+
+TEST_F(OpcTcpAsync, ReadsRequestSplitIntoChunks)
+{
+  StartServer(4, false, 0);
+
+  // Request is larger than a receive buffer of the server.
+  OpcUa::ReadParameters read;
+  for (unsigned i = 0; i < 10000; ++i)
+  {
+    read.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+  }
+  const std::vector<OpcUa::DataValue> values = Client.Server->Attributes()->Read(read);
+  ASSERT_EQ(values.size(), read.AttributesToRead.size());
+  EXPECT_EQ(values.back().Value, OpcUa::QualifiedName(OpcUa::Names::Root));
+}
+
+TEST_F(OpcTcpAsync, PublishesDataChangesWithIoServicePerThread)
+{
+  StartServer(4, true, 0);
+
+  OpcUa::Node variable = Client.GetObjectsNode().AddVariable(1, "Counter", OpcUa::Variant(0));
+  DataChangeHandler handler;
+  std::unique_ptr<OpcUa::Subscription> subscription = Client.CreateSubscription(20, handler);
+  subscription->SubscribeDataChange(variable);
+  ASSERT_TRUE(handler.WaitFor(OpcUa::Variant(0)));
+
+  for (int value = 1; value <= 10; ++value)
+  {
+    variable.SetValue(OpcUa::Variant(value));
+  }
+  EXPECT_TRUE(handler.WaitFor(OpcUa::Variant(10)));
+  subscription->Delete();
+}
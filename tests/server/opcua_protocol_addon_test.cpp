@@ -180,3 +180,52 @@ TEST_F(OpcUaProtocolAddonTest, CanReadAttributes)
   attributes.reset();
   computer.reset();
 }
+
+TEST_F(OpcUaProtocolAddonTest, CanReadResponseSplitIntoChunks)
+{
+  std::shared_ptr<OpcUa::Server::BuiltinServer> computerAddon = Addons->GetAddon<OpcUa::Server::BuiltinServer>(OpcUa::Server::OpcUaProtocolAddonId);
+  std::shared_ptr<OpcUa::Services> computer = computerAddon->GetServices();
+  std::shared_ptr<OpcUa::AttributeServices> attributes = computer->Attributes();
+
+  // Response is far bigger than 64K receive buffer of the client.
+  const std::size_t count = 20000;
+  OpcUa::ReadParameters params;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    params.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+  }
+
+  std::vector<OpcUa::DataValue> values = attributes->Read(params);
+  ASSERT_EQ(values.size(), count);
+  EXPECT_EQ(values.front().Value, OpcUa::QualifiedName(OpcUa::Names::Root));
+  EXPECT_EQ(values.back().Value, OpcUa::QualifiedName(OpcUa::Names::Root));
+
+  attributes.reset();
+  computer.reset();
+}
+
+TEST_F(OpcUaProtocolAddonTest, CanSendManyReadRequestsAtOnce)
+{
+  std::shared_ptr<OpcUa::Server::BuiltinServer> computerAddon = Addons->GetAddon<OpcUa::Server::BuiltinServer>(OpcUa::Server::OpcUaProtocolAddonId);
+  std::shared_ptr<OpcUa::Services> computer = computerAddon->GetServices();
+  std::shared_ptr<OpcUa::AttributeServices> attributes = computer->Attributes();
+
+  OpcUa::ReadParameters params;
+  params.AttributesToRead.push_back(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName));
+
+  std::vector<std::future<std::vector<OpcUa::DataValue>>> results;
+  for (int i = 0; i < 200; ++i)
+  {
+    results.push_back(attributes->ReadAsync(params));
+  }
+
+  for (std::future<std::vector<OpcUa::DataValue>>& result : results)
+  {
+    std::vector<OpcUa::DataValue> values = result.get();
+    ASSERT_EQ(values.size(), 1);
+    EXPECT_EQ(values[0].Value, OpcUa::QualifiedName(OpcUa::Names::Root));
+  }
+
+  attributes.reset();
+  computer.reset();
+}
@@ -0,0 +1,96 @@
+/// @brief Tests of shared publishing timer.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <src/server/publishing_scheduler.h>
+
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+
+using namespace testing;
+
+class PublishingScheduler : public Test
+{
+protected:
+  // Run timers until the callback was called 'count' times.
+  void RunUntil(const std::vector<uint32_t>& calls, std::size_t count)
+  {
+    for (int i = 0; i < 10000 && calls.size() < count; ++i)
+    {
+      Io.run_one();
+    }
+  }
+
+protected:
+  boost::asio::io_service Io;
+};
+
+TEST_F(PublishingScheduler, SleepsRequestedNumberOfIntervals)
+{
+  OpcUa::Internal::PublishingScheduler scheduler(Io);
+  std::vector<uint32_t> calls;
+  scheduler.AddSubscription(10, [&calls](uint32_t periods)
+    {
+      calls.push_back(periods);
+      return 3;
+    });
+
+  RunUntil(calls, 3);
+  EXPECT_EQ(calls, std::vector<uint32_t>({1, 3, 3}));
+}
+
+TEST_F(PublishingScheduler, WakeShortensSleep)
+{
+  OpcUa::Internal::PublishingScheduler scheduler(Io);
+  std::vector<uint32_t> calls;
+  uint32_t handle = scheduler.AddSubscription(10, [&calls](uint32_t periods)
+    {
+      calls.push_back(periods);
+      return 1000;
+    });
+
+  RunUntil(calls, 1);
+  scheduler.Wake(handle);
+  RunUntil(calls, 2);
+  EXPECT_EQ(calls, std::vector<uint32_t>({1, 1}));
+}
+
+TEST_F(PublishingScheduler, StopsWhenCallbackReturnsZero)
+{
+  OpcUa::Internal::PublishingScheduler scheduler(Io);
+  std::vector<uint32_t> calls;
+  scheduler.AddSubscription(10, [&calls](uint32_t periods)
+    {
+      calls.push_back(periods);
+      return 0;
+    });
+
+  RunUntil(calls, 2);
+  EXPECT_EQ(calls.size(), 1);
+}
+
+TEST_F(PublishingScheduler, RemovedSubscriptionIsNotCalled)
+{
+  OpcUa::Internal::PublishingScheduler scheduler(Io);
+  std::vector<uint32_t> calls;
+  std::vector<uint32_t> removedCalls;
+  scheduler.AddSubscription(10, [&calls](uint32_t periods)
+    {
+      calls.push_back(periods);
+      return 1;
+    });
+  uint32_t removed = scheduler.AddSubscription(10, [&removedCalls](uint32_t periods)
+    {
+      removedCalls.push_back(periods);
+      return 1;
+    });
+  scheduler.RemoveSubscription(removed);
+
+  RunUntil(calls, 3);
+  EXPECT_EQ(calls.size(), 3);
+  EXPECT_TRUE(removedCalls.empty());
+}
@@ -0,0 +1,67 @@
+/// @brief Tests of sampling timers of monitored items.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <src/server/sampling_scheduler.h>
+
+#include <opc/ua/protocol/object_ids.h>
+#include <opc/ua/server/standard_address_space.h>
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace testing;
+
+class SamplingScheduler : public Test
+{
+protected:
+  virtual void SetUp()
+  {
+    const bool debug = false;
+    NameSpace = OpcUa::Server::CreateAddressSpace(debug);
+    OpcUa::Server::FillStandardNamespace(*NameSpace, debug);
+  }
+
+protected:
+  boost::asio::io_service Io;
+  OpcUa::Server::AddressSpace::SharedPtr NameSpace;
+};
+
+TEST_F(SamplingScheduler, SamplesItemsOfInterval)
+{
+  OpcUa::Internal::SamplingScheduler scheduler(NameSpace, Io);
+  std::vector<OpcUa::DataValue> values;
+  scheduler.AddItem(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName), 1, [&values](const OpcUa::DataValue& value)
+    {
+      values.push_back(value);
+    });
+
+  for (int i = 0; i < 3; ++i)
+  {
+    Io.run_one();
+  }
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_EQ(values.back().Value, OpcUa::QualifiedName(OpcUa::Names::Root));
+}
+
+TEST_F(SamplingScheduler, SkipsSamplesMissedWhileBusy)
+{
+  OpcUa::Internal::SamplingScheduler scheduler(NameSpace, Io);
+  unsigned count = 0;
+  scheduler.AddItem(OpcUa::ToReadValueId(OpcUa::ObjectId::RootFolder, OpcUa::AttributeId::BrowseName), 10, [&count](const OpcUa::DataValue&)
+    {
+      ++count;
+    });
+
+  // Ten intervals pass without the timer being run.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  Io.run_one();
+  Io.poll();
+  EXPECT_EQ(count, 1);
+}
@@ -0,0 +1,528 @@
+/// @brief Tests of server subscription service.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <opc/ua/protocol/attribute_ids.h>
+#include <opc/ua/protocol/object_ids.h>
+#include <opc/ua/protocol/status_codes.h>
+#include <opc/ua/server/address_space.h>
+#include <opc/ua/server/standard_address_space.h>
+#include <opc/ua/server/subscription_service.h>
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace testing;
+
+class SubscriptionService : public Test
+{
+protected:
+  virtual void SetUp()
+  {
+    const bool debug = false;
+    NameSpace = OpcUa::Server::CreateAddressSpace(debug);
+    OpcUa::Server::FillStandardNamespace(*NameSpace, debug);
+    Subscriptions = OpcUa::Server::CreateSubscriptionService(NameSpace, Io, debug);
+  }
+
+  virtual void TearDown()
+  {
+    Subscriptions->DeleteSubscriptions({SubscriptionId});
+    Io.poll();
+    Subscriptions.reset();
+    NameSpace.reset();
+  }
+
+  OpcUa::NodeId CreateValue(const OpcUa::Variant& value)
+  {
+    OpcUa::VariableAttributes attrs;
+    attrs.Value = value;
+    OpcUa::AddNodesItem item;
+    item.Attributes = attrs;
+    item.BrowseName = OpcUa::QualifiedName("value");
+    item.Class = OpcUa::NodeClass::Variable;
+    item.ParentNodeId = OpcUa::ObjectId::RootFolder;
+    item.ReferenceTypeId = OpcUa::ObjectId::Organizes;
+    std::vector<OpcUa::AddNodesResult> newNodesResult = NameSpace->AddNodes({item});
+    return newNodesResult[0].AddedNodeId;
+  }
+
+  void AddEURange(const OpcUa::NodeId& node, double low, double high)
+  {
+    OpcUa::VariableAttributes attrs;
+    attrs.Value = std::vector<double>{low, high};
+    OpcUa::AddNodesItem item;
+    item.Attributes = attrs;
+    item.BrowseName = OpcUa::QualifiedName("EURange", 0);
+    item.Class = OpcUa::NodeClass::Variable;
+    item.ParentNodeId = node;
+    item.ReferenceTypeId = OpcUa::ObjectId::HasProperty;
+    NameSpace->AddNodes({item});
+  }
+
+  void CreateSubscription(uint32_t maxNotificationsPerPublish = 0, double publishingInterval = 10, boost::asio::io_service* io = nullptr)
+  {
+    OpcUa::CreateSubscriptionRequest request;
+    request.Parameters.RequestedPublishingInterval = publishingInterval;
+    request.Parameters.RequestedLifetimeCount = 100;
+    request.Parameters.RequestedMaxKeepAliveCount = 10;
+    request.Parameters.MaxNotificationsPerPublish = maxNotificationsPerPublish;
+    std::function<void (OpcUa::PublishResult)> callback = [this](OpcUa::PublishResult result)
+      {
+        ++PublishCount;
+        MoreNotifications.push_back(result.MoreNotifications);
+        for (const OpcUa::NotificationData& notification : result.NotificationMessage.NotificationData)
+        {
+          for (const OpcUa::MonitoredItems& item : notification.DataChange.Notification)
+          {
+            Notifications.push_back(item.Value);
+          }
+          for (const OpcUa::EventFieldList& event : notification.Events.Events)
+          {
+            Events.push_back(event);
+          }
+        }
+      };
+    OpcUa::SubscriptionData data = io ? Subscriptions->CreateSubscription(request, callback, *io) : Subscriptions->CreateSubscription(request, callback);
+    SubscriptionId = data.SubscriptionId;
+  }
+
+  OpcUa::StatusCode Monitor(const OpcUa::NodeId& node, const OpcUa::MonitoringFilter& filter, uint32_t queueSize = 100, bool discardOldest = true, double samplingInterval = 0)
+  {
+    OpcUa::MonitoredItemCreateRequest item;
+    item.ItemToMonitor = OpcUa::ToReadValueId(node, OpcUa::AttributeId::Value);
+    item.MonitoringMode = OpcUa::MonitoringMode::Reporting;
+    item.RequestedParameters.ClientHandle = 1;
+    item.RequestedParameters.SamplingInterval = samplingInterval;
+    item.RequestedParameters.Filter = filter;
+    item.RequestedParameters.QueueSize = queueSize;
+    item.RequestedParameters.DiscardOldest = discardOldest;
+
+    OpcUa::MonitoredItemsParameters params;
+    params.SubscriptionId = SubscriptionId;
+    params.TimestampsToReturn = OpcUa::TimestampsToReturn::Both;
+    params.ItemsToCreate.push_back(item);
+    std::vector<OpcUa::MonitoredItemCreateResult> results = Subscriptions->CreateMonitoredItems(params);
+    return results.at(0).Status;
+  }
+
+  // Run timers until the subscription publishes notifications.
+  void Publish()
+  {
+    OpcUa::PublishRequest request;
+    Subscriptions->Publish(request);
+    const unsigned count = PublishCount;
+    for (int i = 0; i < 1000 && PublishCount == count; ++i)
+    {
+      Io.run_one();
+    }
+  }
+
+  static OpcUa::MonitoringFilter Deadband(OpcUa::DeadbandType type, double value)
+  {
+    OpcUa::DataChangeFilter filter;
+    filter.Trigger = OpcUa::DataChangeTrigger::StatusValue;
+    filter.Deadband = type;
+    filter.DeadbandValue = value;
+    return OpcUa::MonitoringFilter(filter);
+  }
+
+protected:
+  boost::asio::io_service Io;
+  boost::asio::io_service ConnectionIo;
+  OpcUa::Server::AddressSpace::SharedPtr NameSpace;
+  OpcUa::Server::SubscriptionService::SharedPtr Subscriptions;
+  uint32_t SubscriptionId = 0;
+  unsigned PublishCount = 0;
+  std::vector<bool> MoreNotifications;
+  std::vector<OpcUa::DataValue> Notifications;
+  std::vector<OpcUa::EventFieldList> Events;
+};
+
+TEST_F(SubscriptionService, AbsoluteDeadbandSkipsSmallChanges)
+{
+  const OpcUa::NodeId node = CreateValue(10.0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, Deadband(OpcUa::DeadbandType::Absolute, 1)), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  slot->SetValue(OpcUa::DataValue(10.5));
+  slot->SetValue(OpcUa::DataValue(10.9));
+  slot->SetValue(OpcUa::DataValue(11.5));
+  slot->SetValue(OpcUa::DataValue(11.0));
+  Publish();
+
+  ASSERT_EQ(Notifications.size(), 2);
+  EXPECT_EQ(Notifications[0].Value, 10.0);
+  EXPECT_EQ(Notifications[1].Value, 11.5);
+}
+
+TEST_F(SubscriptionService, PercentDeadbandUsesEURange)
+{
+  const OpcUa::NodeId node = CreateValue(10.0);
+  AddEURange(node, 0, 200);
+  CreateSubscription();
+  // 5 percent of the range is 10.
+  ASSERT_EQ(Monitor(node, Deadband(OpcUa::DeadbandType::Percent, 5)), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  slot->SetValue(OpcUa::DataValue(19.0));
+  slot->SetValue(OpcUa::DataValue(21.0));
+  Publish();
+
+  ASSERT_EQ(Notifications.size(), 2);
+  EXPECT_EQ(Notifications[1].Value, 21.0);
+}
+
+TEST_F(SubscriptionService, PercentDeadbandRequiresEURange)
+{
+  const OpcUa::NodeId node = CreateValue(10.0);
+  CreateSubscription();
+  EXPECT_EQ(Monitor(node, Deadband(OpcUa::DeadbandType::Percent, 5)), OpcUa::StatusCode::BadMonitoredItemFilterUnsupported);
+}
+
+TEST_F(SubscriptionService, StatusValueTriggerSkipsEqualValues)
+{
+  const OpcUa::NodeId node = CreateValue(10.0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, Deadband(OpcUa::DeadbandType::None, 0)), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  slot->SetValue(OpcUa::DataValue(10.0));
+  OpcUa::DataValue bad(10.0);
+  bad.Status = OpcUa::StatusCode::BadSensorFailure;
+  bad.Encoding |= OpcUa::DATA_VALUE_STATUS_CODE;
+  slot->SetValue(bad);
+  Publish();
+
+  ASSERT_EQ(Notifications.size(), 2);
+  EXPECT_EQ(Notifications[1].Status, OpcUa::StatusCode::BadSensorFailure);
+}
+
+TEST_F(SubscriptionService, NoFilterReportsEveryWrite)
+{
+  const OpcUa::NodeId node = CreateValue(10.0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter()), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  slot->SetValue(OpcUa::DataValue(10.0));
+  slot->SetValue(OpcUa::DataValue(10.0));
+  Publish();
+
+  EXPECT_EQ(Notifications.size(), 3);
+}
+
+TEST_F(SubscriptionService, QueueOfSizeOneKeepsLatestValue)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter(), 1), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  for (int i = 1; i <= 1000; ++i)
+  {
+    slot->SetValue(OpcUa::DataValue(i));
+  }
+  Publish();
+
+  ASSERT_EQ(Notifications.size(), 1);
+  EXPECT_EQ(Notifications[0].Value, 1000);
+  EXPECT_EQ(Notifications[0].Status, OpcUa::StatusCode::Good);
+}
+
+TEST_F(SubscriptionService, QueueDiscardsOldestAndSetsOverflow)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter(), 3, true), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  for (int i = 1; i <= 5; ++i)
+  {
+    slot->SetValue(OpcUa::DataValue(i));
+  }
+  Publish();
+
+  ASSERT_EQ(Notifications.size(), 3);
+  EXPECT_EQ(Notifications[0].Value, 3);
+  EXPECT_EQ(static_cast<uint32_t>(Notifications[0].Status), 0x480u);
+  EXPECT_EQ(Notifications[1].Value, 4);
+  EXPECT_EQ(Notifications[2].Value, 5);
+  EXPECT_EQ(Notifications[2].Status, OpcUa::StatusCode::Good);
+}
+
+TEST_F(SubscriptionService, QueueDiscardsNewestAndSetsOverflow)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter(), 3, false), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  for (int i = 1; i <= 5; ++i)
+  {
+    slot->SetValue(OpcUa::DataValue(i));
+  }
+  Publish();
+
+  ASSERT_EQ(Notifications.size(), 3);
+  EXPECT_EQ(Notifications[0].Value, 0);
+  EXPECT_EQ(Notifications[1].Value, 1);
+  EXPECT_EQ(Notifications[2].Value, 5);
+  EXPECT_EQ(static_cast<uint32_t>(Notifications[2].Status), 0x480u);
+}
+
+TEST_F(SubscriptionService, SamplesValuesOfValueCallbacks)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  int counter = 0;
+  NameSpace->SetValueCallback(node, OpcUa::AttributeId::Value, [&counter]()
+    {
+      return OpcUa::DataValue(++counter / 3);
+    });
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter(), 100, true, 1), OpcUa::StatusCode::Good);
+
+  // Run sampling timer several times before the first publish.
+  for (int i = 0; i < 10; ++i)
+  {
+    Io.run_one();
+  }
+  Publish();
+
+  ASSERT_GE(Notifications.size(), 2);
+  for (std::size_t i = 1; i < Notifications.size(); ++i)
+  {
+    EXPECT_NE(Notifications[i].Value, Notifications[i - 1].Value);
+  }
+}
+
+TEST_F(SubscriptionService, BacklogIsSplitByMaxNotificationsPerPublish)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription(2);
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter()), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  for (int i = 1; i <= 4; ++i)
+  {
+    slot->SetValue(OpcUa::DataValue(i));
+  }
+  // All queued publish requests are answered within one publishing cycle.
+  for (int i = 0; i < 3; ++i)
+  {
+    Subscriptions->Publish(OpcUa::PublishRequest());
+  }
+  for (int i = 0; i < 1000 && PublishCount < 3; ++i)
+  {
+    Io.run_one();
+  }
+
+  ASSERT_EQ(PublishCount, 3);
+  EXPECT_EQ(MoreNotifications, std::vector<bool>({true, true, false}));
+  ASSERT_EQ(Notifications.size(), 5);
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(Notifications[i].Value, i);
+  }
+}
+
+TEST_F(SubscriptionService, BacklogWaitsForNextPublishRequest)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription(2);
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter()), OpcUa::StatusCode::Good);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  slot->SetValue(OpcUa::DataValue(1));
+  slot->SetValue(OpcUa::DataValue(2));
+  Publish();
+  ASSERT_EQ(PublishCount, 1);
+  EXPECT_TRUE(MoreNotifications[0]);
+  EXPECT_EQ(Notifications.size(), 2);
+
+  Publish();
+  ASSERT_EQ(PublishCount, 2);
+  EXPECT_FALSE(MoreNotifications[1]);
+  ASSERT_EQ(Notifications.size(), 3);
+  EXPECT_EQ(Notifications[2].Value, 2);
+}
+
+TEST_F(SubscriptionService, SubscriptionRunsAtIoServiceOfItsConnection)
+{
+  CreateSubscription(0, 10, &ConnectionIo);
+  OpcUa::PublishRequest request;
+  Subscriptions->Publish(request);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Io.poll();
+  EXPECT_EQ(PublishCount, 0);
+
+  for (int i = 0; i < 1000 && PublishCount == 0; ++i)
+  {
+    ConnectionIo.run_one();
+  }
+  EXPECT_EQ(PublishCount, 1);
+}
+
+TEST_F(SubscriptionService, IdleSubscriptionSendsKeepAlive)
+{
+  CreateSubscription();
+  Publish();
+  ASSERT_EQ(PublishCount, 1);
+
+  Publish();
+  ASSERT_EQ(PublishCount, 2);
+  EXPECT_TRUE(Notifications.empty());
+}
+
+TEST_F(SubscriptionService, NotificationWakesIdleSubscription)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription();
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter()), OpcUa::StatusCode::Good);
+  Publish();
+  ASSERT_EQ(Notifications.size(), 1);
+
+  OpcUa::Server::ValueSlot::SharedPtr slot = NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value);
+  slot->SetValue(OpcUa::DataValue(1));
+  Publish();
+
+  ASSERT_EQ(PublishCount, 2);
+  ASSERT_EQ(Notifications.size(), 2);
+  EXPECT_EQ(Notifications[1].Value, 1);
+}
+
+TEST_F(SubscriptionService, LateSubscriptionIsAnsweredOnPublishRequest)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription(1, 200);
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter()), OpcUa::StatusCode::Good);
+  NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value)->SetValue(OpcUa::DataValue(1));
+  Publish();
+  ASSERT_EQ(PublishCount, 1);
+  ASSERT_TRUE(MoreNotifications[0]);
+
+  // Next publishing cycle is 200 ms away, only ready handlers are run.
+  Subscriptions->Publish(OpcUa::PublishRequest());
+  Io.poll();
+
+  ASSERT_EQ(PublishCount, 2);
+  ASSERT_EQ(Notifications.size(), 2);
+  EXPECT_EQ(Notifications[1].Value, 1);
+}
+
+TEST_F(SubscriptionService, DataChangeIsAnsweredWithParkedPublishRequest)
+{
+  const OpcUa::NodeId node = CreateValue(0);
+  CreateSubscription(0, 200);
+  ASSERT_EQ(Monitor(node, OpcUa::MonitoringFilter()), OpcUa::StatusCode::Good);
+  Publish();
+  ASSERT_EQ(PublishCount, 1);
+
+  // Keep timers running while the subscription is idle.
+  const std::chrono::steady_clock::time_point idleEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(250);
+  while (std::chrono::steady_clock::now() < idleEnd)
+  {
+    Io.poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  Subscriptions->Publish(OpcUa::PublishRequest());
+  NameSpace->GetValueSlot(node, OpcUa::AttributeId::Value)->SetValue(OpcUa::DataValue(1));
+  Io.poll();
+
+  ASSERT_EQ(PublishCount, 2);
+  ASSERT_EQ(Notifications.size(), 2);
+  EXPECT_EQ(Notifications[1].Value, 1);
+}
+
+TEST_F(SubscriptionService, EventsAreFilteredByWhereClause)
+{
+  OpcUa::SimpleAttributeOperand severity;
+  severity.TypeId = OpcUa::ObjectId::BaseEventType;
+  severity.BrowsePath.push_back(OpcUa::QualifiedName("Severity", 0));
+  severity.Attribute = OpcUa::AttributeId::Value;
+
+  OpcUa::FilterOperand field;
+  field.Header.TypeId = OpcUa::ExpandedObjectId::SimpleAttributeOperand;
+  field.SimpleAttribute = severity;
+  OpcUa::FilterOperand limit;
+  limit.Header.TypeId = OpcUa::ExpandedObjectId::LiteralOperand;
+  limit.Literal.Value = uint16_t(500);
+  OpcUa::ContentFilterElement element;
+  element.Operator = OpcUa::FilterOperator::GreaterThan;
+  element.FilterOperands = {field, limit};
+
+  OpcUa::EventFilter filter;
+  filter.SelectClauses.push_back(severity);
+  filter.WhereClause.push_back(element);
+
+  CreateSubscription();
+  OpcUa::MonitoredItemCreateRequest item;
+  item.ItemToMonitor.NodeId = OpcUa::ObjectId::Server;
+  item.ItemToMonitor.AttributeId = OpcUa::AttributeId::EventNotifier;
+  item.MonitoringMode = OpcUa::MonitoringMode::Reporting;
+  item.RequestedParameters.Filter = OpcUa::MonitoringFilter(filter);
+  OpcUa::MonitoredItemsParameters params;
+  params.SubscriptionId = SubscriptionId;
+  params.ItemsToCreate.push_back(item);
+  ASSERT_EQ(Subscriptions->CreateMonitoredItems(params).at(0).Status, OpcUa::StatusCode::Good);
+
+  OpcUa::Event event;
+  event.Severity = 100;
+  Subscriptions->TriggerEvent(OpcUa::ObjectId::Server, event);
+  event.Severity = 800;
+  Subscriptions->TriggerEvent(OpcUa::ObjectId::Server, event);
+  Publish();
+
+  ASSERT_EQ(Events.size(), 1);
+  ASSERT_EQ(Events[0].EventFields.size(), 1);
+  EXPECT_EQ(Events[0].EventFields[0], uint16_t(800));
+}
+
+TEST_F(SubscriptionService, SeveralEventItemsOnOneNode)
+{
+  OpcUa::SimpleAttributeOperand severity;
+  severity.TypeId = OpcUa::ObjectId::BaseEventType;
+  severity.BrowsePath.push_back(OpcUa::QualifiedName("Severity", 0));
+  severity.Attribute = OpcUa::AttributeId::Value;
+  OpcUa::EventFilter filter;
+  filter.SelectClauses.push_back(severity);
+
+  CreateSubscription();
+  OpcUa::MonitoredItemCreateRequest item;
+  item.ItemToMonitor.NodeId = OpcUa::ObjectId::Server;
+  item.ItemToMonitor.AttributeId = OpcUa::AttributeId::EventNotifier;
+  item.MonitoringMode = OpcUa::MonitoringMode::Reporting;
+  item.RequestedParameters.Filter = OpcUa::MonitoringFilter(filter);
+  OpcUa::MonitoredItemsParameters params;
+  params.SubscriptionId = SubscriptionId;
+  item.RequestedParameters.ClientHandle = 1;
+  params.ItemsToCreate.push_back(item);
+  item.RequestedParameters.ClientHandle = 2;
+  params.ItemsToCreate.push_back(item);
+  const std::vector<OpcUa::MonitoredItemCreateResult> results = Subscriptions->CreateMonitoredItems(params);
+  ASSERT_EQ(results.size(), 2);
+  ASSERT_EQ(results[1].Status, OpcUa::StatusCode::Good);
+
+  Subscriptions->TriggerEvent(OpcUa::ObjectId::Server, OpcUa::Event());
+  // Events of other nodes are not delivered.
+  Subscriptions->TriggerEvent(OpcUa::ObjectId::RootFolder, OpcUa::Event());
+  Publish();
+  ASSERT_EQ(Events.size(), 2);
+  EXPECT_EQ(Events[0].ClientHandle + Events[1].ClientHandle, 3);
+
+  OpcUa::DeleteMonitoredItemsParameters deleteParams;
+  deleteParams.SubscriptionId = SubscriptionId;
+  deleteParams.MonitoredItemIds.push_back(results[0].MonitoredItemId);
+  ASSERT_EQ(Subscriptions->DeleteMonitoredItems(deleteParams).at(0), OpcUa::StatusCode::Good);
+  Subscriptions->TriggerEvent(OpcUa::ObjectId::Server, OpcUa::Event());
+  Publish();
+  ASSERT_EQ(Events.size(), 3);
+  EXPECT_EQ(Events[2].ClientHandle, 2);
+}
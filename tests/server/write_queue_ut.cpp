@@ -0,0 +1,75 @@
+/// @brief Tests of queue of outgoing messages.
+/// @license GNU LGPL
+///
+/// Distributed under the GNU LGPL License
+/// (See accompanying file LICENSE or copy at
+/// http://www.gnu.org/licenses/lgpl.html)
+///
+
+#include <src/server/write_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace testing;
+
+namespace
+{
+  void Push(OpcUa::Internal::WriteQueue& queue, const std::string& message, bool startsWrite)
+  {
+    EXPECT_EQ(queue.Push(message.data(), message.size()), startsWrite) << message;
+  }
+
+  std::vector<std::string> Take(OpcUa::Internal::WriteQueue& queue)
+  {
+    std::vector<std::string> messages;
+    for (const std::vector<char>& data : queue.Take())
+    {
+      messages.push_back(std::string(data.begin(), data.end()));
+    }
+    return messages;
+  }
+}
+
+TEST(WriteQueue, FirstMessageStartsWrite)
+{
+  OpcUa::Internal::WriteQueue queue(16, 65536);
+  Push(queue, "first", true);
+  EXPECT_EQ(Take(queue), std::vector<std::string>({"first"}));
+  EXPECT_FALSE(queue.Written());
+  Push(queue, "second", true);
+}
+
+TEST(WriteQueue, MessagesQueuedDuringWriteAreGatheredInOrder)
+{
+  OpcUa::Internal::WriteQueue queue(16, 65536);
+  Push(queue, "first", true);
+  EXPECT_EQ(Take(queue), std::vector<std::string>({"first"}));
+
+  Push(queue, "second", false);
+  Push(queue, "third", false);
+  Push(queue, "fourth", false);
+  ASSERT_TRUE(queue.Written());
+  EXPECT_EQ(Take(queue), std::vector<std::string>({"second", "third", "fourth"}));
+
+  Push(queue, "fifth", false);
+  ASSERT_TRUE(queue.Written());
+  EXPECT_EQ(Take(queue), std::vector<std::string>({"fifth"}));
+  EXPECT_FALSE(queue.Written());
+}
+
+TEST(WriteQueue, ReusesBuffersOfWrittenMessages)
+{
+  OpcUa::Internal::WriteQueue queue(1, 65536);
+  Push(queue, "first", true);
+  Push(queue, "second", false);
+  const char* data = queue.Take()[0].data();
+  ASSERT_FALSE(queue.Written());
+
+  Push(queue, "third", true);
+  const std::vector<std::vector<char>>& writing = queue.Take();
+  ASSERT_EQ(writing.size(), 1);
+  EXPECT_EQ(writing[0].data(), data);
+  EXPECT_EQ(std::string(writing[0].begin(), writing[0].end()), "third");
+}